@@ -0,0 +1,191 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "batch_render.h"
+
+#include "../blocks/Cinder-Stk/src/stk/Stk.h"
+#include "../include/coviddata/dataset.h"
+#include "../include/coviddata/threadpool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace covidsonifapp {
+
+namespace {
+
+/**
+ * Render of one region of one dataset
+ */
+struct RenderJob {
+  std::shared_ptr<const coviddata::DataSet> data_set;
+  coviddata::RegionView view;
+  float max_amount;
+  std::string filename;
+};
+
+// Returns the name of a file without its directory or extension
+std::string GetStem(const std::string& filename) {
+  const size_t directory = filename.find_last_of("/\\");
+  const size_t begin = directory == std::string::npos ? 0 : directory + 1;
+  const size_t extension = filename.find('.', begin);
+  return filename.substr(begin, extension == std::string::npos
+                                    ? std::string::npos
+                                    : extension - begin);
+}
+
+// Replaces characters that are not safe in filenames, ex. in "Cote d'Ivoire"
+std::string SanitizeFilename(std::string name) {
+  for (char& character : name) {
+    if (!std::isalnum(static_cast<unsigned char>(character)) &&
+        character != '-')
+      character = '_';
+  }
+  return name;
+}
+
+// Imports every dataset and lists a job for each of their regions
+void ListJobs(const std::vector<std::string>& dataset_filenames,
+              const std::string& output_directory,
+              std::vector<RenderJob>& jobs, BatchRenderReport& report) {
+  for (const std::string& dataset_filename : dataset_filenames) {
+    std::shared_ptr<coviddata::DataSet> data_set =
+        std::make_shared<coviddata::DataSet>();
+    try {
+      data_set->ImportData(dataset_filename);
+    } catch (const std::exception& e) {
+      report.failures.push_back(dataset_filename + ": " + e.what());
+      continue;
+    }
+
+    for (size_t region_id = 0; region_id < data_set->Size(); region_id++) {
+      const coviddata::RegionData& region =
+          data_set->GetRegionDataById(region_id);
+      const coviddata::RegionView view(region);
+
+      // Each region is bounded by its own maximum, as the tool renders it
+      jobs.push_back({data_set, view,
+                      std::max(0.0f, view.GetStats().GetMax()),
+                      GetBatchRenderFilename(output_directory,
+                                             dataset_filename,
+                                             region.GetRegionName())});
+    }
+  }
+}
+
+}  // namespace
+
+/**
+ * Returns how many seconds of audio were rendered per second of wall time
+ * @return real-time factor of the whole batch, across every thread
+ */
+double BatchRenderReport::GetRealTimeFactor() const {
+  return wall_seconds > 0 ? audio_seconds / wall_seconds : 0;
+}
+
+/**
+ * Returns the file a batch render writes a region of a dataset to, named
+ * after both so every (dataset, region) pair gets its own file
+ * @param output_directory directory the batch writes to
+ * @param dataset_filename file the dataset is imported from
+ * @param region_name name of the region
+ * @return path of the WAV file
+ */
+std::string GetBatchRenderFilename(const std::string& output_directory,
+                                   const std::string& dataset_filename,
+                                   const std::string& region_name) {
+  std::string directory = output_directory;
+  if (!directory.empty() && directory.back() != '/' &&
+      directory.back() != '\\')
+    directory += '/';
+
+  return directory + SanitizeFilename(GetStem(dataset_filename)) + "-" +
+         SanitizeFilename(region_name) + ".wav";
+}
+
+/**
+ * Renders every region of every dataset to its own WAV file, running the
+ * renders concurrently on a thread pool. Each render builds its own STK
+ * chain, so renders share nothing but STK's sample rate and rawwave path,
+ * which are set here once and only read while jobs run.
+ *
+ * Jobs that fail are reported and the rest of the batch still renders.
+ * @param dataset_filenames files of the datasets to render
+ * @param output_directory existing directory to write the WAV files to
+ * @param settings sonification, STK and threading settings of the batch
+ * @return number of files rendered, failures and throughput of the batch
+ * @throws std::invalid_argument if no rawwave path is given and the assets
+ *         have no rawwaves directory
+ */
+BatchRenderReport RenderBatch(const std::vector<std::string>& dataset_filenames,
+                              const std::string& output_directory,
+                              const BatchRenderSettings& settings) {
+  BatchRenderReport report;
+
+  // Instruments read both when they are built, so they are fixed first
+  stk::Stk::setSampleRate(settings.sample_rate);
+  const std::string rawwave_path = settings.rawwave_path.empty()
+                                       ? FindRawwavePath()
+                                       : settings.rawwave_path;
+  if (rawwave_path.empty())
+    throw std::invalid_argument("No rawwaves directory in the assets");
+  stk::Stk::setRawwavePath(rawwave_path);
+
+  std::vector<RenderJob> jobs;
+  ListJobs(dataset_filenames, output_directory, jobs, report);
+
+  // Longest renders start first, so no thread is left with a long one at the
+  // end while the others idle
+  std::stable_sort(jobs.begin(), jobs.end(),
+                   [](const RenderJob& x, const RenderJob& y) {
+                     return x.view.Size() > y.view.Size();
+                   });
+
+  std::mutex report_mutex;
+  size_t num_frames = 0;
+  auto start = std::chrono::steady_clock::now();
+  {
+    coviddata::ThreadPool pool(settings.num_threads);
+    report.num_threads = pool.Size();
+
+    std::vector<std::future<void>> renders;
+    renders.reserve(jobs.size());
+    for (const RenderJob& job : jobs) {
+      renders.push_back(pool.Submit([&job, &settings, &report, &report_mutex,
+                                     &num_frames] {
+        std::string failure;
+        size_t job_frames = 0;
+        try {
+          job_frames = RenderSonification(job.view, 0, job.max_amount,
+                                          settings.render, job.filename);
+        } catch (stk::StkError& e) {
+          failure = job.filename + ": " + e.getMessage();
+        } catch (const std::exception& e) {
+          failure = job.filename + ": " + e.what();
+        }
+
+        std::lock_guard<std::mutex> lock(report_mutex);
+        if (failure.empty()) {
+          report.num_rendered++;
+          num_frames += job_frames;
+        } else {
+          report.failures.push_back(failure);
+        }
+      }));
+    }
+    for (std::future<void>& render : renders) render.get();
+  }
+  auto finish = std::chrono::steady_clock::now();
+
+  report.audio_seconds =
+      static_cast<double>(num_frames) / stk::Stk::sampleRate();
+  report.wall_seconds = std::chrono::duration<double>(finish - start).count();
+  return report;
+}
+
+}  // namespace covidsonifapp
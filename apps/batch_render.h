@@ -0,0 +1,49 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_APPS_BATCH_RENDER_H_
+#define FINALPROJECT_APPS_BATCH_RENDER_H_
+
+#include "offline_render.h"
+
+#include <string>
+#include <vector>
+
+namespace covidsonifapp {
+
+/**
+ * Settings of a batch render. STK's sample rate and rawwave path are global,
+ * so they are set once for the whole batch, before any job starts.
+ */
+struct BatchRenderSettings {
+  RenderSettings render;
+  double sample_rate = 44100;
+  // Empty to use the rawwaves in the assets (see FindRawwavePath)
+  std::string rawwave_path;
+  // 0 to use every hardware thread
+  size_t num_threads = 0;
+};
+
+/**
+ * Outcome of a batch render
+ */
+struct BatchRenderReport {
+  size_t num_rendered = 0;
+  // Reasons jobs failed, each prefixed with the file they concern
+  std::vector<std::string> failures;
+  double audio_seconds = 0;
+  double wall_seconds = 0;
+  size_t num_threads = 0;
+
+  double GetRealTimeFactor() const;
+};
+
+std::string GetBatchRenderFilename(const std::string& output_directory,
+                                   const std::string& dataset_filename,
+                                   const std::string& region_name);
+BatchRenderReport RenderBatch(const std::vector<std::string>& dataset_filenames,
+                              const std::string& output_directory,
+                              const BatchRenderSettings& settings);
+
+}  // namespace covidsonifapp
+
+#endif  // FINALPROJECT_APPS_BATCH_RENDER_H_
@@ -2,9 +2,9 @@
 
 #include "covid_sonif_app.h"
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
-#include <chrono>
-#include <thread>
 
 
 /*
@@ -37,7 +37,13 @@ const float kMaxVisualizationScaling = 1.0f;
 
 const float kInitialGain = 0.6f;
 
-const size_t kNumPitchClasses = 12;
+// Beats of playback handed to the audio thread ahead of time, so notes keep
+// their timing however long a frame takes
+const size_t kScheduleAheadBeats = 16;
+
+// Regions that can be played at once, each on a voice of its own
+const size_t kMinVoices = 1;
+const size_t kMaxVoices = 64;
 
 const char kNormalFont[] = "Consolas";
 
@@ -62,6 +68,12 @@ void CovidSonificationApp::setup() {
   master_gain_ = ctx->makeNode<cinder::audio::GainNode>(kInitialGain);
   master_gain_ >> ctx->getOutput();
 
+  sequencer_ = ctx->makeNode<SequencerNode>();
+  sequencer_ >> master_gain_;
+
+  // Load every dataset in the background so switching never stalls the UI
+  PreloadDatasets();
+
   SetupParams();
   HandleInstrumentsSelected();
   HandleEffectSelected();
@@ -76,25 +88,40 @@ void CovidSonificationApp::setup() {
  * Iterates over dataset and sonifies information as/when needed.
  */
 void CovidSonificationApp::update() {
+  // Finish selecting a dataset once its background load completes
+  if (is_loading_data_) HandleDataLoaded();
+
   if (in_sonification_playback) {
-    // Break statement; stops when no more dates are in the dataset
-    if (current_date_index_ == current_region_.GetDates().size()) {
+    // One date is played per beat; the sequencer counts beats in samples
+    const size_t elapsed_beats = sequencer_->GetElapsedBeats();
+    const size_t num_dates = GetNumPlayedDates();
+
+    // Break statement; stops once the last date has had its beat
+    if (elapsed_beats > num_dates) {
       in_sonification_playback = false;
       StopNote();
       finished_playback = true;
       return;
     }
 
-    // Play note using data
-    current_date_ =
-        current_region_.GetDates().at(current_date_index_);
-    current_amount_ = current_region_.GetAmountAtDate(current_date_);
-    MakeNoteFromAmount(current_amount_, max_amount_);
+    // Schedule the dates coming up, stopping early if the queue is full
+    const size_t schedule_end =
+        std::min(num_dates, elapsed_beats + kScheduleAheadBeats);
+    while (next_scheduled_beat_ < schedule_end &&
+           ScheduleBeat(next_scheduled_beat_)) {
+      next_scheduled_beat_++;
+    }
 
-    // Pause thread using specified BPM
-    std::this_thread::sleep_for(interval);
+    // Display the date whose note is sounding
+    current_date_index_ = std::min(elapsed_beats, current_view_.Size());
+    if (current_date_index_ > 0) {
+      current_date_ = current_view_.GetDate(current_date_index_ - 1);
+      current_amount_ = current_view_[current_date_index_ - 1];
 
-    current_date_index_++;
+      // Notes are quantized ahead of time, so show the pitch that is sounding
+      if (!coviddata::IsNullAmount(current_amount_))
+        QuantizePitchFromAmount(current_amount_, max_amount_);
+    }
   }
 }
 
@@ -106,6 +133,7 @@ void CovidSonificationApp::draw() {
 
   DisplayPitch();
   DisplayCurrentDataset();
+  DisplayLoadingMessage();
 
   if (!in_sonification_playback && !finished_playback) {
     DisplayDirections();
@@ -145,6 +173,7 @@ void CovidSonificationApp::mouseDrag(cinder::app::MouseEvent event) {
  * @param event mouse position
  */
 void CovidSonificationApp::mouseUp(cinder::app::MouseEvent event) {
+  if (in_sonification_playback) return;
   StopNote();
 }
 
@@ -181,6 +210,9 @@ void CovidSonificationApp::SetupParams() {
  * @param pos mouse positino
  */
 void CovidSonificationApp::MakeNote(const cinder::vec2& pos) {
+  // The mouse does not interrupt the sequencer's notes
+  if (in_sonification_playback) return;
+
   if (instrument_ && HandleInstrumentSpecificNote(pos)) {
     return;
   }
@@ -199,21 +231,52 @@ void CovidSonificationApp::MakeNote(const cinder::vec2& pos) {
 }
 
 /**
- * Calculates gain and frequency of note based on data.
+ * Schedules the date of every played region on a beat, one voice per region.
+ * If the sequencer fills up, the next call picks up from the voice it
+ * stopped at, so no note is scheduled twice.
+ * @param beat beat to schedule, which plays the date of the same index
+ * @return false if the sequencer could not take every note yet
+ */
+bool CovidSonificationApp::ScheduleBeat(size_t beat) {
+  for (; next_scheduled_voice_ <= accompanying_views_.size();
+       next_scheduled_voice_++) {
+    const coviddata::RegionView& view =
+        next_scheduled_voice_ == 0
+            ? current_view_
+            : accompanying_views_.at(next_scheduled_voice_ - 1);
+    if (beat >= view.Size()) continue;
+
+    if (!MakeNoteFromAmount(beat, next_scheduled_voice_, view[beat],
+                            max_amount_))
+      return false;
+  }
+
+  next_scheduled_voice_ = 0;
+  return true;
+}
+
+/**
+ * Calculates gain and frequency of note based on data and schedules it on a
+ * beat of the playback.
+ * @param beat beat to play the note on
+ * @param voice voice to play the note on, one per played region
  * @param amount data amount to sonify
  * @param max_amount maximum amount of dataset
+ * @return false if the sequencer could not take the note yet
  */
-void CovidSonificationApp::MakeNoteFromAmount(float amount, float max_amount) {
-  if (amount == coviddata::kNullAmount) return;
+bool CovidSonificationApp::MakeNoteFromAmount(size_t beat, size_t voice,
+                                              float amount, float max_amount) {
+  if (coviddata::IsNullAmount(amount)) return true;
 
   // Get the quantized freq; check if it's significant enough to change
   float freq = QuantizePitchFromAmount(amount, max_amount);
-  if (std::fabs(last_freq_ - freq) < 0.01f) return;
+  if (std::fabs(last_freq_ - freq) < 0.01f) return true;
 
   float gain = master_gain_->getValue();
 
-  // Set frequency and gain to instrument/generator accordingly
-  HandleNote(freq, gain);
+  // Schedule the note on the sequencer if an instrument is selected
+  if (!instrument_) return true;
+  return sequencer_->ScheduleNote(beat, voice, freq, gain);
 }
 
 /**
@@ -223,7 +286,7 @@ void CovidSonificationApp::MakeNoteFromAmount(float amount, float max_amount) {
  */
 void CovidSonificationApp::HandleNote(float freq, float gain) {
   if (instrument_) {
-    instrument_->noteOn(freq, gain);
+    sequencer_->PlayNote(0, freq, gain);
   }
 }
 
@@ -236,29 +299,16 @@ float CovidSonificationApp::QuantizePitch(const cinder::vec2& pos) {
   // Creates a mapping from height of mouse on screen to MIDI pitch,
   //   and finds the converted value of the pos.y of mouse
   // This is VERY helpful (see usage in QuantizePitchFromAmount)
-  int pitch_midi = std::lroundf(cinder::lmap(
+  int pitch_midi = MapToMidiPitch(
       pos.y,  // value to map
       (float)getWindowHeight(),
       0.0f,
-      (float)min_midi_pitch_,
-      (float)max_midi_pitch_));
-
-  bool quantized = false;
+      min_midi_pitch_,
+      max_midi_pitch_);
 
   // Decrease the scale degree of the note until it matches
   // with a diatonic note in the selected key
-  while (!quantized) {
-    int note = pitch_midi % kNumPitchClasses;
-    for (size_t i = 0; i < current_scale_.scale_length; i++) {
-      if (note == current_scale_.scale_degrees.at(i)) {
-        quantized = true;
-        break;
-      }
-    }
-    if (!quantized) {
-      pitch_midi--;
-    }
-  }
+  pitch_midi = QuantizeMidiPitch(pitch_midi, current_scale_.scale_degrees);
 
   // Apply bounds for pitches (Cinder does not automatically set bounds)
   if (pitch_midi > max_midi_pitch_) pitch_midi = max_midi_pitch_;
@@ -267,7 +317,7 @@ float CovidSonificationApp::QuantizePitch(const cinder::vec2& pos) {
   // Set current pitch for display
   current_midi_pitch_ = pitch_midi;
 
-  return cinder::audio::midiToFreq((float)pitch_midi);
+  return ConvertMidiToFrequency(pitch_midi);
 }
 
 /**
@@ -278,78 +328,52 @@ float CovidSonificationApp::QuantizePitch(const cinder::vec2& pos) {
  */
 float CovidSonificationApp::QuantizePitchFromAmount(float amount,
                                                     float max_amount) {
-  // Creates a mapping from [0, highest amount in data]
+  // Creates a mapping from [lowest amount, highest amount in data]
   //                     to [min MIDI pitch, max MIDI pitch]
   // Then finds the mapping of the specific data point to a specific MIDI pitch
-  int pitch_midi = std::lroundf(cinder::lmap(
-      (float)amount,
-      0.0f,
-      (float)max_amount,
-      (float)min_midi_pitch_,
-      (float)max_midi_pitch_));
-
-  bool quantized = false;
+  // The mapping is shared with offline renders, so both play the same notes
+  int pitch_midi = MapToMidiPitch(
+      amount,
+      min_amount_,
+      max_amount,
+      min_midi_pitch_,
+      max_midi_pitch_);
 
   // Decrease the scale degree of the note until it matches
   // with a diatonic note in the selected key
-  while (!quantized) {
-    int note = pitch_midi % kNumPitchClasses;
-    for (size_t i = 0; i < current_scale_.scale_length; i++) {
-      if (note == current_scale_.scale_degrees.at(i)) {
-        quantized = true;
-        break;
-      }
-    }
-    if (!quantized) {
-      pitch_midi--;
-    }
-  }
+  pitch_midi = QuantizeMidiPitch(pitch_midi, current_scale_.scale_degrees);
 
   // Set current pitch for display
   current_midi_pitch_ = pitch_midi;
 
-  return cinder::audio::midiToFreq((float)pitch_midi);
+  return ConvertMidiToFrequency(pitch_midi);
 }
 
 /**
  * Assigns instrument based on user selection.
  */
 void CovidSonificationApp::HandleInstrumentsSelected() {
-  // Disconnect all currently used instrument_s
-  if (instrument_) instrument_->disconnectAll();
-
   // Get the name of selected instrument_ and notify user
   const std::string& name = kInstrumentNames.at(instrument_selection_);
   CI_LOG_I("Selecting instrument_ '" << name << "'" );
 
   // Set instrument_ accordingly
-  auto ctx = cinder::audio::master();
-  if (name == "BandedWG") {
-    auto instr = ctx->makeNode<cistk::BandedWGNode>();
-    instr->setPreset(3);  // preset: 'Tibetan Bowl'
-    instrument_ = instr;
-  } else if (name == "BlowHole") {
-    instrument_ = ctx->makeNode<cistk::BlowHoleNode>();
-  } else if (name == "Bowed") {
-    instrument_ = ctx->makeNode<cistk::BowedNode>();
-  } else if( name == "Clarinet" ) {
-    instrument_ = ctx->makeNode<cistk::ClarinetNode>();
-  } else if( name == "Mandolin" ) {
-    instrument_ = ctx->makeNode<cistk::MandolinNode>();
-  } else if( name == "Plucked" ) {
-    instrument_ = ctx->makeNode<cistk::PluckedNode>();
-  } else if( name == "Saxofony" ) {
-    instrument_ = ctx->makeNode<cistk::SaxofonyNode>();
-  } else {
+  cistk::InstrumentNodeRef instrument = MakeInstrumentNode(name);
+  if (!instrument) {
     CI_LOG_E("Unknown instrument_ name");
     // CI_ASSERT_NOT_REACHABLE();
+    return;
   }
+  instrument_ = instrument;
 
-  // Set effect, if applicable
-  if (effect_) instrument_ >> effect_ >> master_gain_;
-  else         instrument_ >> master_gain_;
+  // Every voice gets an instrument of its own, made here rather than while
+  // playing, so the audio thread never waits on one
+  voice_instruments_ = {instrument_};
+  while (voice_instruments_.size() < num_voices_)
+    voice_instruments_.push_back(MakeInstrumentNode(name));
 
-  master_gain_ >> ctx->getOutput();
+  // The sequencer renders the instruments, so they are not connected
+  sequencer_->SetInstruments(voice_instruments_);
 }
 
 /**
@@ -381,8 +405,9 @@ void CovidSonificationApp::HandleEffectSelected() {
     CI_ASSERT_NOT_REACHABLE();
   }
 
-  // Play either instrument through effect
-  if( instrument_ ) instrument_ >> effect_;
+  // Play the sequenced instrument through effect
+  sequencer_->disconnectAll();
+  sequencer_ >> effect_;
 
   effect_ >> master_gain_ >> ctx->getOutput();
 }
@@ -391,7 +416,9 @@ void CovidSonificationApp::HandleEffectSelected() {
  * Handles dataset loading based on user selection.
  */
 void CovidSonificationApp::HandleDataSelected() {
-  current_data_.Reset();
+  // Cached datasets are shared, so swap in an empty one instead of resetting
+  current_data_ = std::make_shared<coviddata::DataSet>();
+  is_loading_data_ = false;
 
   // Find the name of the specific dataset
   const std::string& name = kDatasetNames.at(dataset_selection_);
@@ -405,13 +432,11 @@ void CovidSonificationApp::HandleDataSelected() {
       if (name == kDatasetNames.at(i)) {
         // Indices are offset by 1 because dataset names must
         // include "none" at the beginning.
-        const std::string& filename = kDatasetFilepaths.at(i - 1);
+        loading_filepath_ = dataset_keys_.at(i - 1);
+        is_loading_data_ = true;
 
-        current_data_.ImportData(filename);
-        region_names_ = current_data_.GetRegions();
-        SetupDataSonificationParams();
-        HandleRegionSelected();
-        HandleUpperBoundSelected();
+        // Completes right away if the dataset has already loaded
+        HandleDataLoaded();
 
         break;
       }
@@ -419,42 +444,163 @@ void CovidSonificationApp::HandleDataSelected() {
   }
 }
 
+/**
+ * Starts loading every dataset. OWID's long-format dump, when bundled, fills
+ * all of them in one pass; otherwise each dataset loads from its own file.
+ */
+void CovidSonificationApp::PreloadDatasets() {
+  const std::string long_format_filepath =
+      getAssetPath(kLongFormatDataPath).string();
+
+  dataset_keys_.clear();
+  if (long_format_filepath.empty()) {
+    dataset_keys_ = kDatasetFilepaths;
+    dataset_cache_.Preload(kDatasetFilepaths);
+    return;
+  }
+
+  for (const std::string& metric : kLongFormatMetrics) {
+    dataset_keys_.push_back(
+        coviddata::DataSetCache::GetMetricKey(long_format_filepath, metric));
+  }
+  dataset_cache_.PreloadLongFormat(long_format_filepath, kLongFormatMetrics);
+}
+
+/**
+ * Finishes selecting a dataset once the cache has loaded it.
+ */
+void CovidSonificationApp::HandleDataLoaded() {
+  if (!dataset_cache_.IsLoaded(loading_filepath_)) return;
+  is_loading_data_ = false;
+
+  try {
+    current_data_ = dataset_cache_.Get(loading_filepath_);
+  } catch (const std::exception& e) {
+    CI_LOG_E("Could not load '" << loading_filepath_ << "': " << e.what());
+    return;
+  }
+
+  region_names_ = current_data_->GetRegions();
+  SetupDataSonificationParams();
+  HandleRegionSelected();
+  HandleUpperBoundSelected();
+}
+
+/**
+ * Imports rows appended to the current dataset's file since it was loaded,
+ * without pausing to reload the whole dataset.
+ */
+void CovidSonificationApp::HandleDataRefreshed() {
+  if (current_data_->Empty() || is_loading_data_) return;
+
+  try {
+    size_t num_new_dates = current_data_->RefreshData();
+    CI_LOG_I("Refreshed data with " << num_new_dates << " new dates");
+
+    // The selected region is a copy, so select it again to see the new rows
+    HandleRegionSelected();
+    HandleUpperBoundSelected();
+  } catch (const std::exception& e) {
+    CI_LOG_E("Could not refresh data: " << e.what());
+  }
+}
+
 /**
  * Assigns region based on user selection.
  */
 void CovidSonificationApp::HandleRegionSelected() {
-  current_region_ = current_data_.GetRegionDataByName(
-      region_names_.at(region_selection_)
-      );
+  current_region_ = GetSeriesRegion(region_names_.at(region_selection_));
+
+  // Further voices play the regions listed after the selected one
+  accompanying_regions_.clear();
+  const size_t regions_end =
+      std::min(region_names_.size(), region_selection_ + num_voices_);
+  for (size_t region = region_selection_ + 1; region < regions_end; region++) {
+    accompanying_regions_.push_back(GetSeriesRegion(region_names_.at(region)));
+  }
+
+  // The views point into the regions, so they follow the new selection
+  HandleDateViewSelected();
+}
+
+/**
+ * Assigns the number of regions played at once, making an instrument for
+ * each of them.
+ */
+void CovidSonificationApp::HandleVoicesSelected() {
+  HandleInstrumentsSelected();
+  if (current_data_->Empty()) return;
+
+  HandleRegionSelected();
+  HandleUpperBoundSelected();
+}
+
+/**
+ * Assigns the dates to play based on user selection, ex. the last 90 days or
+ * weekly totals. Views are built instantly whatever the length of the data.
+ */
+void CovidSonificationApp::HandleDateViewSelected() {
+  current_view_ = GetDateView(current_region_);
+
+  accompanying_views_.clear();
+  for (const coviddata::RegionData& region : accompanying_regions_)
+    accompanying_views_.push_back(GetDateView(region));
 }
 
 /**
  * Assigns scale based on user selection.
  */
 void CovidSonificationApp::HandleScaleSelected() {
-  for (const Scale& scale : kScales) {
-    if (kScaleNames.at(scale_selection_) == scale.scale_name) {
-      current_scale_ = scale;
-      break;
-    }
-  }
+  const std::string& name = kScaleNames.at(scale_selection_);
+  const std::vector<float>& degrees = GetScaleDegrees(name);
+  current_scale_ = {name, degrees, degrees.size()};
 }
 
 /**
  * Handles the upper bound of data visualization/sonification based on selection.
  */
 void CovidSonificationApp::HandleUpperBoundSelected() {
+  min_amount_ = 0;
+
+  // Dataset-wide maximums are of amounts, so analytics are bounded by their
+  // played dates; growth and z-scores can also be negative
+  if (series_selection_ != kAmounts) {
+    const coviddata::AmountStats& stats = current_view_.GetStats();
+    max_amount_ = std::max(0.0f, stats.GetMax());
+    min_amount_ = std::min(0.0f, stats.GetMin());
+
+    // Regions played at once share the pitch range, so they share bounds
+    for (const coviddata::RegionView& view : accompanying_views_) {
+      const coviddata::AmountStats& view_stats = view.GetStats();
+      max_amount_ = std::max(max_amount_, view_stats.GetMax());
+      min_amount_ = std::min(min_amount_, view_stats.GetMin());
+    }
+    return;
+  }
+
   if (current_region_.GetRegionName() == "World") {
-    max_amount_ = GetHighestAmountInData(current_data_, true);
+    max_amount_ =
+        GetHighestAmountInData(*current_data_, true) * GetDateViewScale();
     return;
   }
 
   if (max_value_selection_ == kRegionalMax) {
-    max_amount_ = GetHighestRegionalAmount(current_region_);
+    // Only the played dates matter (ex. a weekly total, or a recent peak)
+    if (date_view_selection_ == kAllDates) {
+      max_amount_ = GetHighestRegionalAmount(current_region_);
+    } else {
+      max_amount_ = std::max(0.0f, current_view_.GetStats().GetMax());
+    }
+
+    // Regions played at once share the pitch range, so they share bounds
+    for (const coviddata::RegionView& view : accompanying_views_)
+      max_amount_ = std::max(max_amount_, view.GetStats().GetMax());
   } else if (max_value_selection_ == kInternationalMax) {
-    max_amount_ = GetHighestAmountInData(current_data_, false);
+    max_amount_ =
+        GetHighestAmountInData(*current_data_, false) * GetDateViewScale();
   } else if (max_value_selection_ == kCumulativeMax) {
-    max_amount_ = GetHighestAmountInData(current_data_, true);
+    max_amount_ =
+        GetHighestAmountInData(*current_data_, true) * GetDateViewScale();
   }
 }
 
@@ -476,7 +622,7 @@ bool CovidSonificationApp::HandleInstrumentSpecificNote(const cinder::vec2& pos)
   auto mesh_2d = std::dynamic_pointer_cast<cistk::Mesh2DNode>(instrument_);
   if (mesh_2d) {
     mesh_2d->setInputPosition(pos_normalized.x, pos_normalized.y);
-    instrument_->noteOn(0, 1.0f);
+    sequencer_->PlayNote(0, 0, 1.0f);
     return true;
   }
 
@@ -559,15 +705,15 @@ void CovidSonificationApp::SetupData() {
  */
 void CovidSonificationApp::SetupRegions() {
   // Data must be populated for regions to be setup
-  if (current_data_.Empty()) return;
+  if (current_data_->Empty()) return;
 
   // Sort regions by their value before adding as parameter
   std::sort(region_names_.begin(), region_names_.end(),
       [this] (const std::string& x, const std::string& y) {
               float x_max_amount = GetHighestRegionalAmount(
-                  current_data_.GetRegionDataByName(x));
+                  current_data_->GetRegionDataByName(x));
               float y_max_amount = GetHighestRegionalAmount(
-                  current_data_.GetRegionDataByName(y));
+                  current_data_->GetRegionDataByName(y));
               return x_max_amount < y_max_amount;
             });
 
@@ -583,6 +729,50 @@ void CovidSonificationApp::SetupRegions() {
       });
 }
 
+/**
+ * Sets up the number of regions played at once as a parameter.
+ */
+void CovidSonificationApp::SetupVoices() {
+  params_
+      ->addParam<size_t>(
+          "Regions at once",
+          [this] (size_t value) {
+            if (value < kMinVoices || value > kMaxVoices) return;
+            num_voices_ = value;
+            HandleVoicesSelected();
+          },
+          [this] { return num_voices_; })
+      .min(kMinVoices)
+      .max(kMaxVoices)
+      .step(1);
+}
+
+/**
+ * Sets up the dates to play as a parameter.
+ */
+void CovidSonificationApp::SetupDateView() {
+  params_->addParam("Dates", kDateViewNames, (int*)&date_view_selection_)
+      .keyDecr("n")
+      .keyIncr("m")
+      .updateFn([this] {
+        HandleDateViewSelected();
+        HandleUpperBoundSelected();
+      });
+}
+
+/**
+ * Sets up the amounts or rolling analytics to play as a parameter.
+ */
+void CovidSonificationApp::SetupSeries() {
+  params_->addParam("Series", kSeriesNames, (int*)&series_selection_)
+      .keyDecr("j")
+      .keyIncr("k")
+      .updateFn([this] {
+        HandleRegionSelected();
+        HandleUpperBoundSelected();
+      });
+}
+
 /**
  * Sets up button to begin sonification playback.
  */
@@ -592,6 +782,15 @@ void CovidSonificationApp::SetupSonifyButton() {
   });
 }
 
+/**
+ * Sets up button to pick up rows appended to the current dataset's file.
+ */
+void CovidSonificationApp::SetupRefreshButton() {
+  params_->addButton("Refresh data", [this] {
+    HandleDataRefreshed();
+  });
+}
+
 /**
  * Sets up visualization scaling parameters.
  */
@@ -791,12 +990,16 @@ void CovidSonificationApp::AssignBpm(size_t set_bpm) {
  */
 void CovidSonificationApp::SetupDataSonificationParams() {
   SetupRegions();
+  SetupVoices();
+  SetupDateView();
+  SetupSeries();
   SetupBpm();
   SetupUpperBound();
   SetupVisualizeButton();
   SetupVisualizationScaling();
   SetupRgba();
   SetupSonifyButton();
+  SetupRefreshButton();
 }
 
 /**
@@ -804,6 +1007,9 @@ void CovidSonificationApp::SetupDataSonificationParams() {
  */
 void CovidSonificationApp::RemoveDataSonificationParams() {
   params_->removeParam("Region");
+  params_->removeParam("Regions at once");
+  params_->removeParam("Dates");
+  params_->removeParam("Series");
   params_->removeParam("BPM");
   params_->removeParam("Upper bound");
   params_->removeParam("Toggle visualization");
@@ -814,20 +1020,23 @@ void CovidSonificationApp::RemoveDataSonificationParams() {
   params_->removeParam("B");
   params_->removeParam("Opacity");
   params_->removeParam("Sonify!");
+  params_->removeParam("Refresh data");
 }
 
 /**
  * Changes app state for update() to begin sonification playback.
  */
 void CovidSonificationApp::SonifyData() {
-  if (dataset_selection_ == 0) return;
+  if (dataset_selection_ == 0 || is_loading_data_) return;
 
   HandleUpperBoundSelected();  // assign max amount
 
-  int ms = ConvertBpmToMilliseconds(bpm_);
-  interval = std::chrono::milliseconds(ms);
+  // Beat 0 falls on the next block; dates are scheduled from update()
+  if (!sequencer_->Start(bpm_)) return;
 
   current_date_index_ = 0;
+  next_scheduled_beat_ = 0;
+  next_scheduled_voice_ = 0;
 
   in_sonification_playback = true;
 }
@@ -878,6 +1087,10 @@ void CovidSonificationApp::DisplayCurrentDataset() {
   current_dataset_message << prefix
                           << kDatasetNames.at(dataset_selection_) << " of "
                           << current_region_.GetRegionName();
+  if (!accompanying_regions_.empty()) {
+    current_dataset_message << " and " << accompanying_regions_.size()
+                            << " more regions";
+  }
   const cinder::ivec2 size = {1000, 50};
   const cinder::vec2 location = {getWindowCenter().x, 75};
 
@@ -886,19 +1099,46 @@ void CovidSonificationApp::DisplayCurrentDataset() {
            size, location);
 }
 
+/**
+ * Displays a loading message while the selected dataset is still loading.
+ */
+void CovidSonificationApp::DisplayLoadingMessage() {
+  if (!is_loading_data_) return;
+
+  std::stringstream loading_message;
+  loading_message << "Loading " << kDatasetNames.at(dataset_selection_)
+                  << "...";
+  const cinder::ivec2 size = {1000, 50};
+  const cinder::vec2 location = {getWindowCenter().x, 185};
+
+  ShowText(loading_message.str(), cinder::Color::white(), size, location);
+}
+
 /**
  * Displays the current data during sonification playback.
  */
 void CovidSonificationApp::DisplayCurrentNoteData() {
   if (dataset_selection_ == 0) return;
 
-  std::string label = kDatasetNames.at(dataset_selection_);
+  // Label amounts with the units inferred from the dataset; its name in the
+  // menu is only a fallback
+  const coviddata::Schema& schema = current_data_->GetSchema();
+  const size_t column = current_region_.GetRegionIndex();
+  std::string label = column < schema.Size() ? schema.GetUnitLabel(column)
+                                             : std::string();
+  if (label.empty()) label = kDatasetNames.at(dataset_selection_);
+  if (series_selection_ != kAmounts)
+    label = "(" + kSeriesNames.at(series_selection_) + " of " + label + ")";
   std::stringstream amount_display;
 
   // Display alternate message if no data is available for the current date
-  if (current_amount_ == coviddata::kNullAmount) {
+  if (coviddata::IsNullAmount(current_amount_)) {
     amount_display << "No data";
   } else {
+    // Whole counts are shown in full rather than in scientific notation
+    if (schema.GetValueType() == coviddata::ColumnType::kInteger &&
+        series_selection_ == kAmounts)
+      amount_display << std::fixed << std::setprecision(0);
     amount_display << current_amount_ << " " << label;
   }
 
@@ -934,12 +1174,12 @@ void CovidSonificationApp::DrawNoteData() {
   cinder::gl::color(cinder::ColorA(red_, green_, blue_, opacity_));  // red
 
   // Draw previous data points
-  for (size_t i = 0; i < current_date_index_; i++) {
-    float amount =
-        current_region_.GetAmountAtDate(current_region_.GetDates().at(i));
+  for (size_t i = 0; i < current_date_index_ && i < current_view_.Size();
+       i++) {
+    float amount = current_view_[i];
 
     // Skip this data point if the data is unavailable
-    if (amount == coviddata::kNullAmount) continue;
+    if (coviddata::IsNullAmount(amount)) continue;
 
     cinder::gl::drawSolidCircle(
         ConvertDataPointToPosition(i, amount),
@@ -954,15 +1194,8 @@ void CovidSonificationApp::DrawNoteData() {
  */
 float CovidSonificationApp::GetHighestRegionalAmount(
     const coviddata::RegionData& rd) {
-  // Find highest note of regional dataset
-  float max_amount = 0;
-
-  for (const std::string& date : rd.GetDates()) {
-    float amount = rd.GetAmountAtDate(date);
-    if (amount > max_amount) max_amount = amount;
-  }
-
-  return max_amount;
+  // Statistics are computed on import, so no amounts are scanned
+  return std::max(0.0f, rd.GetStats().GetMax());
 }
 
 /**
@@ -973,19 +1206,8 @@ float CovidSonificationApp::GetHighestRegionalAmount(
  */
 float CovidSonificationApp::GetHighestAmountInData(const coviddata::DataSet& ds,
                                                  bool include_world) {
-  float max_amount = 0;
-
-  for (const std::string& region_name : ds.GetRegions()) {
-    // Skips world if specified by user
-    if (!include_world && region_name == "World") continue;
-
-    coviddata::RegionData rd = ds.GetRegionDataByName(region_name);
-    float max_regional_amount = GetHighestRegionalAmount(rd);
-
-    if (max_regional_amount > max_amount) max_amount = max_regional_amount;
-  }
-
-  return max_amount;
+  // Skips world if specified by user
+  return std::max(0.0f, ds.GetStats(include_world).GetMax());
 }
 
 /**
@@ -993,7 +1215,7 @@ float CovidSonificationApp::GetHighestAmountInData(const coviddata::DataSet& ds,
  */
 void CovidSonificationApp::StopNote() {
   if (instrument_) {
-    instrument_->noteOff(0.5);
+    sequencer_->Stop(0.5f);
   }
 }
 
@@ -1026,14 +1248,91 @@ void CovidSonificationApp::ShowText(const std::string& text,
 }
 
 /**
- * Converts BPM to millisecond interval between beats as interval
- * @param bpm beats per minute
- * @return interval in milliseconds
+ * Returns how much larger than a single day's amount an entry of the played
+ * dates can be: weekly totals add up to a week of amounts
+ * @return factor to scale upper bounds of daily amounts by
  */
-int CovidSonificationApp::ConvertBpmToMilliseconds(int bpm) {
-  const int seconds_per_minute = 60;
-  const int ms_per_second = 1000;
-  return (seconds_per_minute * ms_per_second) / bpm;
+float CovidSonificationApp::GetDateViewScale() const {
+  return date_view_selection_ == kWeeklyTotals ? (float)kDaysPerWeek : 1.0f;
+}
+
+/**
+ * Makes the instrument node of the given name, set up as the app plays it.
+ * @param name name of the instrument
+ * @return instrument node, or nullptr if there is no such instrument
+ */
+cistk::InstrumentNodeRef CovidSonificationApp::MakeInstrumentNode(
+    const std::string& name) const {
+  auto ctx = cinder::audio::master();
+  if (name == "BandedWG") {
+    auto instr = ctx->makeNode<cistk::BandedWGNode>();
+    instr->setPreset(kBandedWGPreset);  // preset: 'Tibetan Bowl'
+    return instr;
+  } else if (name == "BlowHole") {
+    return ctx->makeNode<cistk::BlowHoleNode>();
+  } else if (name == "Bowed") {
+    return ctx->makeNode<cistk::BowedNode>();
+  } else if( name == "Clarinet" ) {
+    return ctx->makeNode<cistk::ClarinetNode>();
+  } else if( name == "Mandolin" ) {
+    return ctx->makeNode<cistk::MandolinNode>();
+  } else if( name == "Plucked" ) {
+    return ctx->makeNode<cistk::PluckedNode>();
+  } else if( name == "Saxofony" ) {
+    return ctx->makeNode<cistk::SaxofonyNode>();
+  }
+  return nullptr;
+}
+
+/**
+ * Returns the amounts or rolling analytics of a region, based on selection.
+ * @param region_name name of the region
+ * @return data of the region to play
+ */
+coviddata::RegionData CovidSonificationApp::GetSeriesRegion(
+    const std::string& region_name) const {
+  if (series_selection_ == kAmounts)
+    return current_data_->GetRegionDataByName(region_name);
+
+  // The dataset caches analytics, so they are only computed once
+  return current_data_->GetDerivedRegionData(
+      current_data_->GetRegionId(region_name),
+      kSeriesKernels.at(series_selection_ - 1),
+      kSeriesWindows.at(series_selection_ - 1));
+}
+
+/**
+ * Returns the dates of a region to play based on selection.
+ * @param region data of the region, which the view points into
+ * @return view of the dates to play
+ */
+coviddata::RegionView CovidSonificationApp::GetDateView(
+    const coviddata::RegionData& region) const {
+  const coviddata::RegionView all_dates(region);
+
+  if (date_view_selection_ == kRecentDates) {
+    return all_dates.Last(kNumRecentDates);
+  } else if (date_view_selection_ == kEveryWeek) {
+    return all_dates.Stride(kDaysPerWeek);
+  } else if (date_view_selection_ == kWeeklyTotals) {
+    return all_dates.Downsample(kDaysPerWeek, coviddata::Aggregation::kSum);
+  } else if (date_view_selection_ == kWeeklyAverages) {
+    return all_dates.Downsample(kDaysPerWeek, coviddata::Aggregation::kMean);
+  } else if (date_view_selection_ == kWeeklyMaximum) {
+    return all_dates.Downsample(kDaysPerWeek, coviddata::Aggregation::kMax);
+  }
+  return all_dates;
+}
+
+/**
+ * Returns how many dates playback takes, the most of any played region.
+ * @return number of beats with dates to play
+ */
+size_t CovidSonificationApp::GetNumPlayedDates() const {
+  size_t num_dates = current_view_.Size();
+  for (const coviddata::RegionView& view : accompanying_views_)
+    num_dates = std::max(num_dates, view.Size());
+  return num_dates;
 }
 
 /**
@@ -1051,7 +1350,7 @@ cinder::vec2 CovidSonificationApp::ConvertDataPointToPosition(size_t date_index,
   int x = std::lroundf(cinder::lmap(
       (float)date_index,
       (float)0,
-      (float)current_region_.GetDates().size(),
+      (float)current_view_.Size(),
       0.0f + (float)getWindowWidth() * (total_width_empty / 2.0f),
       (float)getWindowWidth() *
           (visualization_width_scaling_ + total_width_empty / 2)
@@ -1060,7 +1359,7 @@ cinder::vec2 CovidSonificationApp::ConvertDataPointToPosition(size_t date_index,
   // Map min/max MIDI pitch to the screen height position and find converted value
   int y = std::lroundf(cinder::lmap(
       amount,  // value to map
-      0.0f,
+      min_amount_,
       (float)max_amount_,
       (float)getWindowHeight() *
           (visualization_height_scaling_ + total_height_empty / 2),
@@ -14,7 +14,12 @@
 #include "cinder/audio/audio.h"
 #include "../blocks/Cinder-Stk/src/cistk/CinderStk.h"
 #include "../include/coviddata/dataset.h"
+#include "../include/coviddata/datasetcache.h"
+#include "../include/coviddata/regionview.h"
+#include "sequencer_node.h"
+#include "sonification.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -46,7 +51,9 @@ class CovidSonificationApp : public cinder::app::App {
  public:
   void SetupParams();
   void MakeNote(const cinder::vec2& pos);
-  void MakeNoteFromAmount(float amount, float max_amount);
+  bool ScheduleBeat(size_t beat);
+  bool MakeNoteFromAmount(size_t beat, size_t voice, float amount,
+                          float max_amount);
   float QuantizePitch(const cinder::vec2 &pos);
   float QuantizePitchFromAmount(float amount, float max_amount);
   void StopNote();
@@ -54,7 +61,12 @@ class CovidSonificationApp : public cinder::app::App {
   void HandleEffectSelected();
   bool HandleInstrumentSpecificNote(const cinder::vec2& pos);
   void HandleDataSelected();
+  void PreloadDatasets();
+  void HandleDataLoaded();
+  void HandleDataRefreshed();
   void HandleRegionSelected();
+  void HandleVoicesSelected();
+  void HandleDateViewSelected();
   void HandleScaleSelected();
   void HandleUpperBoundSelected();
   void SonifyData();
@@ -62,6 +74,7 @@ class CovidSonificationApp : public cinder::app::App {
   void DisplayDirections();
   void DisplayPitch();
   void DisplayCurrentDataset();
+  void DisplayLoadingMessage();
   void DisplayCurrentNoteData();
   void DisplayVisualizationToggle();
   void DrawNoteData();
@@ -76,6 +89,9 @@ class CovidSonificationApp : public cinder::app::App {
   void SetupEffects();
   void SetupData();
   void SetupRegions();
+  void SetupVoices();
+  void SetupDateView();
+  void SetupSeries();
   void SetupMaxMidiPitchParam();
   void SetMaxPitch(size_t new_pitch);
   void SetupMinMidiPitchParam();
@@ -87,18 +103,23 @@ class CovidSonificationApp : public cinder::app::App {
   void SetupRgba();
   void SetupVisualizeButton();
   void SetupSonifyButton();
+  void SetupRefreshButton();
   void AssignBpm(size_t set_bpm);
   void AssignHeightScaling(float new_scaling);
   void AssignWidthScaling(float new_scaling);
   void SetupDataSonificationParams();
   void RemoveDataSonificationParams();
   void HandleNote(float freq, float gain);
+  cistk::InstrumentNodeRef MakeInstrumentNode(const std::string& name) const;
+  coviddata::RegionData GetSeriesRegion(const std::string& region_name) const;
+  coviddata::RegionView GetDateView(const coviddata::RegionData& region) const;
+  size_t GetNumPlayedDates() const;
   static void ShowText(const std::string& text, const cinder::Color& color,
                 const cinder::ivec2& size, const cinder::vec2& loc);
   static float GetHighestRegionalAmount(const coviddata::RegionData& rd);
   static float GetHighestAmountInData(const coviddata::DataSet &ds,
                                     bool include_world);
-  static int ConvertBpmToMilliseconds(int bpm);
+  float GetDateViewScale() const;
   cinder::vec2 ConvertDataPointToPosition(size_t date_index, float amount);
 
  /**
@@ -117,27 +138,45 @@ class CovidSonificationApp : public cinder::app::App {
  private:
   ci::audio::GainNodeRef master_gain_;
 
+  // Plays the instruments on the audio thread, so notes start on exact samples
+  SequencerNodeRef sequencer_;
+  // Instrument of each voice; the first plays the selected region and the
+  // mouse
+  std::vector<cistk::InstrumentNodeRef> voice_instruments_;
   cistk::InstrumentNodeRef instrument_;
   cistk::EffectNodeRef effect_;
   Scale current_scale_;
-  coviddata::DataSet current_data_;
+  coviddata::DataSetCache dataset_cache_;
+  std::vector<std::string> dataset_keys_;
+  std::shared_ptr<coviddata::DataSet> current_data_ =
+      std::make_shared<coviddata::DataSet>();
   coviddata::RegionData current_region_;
+  // Dates of the current region that are played, viewed without copying
+  coviddata::RegionView current_view_;
+  // Regions played at once with the current one, one per further voice;
+  // the views point into the regions, so both are rebuilt together
+  std::vector<coviddata::RegionData> accompanying_regions_;
+  std::vector<coviddata::RegionView> accompanying_views_;
 
   cinder::params::InterfaceGlRef params_;
 
   // Instance variables for COVID-19 Data
   std::vector<std::string> region_names_;
   float max_amount_ = 0;
+  float min_amount_ = 0;
   std::string current_date_ = {};
   float current_amount_ = coviddata::kNullAmount;
   size_t current_date_index_ = 0;
+  size_t next_scheduled_beat_ = 0;
+  size_t next_scheduled_voice_ = 0;
   size_t current_midi_pitch_;
 
   // Variables for sonification parameters (set to initial values)
   size_t max_midi_pitch_ = 96;
   size_t min_midi_pitch_ = 36;
   int bpm_ = 999;
-  std::chrono::milliseconds interval;
+  // Regions played at once: the selected one and those listed after it
+  size_t num_voices_ = 1;
 
   // Visualization parameters
   float visualization_height_scaling_ = 1.0f;
@@ -147,6 +186,9 @@ class CovidSonificationApp : public cinder::app::App {
   float blue_ = 0.0f;
   float opacity_ = 0.75f;
 
+  bool is_loading_data_ = false;
+  std::string loading_filepath_;
+
   bool in_sonification_playback = false;
   bool finished_playback = false;
   bool is_visualizing = true;
@@ -156,6 +198,8 @@ class CovidSonificationApp : public cinder::app::App {
   size_t effect_enum_selection = 0;
   size_t dataset_selection_ = 0;
   size_t region_selection_ = 0;
+  size_t date_view_selection_ = 0;
+  size_t series_selection_ = 0;
   size_t scale_selection_ = 4;
   size_t max_value_selection_ = 1;
 
@@ -198,6 +242,19 @@ class CovidSonificationApp : public cinder::app::App {
           .string()
   };
 
+  // Optional long-format dump holding every dataset as a metric column
+  const std::string kLongFormatDataPath = "data/owid-covid-data.csv";
+
+  // Metric columns of the long-format dump, in the order of kDatasetFilepaths
+  const std::vector<std::string> kLongFormatMetrics = {
+      "total_cases", "total_deaths",
+      "new_cases", "new_deaths",
+      "total_tests", "new_tests",
+      "total_cases_per_million", "total_deaths_per_million",
+      "new_cases_per_million", "new_deaths_per_million",
+      "total_tests_per_thousand", "new_tests_per_thousand"
+  };
+
   const std::vector<std::string> kDatasetNames = {
       "none",
 
@@ -224,6 +281,46 @@ class CovidSonificationApp : public cinder::app::App {
   const size_t kInternationalMax = 1;
   const size_t kCumulativeMax = 2;
 
+  const size_t kAllDates = 0;
+  const size_t kRecentDates = 1;
+  const size_t kEveryWeek = 2;
+  const size_t kWeeklyTotals = 3;
+  const size_t kWeeklyAverages = 4;
+  const size_t kWeeklyMaximum = 5;
+
+  const size_t kNumRecentDates = 90;
+  const size_t kDaysPerWeek = 7;
+
+  const std::vector<std::string> kDateViewNames = {
+      "All dates",
+      "Last 90 days",
+      "Every 7th day",
+      "Weekly totals",
+      "Weekly averages",
+      "Weekly maximum"
+  };
+
+  // Rolling analytics that can be played instead of the amounts; each is
+  // computed by the dataset with the kernel and window at its index - 1
+  const size_t kAmounts = 0;
+
+  const std::vector<std::string> kSeriesNames = {
+      "Amounts",
+      "7-day average",
+      "Daily growth %",
+      "Doubling time in days",
+      "28-day z-score"
+  };
+
+  const std::vector<coviddata::RollingKernel> kSeriesKernels = {
+      coviddata::RollingKernel::kMovingAverage,
+      coviddata::RollingKernel::kGrowthRate,
+      coviddata::RollingKernel::kDoublingTime,
+      coviddata::RollingKernel::kZScore
+  };
+
+  const std::vector<size_t> kSeriesWindows = {7, 1, 7, 28};
+
   const std::vector<std::string> kMaxValueSettingNames = {
       "Regional maximum",
       "International maximum",
@@ -234,24 +331,8 @@ class CovidSonificationApp : public cinder::app::App {
   * Scale information
   */
  private:
-  const std::vector<std::string> kScaleNames = {
-      "Major", "Minor", "Pentatonic", "Whole tone", "Chromatic"
-  };
-
-  const std::vector<float> kMajorScale = {0, 2, 4, 5, 7, 9, 11};
-  const std::vector<float> kMinorScale = {0, 2, 3, 5, 7, 8, 10};
-  const std::vector<float> kPentatonicScale = {0, 2, 4, 7, 9};
-  const std::vector<float> kWholeToneScale = {0, 2, 4, 6, 8, 10};
-  const std::vector<float> kChromaticScale = {0, 1, 2, 3, 4,  5,
-                                              6, 7, 8, 9, 10, 11};
-
-  const std::vector<covidsonifapp::CovidSonificationApp::Scale> kScales = {
-      {kScaleNames.at(0), kMajorScale,      kMajorScale.size()},
-      {kScaleNames.at(1), kMinorScale,      kMinorScale.size()},
-      {kScaleNames.at(2), kPentatonicScale, kPentatonicScale.size()},
-      {kScaleNames.at(3), kWholeToneScale,  kWholeToneScale.size()},
-      {kScaleNames.at(4), kChromaticScale,  kChromaticScale.size()}
-  };
+  // Scales are shared with offline renders, so both quantize alike
+  const std::vector<std::string> kScaleNames = GetScaleNames();
 };
 
 }  // namespace covidsonifapp
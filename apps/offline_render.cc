@@ -0,0 +1,231 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "offline_render.h"
+
+#include "sonification.h"
+#include "cinder/app/Platform.h"
+#include "../blocks/Cinder-Stk/src/stk/FileWvOut.h"
+#include "../include/coviddata/amountstats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace covidsonifapp {
+
+namespace {
+
+const size_t kBlockFrames = 512;
+const unsigned int kNumChannels = 2;
+
+const double kSecondsPerMinute = 60.0;
+
+// Speed of the release once every date has played, as in the app
+const float kReleaseAmplitude = 0.5f;
+
+// Renders frames of a chain to the output, a block at a time
+template <typename Chain>
+void RenderFrames(Chain& chain, size_t num_frames,
+                  stk::StkFrames& frames, stk::FileWvOut& output) {
+  while (num_frames > 0) {
+    const size_t block_frames = std::min(num_frames, kBlockFrames);
+    frames.resize(block_frames, kNumChannels);
+    chain.Tick(frames);
+    output.tick(frames);
+    num_frames -= block_frames;
+  }
+}
+
+// Returns the frequency an amount is played at
+float GetNoteFrequency(float amount, float min_amount, float max_amount,
+                       const RenderSettings& settings,
+                       const std::vector<float>& scale_degrees) {
+  return ConvertMidiToFrequency(QuantizeMidiPitch(
+      MapToMidiPitch(amount, min_amount, max_amount, settings.min_midi_pitch,
+                     settings.max_midi_pitch),
+      scale_degrees));
+}
+
+// Returns the frame a beat starts on
+size_t GetBeatFrame(size_t beat, double frames_per_beat) {
+  return static_cast<size_t>(
+      std::llround(static_cast<double>(beat) * frames_per_beat));
+}
+
+}  // namespace
+
+/**
+ * Applies a command-line option of the render tools to the settings, ex.
+ * "--instrument" "Mandolin"
+ * @param option name of the option
+ * @param value value of the option
+ * @param settings settings to change
+ * @return false if the option is not a render setting
+ */
+bool ParseRenderOption(const std::string& option, const std::string& value,
+                       RenderSettings& settings) {
+  if (option == "--instrument") {
+    settings.instrument_name = value;
+  } else if (option == "--effect") {
+    settings.effect_name = value;
+  } else if (option == "--scale") {
+    settings.scale_name = value;
+  } else if (option == "--bpm") {
+    settings.bpm = std::strtod(value.c_str(), nullptr);
+  } else if (option == "--min-pitch") {
+    settings.min_midi_pitch = std::strtoul(value.c_str(), nullptr, 10);
+  } else if (option == "--max-pitch") {
+    settings.max_midi_pitch = std::strtoul(value.c_str(), nullptr, 10);
+  } else if (option == "--gain") {
+    settings.gain = std::strtof(value.c_str(), nullptr);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Finds the rawwaves directory among the assets, as the app does: Cinder
+ * looks for an assets directory next to the executable and in the
+ * directories above it, so the tools keep working wherever they are moved
+ * @return rawwave directory, or empty if there is none
+ */
+std::string FindRawwavePath() {
+  return ci::app::Platform::get()->getAssetPath("rawwaves").string();
+}
+
+/**
+ * Renders the sonification of a region's dates to a stereo 16-bit WAV file,
+ * as fast as the CPU allows. Dates are played one per beat, each starting on
+ * the sample its beat falls on, as the app plays them.
+ *
+ * STK's sample rate and rawwave path must already be set.
+ * @param view dates of the region to play
+ * @param min_amount amount played at the lowest pitch
+ * @param max_amount amount played at the highest pitch
+ * @param settings instrument, effect, scale, tempo and pitch range to play
+ * @param filename WAV file to write
+ * @return number of frames written
+ * @throws invalid_argument if the tempo is not positive or a name is unknown
+ * @throws stk::StkError if the file cannot be written or the instrument's
+ *         rawwaves cannot be read
+ */
+size_t RenderSonification(const coviddata::RegionView& view, float min_amount,
+                          float max_amount, const RenderSettings& settings,
+                          const std::string& filename) {
+  if (!(settings.bpm > 0))
+    throw std::invalid_argument("Tempo must be positive");
+
+  SonificationChain chain(settings.instrument_name, settings.effect_name,
+                          settings.gain);
+  const std::vector<float>& scale_degrees =
+      GetScaleDegrees(settings.scale_name);
+  const double frames_per_beat =
+      stk::Stk::sampleRate() * kSecondsPerMinute / settings.bpm;
+
+  stk::FileWvOut output(filename, kNumChannels, stk::FileWrite::FILE_WAV,
+                        stk::Stk::STK_SINT16, kBlockFrames);
+  stk::StkFrames frames(kBlockFrames, kNumChannels);
+  size_t num_frames = 0;
+
+  // The beat after the last date releases its note
+  for (size_t date = 0; date <= view.Size(); date++) {
+    const size_t beat_frame = GetBeatFrame(date, frames_per_beat);
+    RenderFrames(chain, beat_frame - num_frames, frames, output);
+    num_frames = beat_frame;
+
+    if (date == view.Size()) {
+      chain.NoteOff(kReleaseAmplitude);
+      break;
+    }
+
+    const float amount = view[date];
+    if (coviddata::IsNullAmount(amount)) continue;
+
+    chain.NoteOn(GetNoteFrequency(amount, min_amount, max_amount, settings,
+                                  scale_degrees),
+                 settings.gain);
+  }
+
+  const size_t tail_frames = static_cast<size_t>(
+      std::llround(settings.tail_seconds * stk::Stk::sampleRate()));
+  RenderFrames(chain, tail_frames, frames, output);
+
+  return num_frames + tail_frames;
+}
+
+/**
+ * Renders the sonification of several regions played at once, one voice per
+ * region, to a stereo 16-bit WAV file. Regions play their dates on the same
+ * beats, so dates of the same index sound together; each voice is released
+ * on the beat after its last date.
+ *
+ * Every region is mapped onto the same pitch range, so higher amounts sound
+ * higher whichever region they are in. STK's sample rate and rawwave path
+ * must already be set.
+ * @param views dates of each region to play
+ * @param min_amount amount played at the lowest pitch
+ * @param max_amount amount played at the highest pitch
+ * @param settings instrument, effect, scale, tempo and pitch range to play
+ * @param filename WAV file to write
+ * @return number of frames written
+ * @throws invalid_argument if the tempo is not positive, a name is unknown
+ *         or there are no regions
+ * @throws stk::StkError if the file cannot be written or the instrument's
+ *         rawwaves cannot be read
+ */
+size_t RenderPolyphonicSonification(
+    const std::vector<coviddata::RegionView>& views, float min_amount,
+    float max_amount, const RenderSettings& settings,
+    const std::string& filename) {
+  if (!(settings.bpm > 0))
+    throw std::invalid_argument("Tempo must be positive");
+  if (views.empty())
+    throw std::invalid_argument("At least one region must be played");
+
+  PolyphonicSonificationChain chain(settings.instrument_name,
+                                    settings.effect_name, settings.gain,
+                                    views.size());
+  const std::vector<float>& scale_degrees =
+      GetScaleDegrees(settings.scale_name);
+  const double frames_per_beat =
+      stk::Stk::sampleRate() * kSecondsPerMinute / settings.bpm;
+
+  size_t num_dates = 0;
+  for (const coviddata::RegionView& view : views)
+    num_dates = std::max(num_dates, view.Size());
+
+  stk::FileWvOut output(filename, kNumChannels, stk::FileWrite::FILE_WAV,
+                        stk::Stk::STK_SINT16, kBlockFrames);
+  stk::StkFrames frames(kBlockFrames, kNumChannels);
+  size_t num_frames = 0;
+
+  for (size_t date = 0; date <= num_dates; date++) {
+    const size_t beat_frame = GetBeatFrame(date, frames_per_beat);
+    RenderFrames(chain, beat_frame - num_frames, frames, output);
+    num_frames = beat_frame;
+
+    for (size_t voice = 0; voice < views.size(); voice++) {
+      const coviddata::RegionView& view = views[voice];
+      if (date == view.Size()) chain.NoteOff(voice, kReleaseAmplitude);
+      if (date >= view.Size()) continue;
+
+      const float amount = view[date];
+      if (coviddata::IsNullAmount(amount)) continue;
+
+      chain.NoteOn(voice,
+                   GetNoteFrequency(amount, min_amount, max_amount, settings,
+                                    scale_degrees),
+                   settings.gain);
+    }
+  }
+
+  const size_t tail_frames = static_cast<size_t>(
+      std::llround(settings.tail_seconds * stk::Stk::sampleRate()));
+  RenderFrames(chain, tail_frames, frames, output);
+
+  return num_frames + tail_frames;
+}
+
+}  // namespace covidsonifapp
@@ -0,0 +1,42 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_APPS_OFFLINE_RENDER_H_
+#define FINALPROJECT_APPS_OFFLINE_RENDER_H_
+
+#include "../include/coviddata/regionview.h"
+
+#include <string>
+#include <vector>
+
+namespace covidsonifapp {
+
+/**
+ * Sonification parameters of an offline render, named and defaulted as the
+ * app's parameters
+ */
+struct RenderSettings {
+  std::string instrument_name = "Clarinet";
+  std::string effect_name = "PRCRev";
+  std::string scale_name = "Chromatic";
+  double bpm = 999;
+  size_t min_midi_pitch = 36;
+  size_t max_midi_pitch = 96;
+  float gain = 0.6f;
+  // Seconds rendered after the last note is released, for the effect to ring
+  double tail_seconds = 2;
+};
+
+bool ParseRenderOption(const std::string& option, const std::string& value,
+                       RenderSettings& settings);
+std::string FindRawwavePath();
+size_t RenderSonification(const coviddata::RegionView& view, float min_amount,
+                          float max_amount, const RenderSettings& settings,
+                          const std::string& filename);
+size_t RenderPolyphonicSonification(
+    const std::vector<coviddata::RegionView>& views, float min_amount,
+    float max_amount, const RenderSettings& settings,
+    const std::string& filename);
+
+}  // namespace covidsonifapp
+
+#endif  // FINALPROJECT_APPS_OFFLINE_RENDER_H_
@@ -0,0 +1,318 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "sequencer_node.h"
+
+#include "sonification.h"
+
+#include "cinder/audio/Context.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace covidsonifapp {
+
+namespace {
+
+// Events the UI thread can queue before the audio thread drains them; a
+// beat takes one event per voice
+const size_t kEventQueueSize = 4096;
+// Scheduled notes the audio thread can hold before they are due
+const size_t kMaxScheduledNotes = 4096;
+
+// Tag of a voice that is not playing a note
+const long kNoVoiceTag = -1;
+
+// Elapsed beats are published with the playback id in the high bits
+const unsigned kPlaybackIdShift = 48;
+const uint64_t kBeatMask = (uint64_t(1) << kPlaybackIdShift) - 1;
+const uint64_t kMaxPlaybackId = (uint64_t(1) << (64 - kPlaybackIdShift)) - 1;
+
+const double kSecondsPerMinute = 60.0;
+
+}  // namespace
+
+/**
+ * Creates a sequencer without instruments; it renders silence until they are
+ * set. Like instruments, it is enabled as soon as it is connected.
+ * @param format format of the node
+ */
+SequencerNode::SequencerNode(const Format& format)
+    : InputNode(format), events_(kEventQueueSize), playback_id_(0),
+      instrument_nodes_(), voicer_(), voice_tags_(), mixdown_gain_(0),
+      scheduled_notes_(kMaxScheduledNotes), first_scheduled_note_(0),
+      num_scheduled_notes_(0), frame_(0), start_frame_(0),
+      frames_per_beat_(0), current_playback_id_(0), is_playing_(false),
+      elapsed_beats_(0) {
+  if (!format.isAutoEnableSet()) setAutoEnabled(true);
+}
+
+/**
+ * Plays notes on different instruments from the next block on, one voice per
+ * instrument. Notes of the previous instruments are cut off.
+ * @param instruments instrument node of each voice; none may be connected to
+ *                    the graph, since the sequencer renders them
+ */
+void SequencerNode::SetInstruments(
+    const std::vector<cistk::InstrumentNodeRef>& instruments) {
+  // Everything the audio thread needs is built here, before it is locked out
+  std::vector<cistk::InstrumentNodeRef> instrument_nodes = instruments;
+  std::unique_ptr<stk::Voicer> voicer(new stk::Voicer());
+  std::vector<long> voice_tags(instruments.size(), kNoVoiceTag);
+  float mixdown_gain = GetMixdownGain(instruments.size());
+
+  for (size_t voice = 0; voice < instruments.size(); voice++) {
+    // Every instrument node is also the STK instrument it plays; each voice
+    // is a group of its own, so its notes never take another voice
+    voicer->addInstrument(
+        dynamic_cast<stk::Instrmnt*>(instruments[voice].get()),
+        static_cast<int>(voice));
+  }
+
+  // The previous instruments are released after unlocking, so the audio
+  // thread is not kept waiting
+  {
+    std::lock_guard<std::mutex> lock(getContext()->getMutex());
+    instrument_nodes_.swap(instrument_nodes);
+    voicer_.swap(voicer);
+    voice_tags_.swap(voice_tags);
+    std::swap(mixdown_gain_, mixdown_gain);
+  }
+}
+
+/**
+ * Starts a new playback: beat 0 falls on the first sample of the next block
+ * and every later beat is counted in samples from there. Notes scheduled for
+ * an earlier playback are dropped.
+ * @param bpm tempo in beats per minute
+ * @return false if bpm is not positive or the event queue is full
+ */
+bool SequencerNode::Start(double bpm) {
+  if (!(bpm > 0)) return false;
+
+  const uint64_t playback_id = (playback_id_ + 1) & kMaxPlaybackId;
+  if (!PushEvent({Event::Type::kStart, playback_id, 0, bpm, 0, 0}))
+    return false;
+
+  playback_id_ = playback_id;
+  return true;
+}
+
+/**
+ * Stops playback, drops every scheduled note and releases the notes of every
+ * voice.
+ * @param amplitude speed of the release
+ * @return false if the event queue is full
+ */
+bool SequencerNode::Stop(float amplitude) {
+  return PushEvent({Event::Type::kStop, 0, 0, 0, 0, amplitude});
+}
+
+/**
+ * Schedules a note on a beat of the current playback, cutting off the note
+ * its voice was playing. Notes must be scheduled in beat order; a note
+ * scheduled after its beat has passed starts at the beginning of the next
+ * block.
+ * @param beat beat to start the note on, counted from 0 at Start()
+ * @param voice voice to play the note on; notes of missing voices are dropped
+ * @param frequency frequency of the note in hertz
+ * @param amplitude amplitude of the note
+ * @return false if the event queue is full; the note can be scheduled again
+ */
+bool SequencerNode::ScheduleNote(size_t beat, size_t voice, float frequency,
+                                 float amplitude) {
+  return PushEvent({Event::Type::kScheduledNoteOn, beat, voice, 0, frequency,
+                    amplitude});
+}
+
+/**
+ * Starts a note at the beginning of the next block, cutting off the note its
+ * voice was playing.
+ * @param voice voice to play the note on; notes of missing voices are dropped
+ * @param frequency frequency of the note in hertz
+ * @param amplitude amplitude of the note
+ * @return false if the event queue is full
+ */
+bool SequencerNode::PlayNote(size_t voice, float frequency, float amplitude) {
+  return PushEvent({Event::Type::kNoteOn, 0, voice, 0, frequency, amplitude});
+}
+
+/**
+ * Returns how many beats of the current playback have started, as of the
+ * last block rendered
+ * @return number of started beats; 0 until the audio thread starts playback
+ */
+size_t SequencerNode::GetElapsedBeats() const {
+  const uint64_t elapsed_beats =
+      elapsed_beats_.load(std::memory_order_acquire);
+  if ((elapsed_beats >> kPlaybackIdShift) != playback_id_) return 0;
+
+  return static_cast<size_t>(elapsed_beats & kBeatMask);
+}
+
+/**
+ * Renders one block, starting each note that is due within it on its exact
+ * sample.
+ * @param buffer block to render into
+ */
+void SequencerNode::process(ci::audio::Buffer* buffer) {
+  // The instruments are not in the graph, so their own controls are applied
+  // here
+  for (const cistk::InstrumentNodeRef& instrument_node : instrument_nodes_)
+    instrument_node->drainControlMessages();
+  DrainEvents();
+
+  const size_t num_frames = buffer->getNumFrames();
+  const uint64_t block_end = frame_ + num_frames;
+  size_t rendered_frames = 0;
+
+  while (is_playing_ && num_scheduled_notes_ > 0) {
+    const Event& note = scheduled_notes_[first_scheduled_note_];
+    const uint64_t due_frame =
+        start_frame_ + static_cast<uint64_t>(std::llround(
+                           static_cast<double>(note.beat) * frames_per_beat_));
+    if (due_frame >= block_end) break;
+
+    // Render up to the note, then start it on that very sample
+    const size_t offset =
+        due_frame > frame_ ? static_cast<size_t>(due_frame - frame_) : 0;
+    Render(buffer, rendered_frames, offset);
+    rendered_frames = std::max(rendered_frames, offset);
+    StartNote(note);
+
+    first_scheduled_note_ = (first_scheduled_note_ + 1) % kMaxScheduledNotes;
+    num_scheduled_notes_--;
+  }
+
+  Render(buffer, rendered_frames, num_frames);
+  frame_ = block_end;
+  PublishElapsedBeats();
+}
+
+/**
+ * Queues an event for the audio thread without blocking
+ * @param event event to queue
+ * @return false if the queue is full
+ */
+bool SequencerNode::PushEvent(const Event& event) {
+  return events_.write(&event, 1);
+}
+
+/**
+ * Applies every queued event, stopping early if there is no room left for
+ * scheduled notes; the rest are applied once notes have been played
+ */
+void SequencerNode::DrainEvents() {
+  Event event;
+  while (events_.getAvailableRead() > 0 &&
+         num_scheduled_notes_ < kMaxScheduledNotes) {
+    events_.read(&event, 1);
+    ApplyEvent(event);
+  }
+}
+
+/**
+ * Applies one event on the audio thread
+ * @param event event to apply
+ */
+void SequencerNode::ApplyEvent(const Event& event) {
+  switch (event.type) {
+    case Event::Type::kStart:
+      num_scheduled_notes_ = 0;
+      start_frame_ = frame_;
+      frames_per_beat_ =
+          static_cast<double>(getSampleRate()) * kSecondsPerMinute / event.bpm;
+      current_playback_id_ = event.beat;
+      is_playing_ = true;
+      PublishElapsedBeats();
+      break;
+
+    case Event::Type::kStop:
+      num_scheduled_notes_ = 0;
+      is_playing_ = false;
+      ReleaseNotes(event.amplitude);
+      break;
+
+    case Event::Type::kNoteOn:
+      StartNote(event);
+      break;
+
+    case Event::Type::kScheduledNoteOn:
+      // Notes left over from a stopped playback are dropped
+      if (!is_playing_) break;
+      scheduled_notes_[(first_scheduled_note_ + num_scheduled_notes_) %
+                       kMaxScheduledNotes] = event;
+      num_scheduled_notes_++;
+      break;
+  }
+}
+
+/**
+ * Starts a note on its voice, cutting off the note the voice was playing
+ * @param event note on to start
+ */
+void SequencerNode::StartNote(const Event& event) {
+  if (!voicer_ || event.voice >= voice_tags_.size()) return;
+
+  voice_tags_[event.voice] = voicer_->noteOn(
+      ConvertFrequencyToMidi(event.frequency),
+      event.amplitude * kVoicerVelocityScale, static_cast<int>(event.voice));
+}
+
+/**
+ * Releases the notes of every voice
+ * @param amplitude speed of the release
+ */
+void SequencerNode::ReleaseNotes(float amplitude) {
+  if (!voicer_) return;
+
+  for (long& tag : voice_tags_) {
+    if (tag == kNoVoiceTag) continue;
+    voicer_->noteOff(tag, amplitude * kVoicerVelocityScale);
+    tag = kNoVoiceTag;
+  }
+}
+
+/**
+ * Renders the mix of every voice into a range of frames of every channel
+ * @param buffer block to render into
+ * @param begin first frame to render
+ * @param end one past the last frame to render
+ */
+void SequencerNode::Render(ci::audio::Buffer* buffer, size_t begin,
+                           size_t end) {
+  if (begin >= end) return;
+
+  float* first_channel = buffer->getChannel(0);
+  if (!voicer_) {
+    std::fill(first_channel + begin, first_channel + end, 0.0f);
+  } else {
+    for (size_t frame = begin; frame < end; frame++) {
+      first_channel[frame] =
+          static_cast<float>(voicer_->tick()) * mixdown_gain_;
+    }
+  }
+
+  // STK instruments are mono, so every channel plays the same samples
+  for (size_t channel = 1; channel < buffer->getNumChannels(); channel++) {
+    std::copy(first_channel + begin, first_channel + end,
+              buffer->getChannel(channel) + begin);
+  }
+}
+
+/**
+ * Publishes how many beats of the current playback have started by the end
+ * of the last rendered block
+ */
+void SequencerNode::PublishElapsedBeats() {
+  if (!is_playing_) return;
+
+  const double elapsed_frames = static_cast<double>(frame_ - start_frame_);
+  const uint64_t elapsed_beats =
+      static_cast<uint64_t>(std::ceil(elapsed_frames / frames_per_beat_));
+  elapsed_beats_.store(
+      (current_playback_id_ << kPlaybackIdShift) | (elapsed_beats & kBeatMask),
+      std::memory_order_release);
+}
+
+}  // namespace covidsonifapp
@@ -0,0 +1,106 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_APPS_SEQUENCER_NODE_H_
+#define FINALPROJECT_APPS_SEQUENCER_NODE_H_
+
+#include "cinder/audio/InputNode.h"
+#include "cinder/audio/dsp/RingBuffer.h"
+
+#include "../blocks/Cinder-Stk/src/cistk/InstrumentNode.h"
+#include "../blocks/Cinder-Stk/src/stk/Voicer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace covidsonifapp {
+
+typedef std::shared_ptr<class SequencerNode> SequencerNodeRef;
+
+/**
+ * Audio node that plays STK instruments on a beat clock counted in samples.
+ *
+ * Notes are scheduled on beats from the UI thread, ahead of time, through a
+ * lock-free queue. Inside process() the instrument is rendered up to the
+ * exact sample each note is due on, the note is started there, and rendering
+ * continues, so tempo does not depend on frame rate or block size. Notes
+ * that should sound right away (ex. from the mouse) start at the beginning
+ * of the next block.
+ *
+ * Several instruments can play at once, one voice each (ex. one per region
+ * played), mixed down into the node's output. Voices are managed by an
+ * stk::Voicer that is built with every voice when the instruments are set,
+ * so nothing is allocated on the audio thread, and voices that are not
+ * sounding are not ticked.
+ *
+ * The node renders the instruments itself: their own nodes are only kept
+ * alive by the sequencer and must not be connected to the graph.
+ *
+ * Every method is called from the UI thread; only process() runs on the
+ * audio thread.
+ */
+class SequencerNode : public ci::audio::InputNode {
+ public:
+  explicit SequencerNode(const Format& format = Format());
+  void SetInstruments(const std::vector<cistk::InstrumentNodeRef>& instruments);
+  bool Start(double bpm);
+  bool Stop(float amplitude);
+  bool ScheduleNote(size_t beat, size_t voice, float frequency,
+                    float amplitude);
+  bool PlayNote(size_t voice, float frequency, float amplitude);
+  size_t GetElapsedBeats() const;
+
+ protected:
+  void process(ci::audio::Buffer* buffer) override;
+
+ private:
+  /**
+   * Message from the UI thread to the audio thread
+   */
+  struct Event {
+    enum class Type { kStart, kStop, kNoteOn, kScheduledNoteOn };
+
+    Type type;
+    uint64_t beat;      // beat of a scheduled note, or playback id of a start
+    size_t voice;       // voice of a note on
+    double bpm;         // tempo of a start
+    float frequency;    // frequency of a note on
+    float amplitude;    // amplitude of a note on or of a stop
+  };
+
+  bool PushEvent(const Event& event);
+  void DrainEvents();
+  void ApplyEvent(const Event& event);
+  void StartNote(const Event& event);
+  void ReleaseNotes(float amplitude);
+  void Render(ci::audio::Buffer* buffer, size_t begin, size_t end);
+  void PublishElapsedBeats();
+
+  // Written by the UI thread only
+  ci::audio::dsp::RingBufferT<Event> events_;
+  uint64_t playback_id_;
+
+  // Owned by the audio thread; the instruments are swapped under the context
+  // mutex, which the audio thread holds while rendering
+  std::vector<cistk::InstrumentNodeRef> instrument_nodes_;
+  std::unique_ptr<stk::Voicer> voicer_;
+  std::vector<long> voice_tags_;  // tag of each voice's note, or -1
+  float mixdown_gain_;
+  std::vector<Event> scheduled_notes_;  // ring of notes in beat order
+  size_t first_scheduled_note_;
+  size_t num_scheduled_notes_;
+  uint64_t frame_;
+  uint64_t start_frame_;
+  double frames_per_beat_;
+  uint64_t current_playback_id_;
+  bool is_playing_;
+
+  // Playback id in the high bits and elapsed beats in the low bits, so the
+  // UI never reads the beats of an earlier playback as the current one
+  std::atomic<uint64_t> elapsed_beats_;
+};
+
+}  // namespace covidsonifapp
+
+#endif  // FINALPROJECT_APPS_SEQUENCER_NODE_H_
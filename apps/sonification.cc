@@ -0,0 +1,318 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "sonification.h"
+
+#include "../blocks/Cinder-Stk/src/stk/BandedWG.h"
+#include "../blocks/Cinder-Stk/src/stk/BlowHole.h"
+#include "../blocks/Cinder-Stk/src/stk/Bowed.h"
+#include "../blocks/Cinder-Stk/src/stk/Clarinet.h"
+#include "../blocks/Cinder-Stk/src/stk/JCRev.h"
+#include "../blocks/Cinder-Stk/src/stk/Mandolin.h"
+#include "../blocks/Cinder-Stk/src/stk/NRev.h"
+#include "../blocks/Cinder-Stk/src/stk/PRCRev.h"
+#include "../blocks/Cinder-Stk/src/stk/Plucked.h"
+#include "../blocks/Cinder-Stk/src/stk/Saxofony.h"
+#include "../blocks/Cinder-Stk/src/stk/Voicer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace covidsonifapp {
+
+namespace {
+
+const size_t kNumPitchClasses = 12;
+
+const int kConcertPitchMidi = 69;
+const float kConcertPitchFrequency = 440.0f;
+
+// Lowest frequencies the instruments are built for, as by their cistk nodes
+const stk::StkFloat kBlowHoleLowestFrequency = 10;
+const stk::StkFloat kClarinetLowestFrequency = 8;
+const stk::StkFloat kMandolinLowestFrequency = 5;
+const stk::StkFloat kPluckedLowestFrequency = 10;
+const stk::StkFloat kSaxofonyLowestFrequency = 10;
+
+const std::vector<std::string> kScaleNames = {
+    "Major", "Minor", "Pentatonic", "Whole tone", "Chromatic"
+};
+
+const std::vector<std::vector<float>> kScaleDegrees = {
+    {0, 2, 4, 5, 7, 9, 11},
+    {0, 2, 3, 5, 7, 8, 10},
+    {0, 2, 4, 7, 9},
+    {0, 2, 4, 6, 8, 10},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}
+};
+
+// Makes the STK instrument of the given name, set up as the app plays it
+std::unique_ptr<stk::Instrmnt> MakeInstrument(const std::string& name) {
+  if (name == "BandedWG") {
+    stk::BandedWG* banded_wg = new stk::BandedWG();
+    banded_wg->setPreset(kBandedWGPreset);
+    return std::unique_ptr<stk::Instrmnt>(banded_wg);
+  } else if (name == "BlowHole") {
+    return std::unique_ptr<stk::Instrmnt>(
+        new stk::BlowHole(kBlowHoleLowestFrequency));
+  } else if (name == "Bowed") {
+    return std::unique_ptr<stk::Instrmnt>(new stk::Bowed());
+  } else if (name == "Clarinet") {
+    return std::unique_ptr<stk::Instrmnt>(
+        new stk::Clarinet(kClarinetLowestFrequency));
+  } else if (name == "Mandolin") {
+    return std::unique_ptr<stk::Instrmnt>(
+        new stk::Mandolin(kMandolinLowestFrequency));
+  } else if (name == "Plucked") {
+    return std::unique_ptr<stk::Instrmnt>(
+        new stk::Plucked(kPluckedLowestFrequency));
+  } else if (name == "Saxofony") {
+    return std::unique_ptr<stk::Instrmnt>(
+        new stk::Saxofony(kSaxofonyLowestFrequency));
+  }
+
+  throw std::invalid_argument("Unknown instrument: " + name);
+}
+
+// Wraps an STK reverb, which takes its input from the first channel and
+// writes both
+template <typename Reverb>
+std::function<void(stk::StkFrames&)> MakeReverb() {
+  std::shared_ptr<Reverb> reverb = std::make_shared<Reverb>();
+  return [reverb](stk::StkFrames& frames) { reverb->tick(frames); };
+}
+
+// Makes the STK effect of the given name, as the app applies it
+std::function<void(stk::StkFrames&)> MakeEffect(const std::string& name) {
+  if (name == "PRCRev") {
+    return MakeReverb<stk::PRCRev>();
+  } else if (name == "JCRev") {
+    return MakeReverb<stk::JCRev>();
+  } else if (name == "NRev") {
+    return MakeReverb<stk::NRev>();
+  }
+
+  throw std::invalid_argument("Unknown effect: " + name);
+}
+
+}  // namespace
+
+/**
+ * Returns the names of the scales notes can be quantized to
+ * @return names of the scales, in the order the app lists them
+ */
+const std::vector<std::string>& GetScaleNames() {
+  return kScaleNames;
+}
+
+/**
+ * Returns the pitch classes of a scale, in semitones above its tonic
+ * @param scale_name name of the scale
+ * @return pitch classes of the scale in ascending order
+ * @throws invalid_argument if there is no scale with the name
+ */
+const std::vector<float>& GetScaleDegrees(const std::string& scale_name) {
+  for (size_t scale = 0; scale < kScaleNames.size(); scale++) {
+    if (kScaleNames.at(scale) == scale_name) return kScaleDegrees.at(scale);
+  }
+  throw std::invalid_argument("Unknown scale: " + scale_name);
+}
+
+/**
+ * Maps a value linearly from a range onto a range of MIDI pitches. The
+ * ranges may be reversed, ex. to map screen heights from the bottom up.
+ * @param value value to map
+ * @param from_min value mapped to the minimum pitch
+ * @param from_max value mapped to the maximum pitch
+ * @param min_pitch minimum MIDI pitch
+ * @param max_pitch maximum MIDI pitch
+ * @return nearest MIDI pitch; outside the pitch range if the value is
+ *         outside its range
+ */
+int MapToMidiPitch(float value, float from_min, float from_max,
+                   size_t min_pitch, size_t max_pitch) {
+  const float min = static_cast<float>(min_pitch);
+  const float max = static_cast<float>(max_pitch);
+  const float from_range = from_max - from_min;
+
+  // A range of a single value maps to the lowest pitch
+  if (!(std::fabs(from_range) > 0)) return static_cast<int>(min_pitch);
+
+  return static_cast<int>(
+      std::lround(min + (value - from_min) / from_range * (max - min)));
+}
+
+/**
+ * Lowers a MIDI pitch until it is a note of a scale
+ * @param pitch MIDI pitch to quantize
+ * @param scale_degrees pitch classes of the scale
+ * @return highest pitch of the scale at or below the pitch, or 0 if there is
+ *         none
+ */
+int QuantizeMidiPitch(int pitch, const std::vector<float>& scale_degrees) {
+  for (; pitch > 0; pitch--) {
+    const float pitch_class =
+        static_cast<float>(static_cast<size_t>(pitch) % kNumPitchClasses);
+    for (float degree : scale_degrees) {
+      if (degree >= pitch_class && degree <= pitch_class) return pitch;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Converts a MIDI pitch to its frequency in equal temperament
+ * @param pitch MIDI pitch
+ * @return frequency in hertz
+ */
+float ConvertMidiToFrequency(int pitch) {
+  return kConcertPitchFrequency *
+         std::pow(2.0f, static_cast<float>(pitch - kConcertPitchMidi) /
+                            static_cast<float>(kNumPitchClasses));
+}
+
+/**
+ * Converts a frequency to its MIDI pitch in equal temperament
+ * @param frequency frequency in hertz
+ * @return MIDI pitch, with cents as the fraction
+ */
+float ConvertFrequencyToMidi(float frequency) {
+  return static_cast<float>(kConcertPitchMidi) +
+         static_cast<float>(kNumPitchClasses) *
+             std::log2(frequency / kConcertPitchFrequency);
+}
+
+/**
+ * Returns the gain voices are mixed down with, so that many voices sounding
+ * together stay about as loud as one. Voices playing different regions are
+ * mostly uncorrelated, so their levels add as powers.
+ * @param num_voices number of voices mixed down
+ * @return gain applied to the sum of the voices
+ */
+float GetMixdownGain(size_t num_voices) {
+  if (num_voices == 0) return 0;
+  return 1.0f / std::sqrt(static_cast<float>(num_voices));
+}
+
+/**
+ * Builds the chain. STK's sample rate and rawwave path must already be set,
+ * since instruments read them when they are built.
+ * @param instrument_name name of the instrument, as in the app
+ * @param effect_name name of the effect, as in the app
+ * @param gain gain applied to the output of the effect
+ * @throws invalid_argument if the instrument or effect is unknown
+ * @throws stk::StkError if the instrument's rawwaves cannot be read
+ */
+SonificationChain::SonificationChain(const std::string& instrument_name,
+                                     const std::string& effect_name,
+                                     float gain)
+    : instrument_(MakeInstrument(instrument_name)),
+      tick_effect_(MakeEffect(effect_name)),
+      gain_(gain) {}
+
+/**
+ * Starts a note on the instrument
+ * @param frequency frequency of the note in hertz
+ * @param amplitude amplitude of the note
+ */
+void SonificationChain::NoteOn(float frequency, float amplitude) {
+  instrument_->noteOn(frequency, amplitude);
+}
+
+/**
+ * Releases the note playing on the instrument
+ * @param amplitude speed of the release
+ */
+void SonificationChain::NoteOff(float amplitude) {
+  instrument_->noteOff(amplitude);
+}
+
+/**
+ * Renders the chain into a block of frames
+ * @param frames stereo frames to fill; every frame is overwritten
+ */
+void SonificationChain::Tick(stk::StkFrames& frames) {
+  instrument_->tick(frames, 0);
+  tick_effect_(frames);
+
+  for (size_t sample = 0; sample < frames.size(); sample++)
+    frames[sample] *= gain_;
+}
+
+const long PolyphonicSonificationChain::kNoVoiceTag;
+
+/**
+ * Builds the chain with every voice it can play, so playing notes never
+ * allocates. STK's sample rate and rawwave path must already be set.
+ * @param instrument_name name of the instrument every voice plays
+ * @param effect_name name of the effect the voices are mixed down into
+ * @param gain gain applied to the output of the effect
+ * @param num_voices number of voices, ex. one per region played
+ * @throws invalid_argument if the instrument or effect is unknown
+ * @throws stk::StkError if the instrument's rawwaves cannot be read
+ */
+PolyphonicSonificationChain::PolyphonicSonificationChain(
+    const std::string& instrument_name, const std::string& effect_name,
+    float gain, size_t num_voices)
+    : voice_tags_(num_voices, kNoVoiceTag),
+      tick_effect_(MakeEffect(effect_name)),
+      gain_(gain * GetMixdownGain(num_voices)) {
+  instruments_.reserve(num_voices);
+  for (size_t voice = 0; voice < num_voices; voice++) {
+    instruments_.push_back(MakeInstrument(instrument_name));
+
+    // Each voice is a group of its own, so its notes never take another's
+    voicer_.addInstrument(instruments_.back().get(), static_cast<int>(voice));
+  }
+}
+
+/**
+ * Returns how many voices the chain plays
+ * @return number of voices
+ */
+size_t PolyphonicSonificationChain::GetNumVoices() const {
+  return instruments_.size();
+}
+
+/**
+ * Starts a note on a voice, cutting off the note it was playing
+ * @param voice index of the voice
+ * @param frequency frequency of the note in hertz
+ * @param amplitude amplitude of the note
+ * @throws out_of_range if there is no such voice
+ */
+void PolyphonicSonificationChain::NoteOn(size_t voice, float frequency,
+                                         float amplitude) {
+  voice_tags_.at(voice) =
+      voicer_.noteOn(ConvertFrequencyToMidi(frequency),
+                     amplitude * kVoicerVelocityScale, static_cast<int>(voice));
+}
+
+/**
+ * Releases the note playing on a voice. Once it has decayed the voice is no
+ * longer ticked, so released voices cost nothing.
+ * @param voice index of the voice
+ * @param amplitude speed of the release
+ * @throws out_of_range if there is no such voice
+ */
+void PolyphonicSonificationChain::NoteOff(size_t voice, float amplitude) {
+  long& tag = voice_tags_.at(voice);
+  if (tag == kNoVoiceTag) return;
+
+  voicer_.noteOff(tag, amplitude * kVoicerVelocityScale);
+  tag = kNoVoiceTag;
+}
+
+/**
+ * Renders the mix of every voice through the effect into a block of frames
+ * @param frames stereo frames to fill; every frame is overwritten
+ */
+void PolyphonicSonificationChain::Tick(stk::StkFrames& frames) {
+  voicer_.tick(frames, 0);
+  tick_effect_(frames);
+
+  for (size_t sample = 0; sample < frames.size(); sample++)
+    frames[sample] *= gain_;
+}
+
+}  // namespace covidsonifapp
@@ -0,0 +1,92 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_APPS_SONIFICATION_H_
+#define FINALPROJECT_APPS_SONIFICATION_H_
+
+#include "../blocks/Cinder-Stk/src/stk/Instrmnt.h"
+#include "../blocks/Cinder-Stk/src/stk/Stk.h"
+#include "../blocks/Cinder-Stk/src/stk/Voicer.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * How data is turned into sound, shared by the app and by offline renders so
+ * that a rendered file sounds like playback in the app.
+ */
+namespace covidsonifapp {
+
+// BandedWG preset the app plays: 'Tibetan Bowl'
+const int kBandedWGPreset = 3;
+
+// stk::Voicer takes amplitudes as MIDI velocities and scales them by 1/128
+const stk::StkFloat kVoicerVelocityScale = 128;
+
+const std::vector<std::string>& GetScaleNames();
+const std::vector<float>& GetScaleDegrees(const std::string& scale_name);
+int MapToMidiPitch(float value, float from_min, float from_max,
+                   size_t min_pitch, size_t max_pitch);
+int QuantizeMidiPitch(int pitch, const std::vector<float>& scale_degrees);
+float ConvertMidiToFrequency(int pitch);
+float ConvertFrequencyToMidi(float frequency);
+float GetMixdownGain(size_t num_voices);
+
+/**
+ * The instrument -> effect -> gain chain the app builds out of audio nodes,
+ * made of the STK objects alone so it renders without an audio device.
+ *
+ * Instruments and effects are named as in the app's parameters. The chain
+ * renders stereo frames: the mono instrument feeds the effect, which writes
+ * both channels.
+ */
+class SonificationChain {
+ public:
+  SonificationChain(const std::string& instrument_name,
+                    const std::string& effect_name, float gain);
+  void NoteOn(float frequency, float amplitude);
+  void NoteOff(float amplitude);
+  void Tick(stk::StkFrames& frames);
+
+ private:
+  std::unique_ptr<stk::Instrmnt> instrument_;
+  // STK effects share no virtual tick(), so the effect is kept in a closure
+  std::function<void(stk::StkFrames&)> tick_effect_;
+  float gain_;
+};
+
+/**
+ * The same chain with a voice of the instrument for each region played at
+ * once, mixed down into a single effect. Voices are managed by an
+ * stk::Voicer, which only ticks voices that are sounding or decaying.
+ *
+ * Every voice is built up front, so playing notes never allocates, and the
+ * cost of a block grows with the number of voices sounding in it.
+ */
+class PolyphonicSonificationChain {
+ public:
+  PolyphonicSonificationChain(const std::string& instrument_name,
+                              const std::string& effect_name, float gain,
+                              size_t num_voices);
+  size_t GetNumVoices() const;
+  void NoteOn(size_t voice, float frequency, float amplitude);
+  void NoteOff(size_t voice, float amplitude);
+  void Tick(stk::StkFrames& frames);
+
+ private:
+  // Tag of a voice that is not playing a note
+  static const long kNoVoiceTag = -1;
+
+  // Declared before the voicer, which points into them
+  std::vector<std::unique_ptr<stk::Instrmnt>> instruments_;
+  stk::Voicer voicer_;
+  // Tag of each voice's note, which the voicer releases notes by
+  std::vector<long> voice_tags_;
+  std::function<void(stk::StkFrames&)> tick_effect_;
+  float gain_;
+};
+
+}  // namespace covidsonifapp
+
+#endif  // FINALPROJECT_APPS_SONIFICATION_H_
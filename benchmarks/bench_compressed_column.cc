@@ -0,0 +1,114 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "coviddata/compressedcolumn.h"
+#include "coviddata/dataset.h"
+
+/*
+ * Reports how well CompressedColumn packs the region columns of each dataset
+ * and how fast they decode, block by block and by random access.
+ *
+ * Usage: bench_compressed_column [data directory]
+ */
+namespace {
+
+const char kDefaultDirectory[] = "assets/data/";
+const size_t kRepetitions = 20;
+
+const std::vector<std::string> kDataFiles = {
+    "total_cases.csv",
+    "total_deaths.csv",
+    "new_cases.csv",
+    "new_deaths.csv",
+    "cumulative_total_tests.csv",
+    "daily_change_in_cumulative_total.csv",
+    "total_cases_per_million.csv",
+    "total_deaths_per_million.csv",
+    "new_cases_per_million.csv",
+    "new_deaths_per_million.csv",
+    "cumulative_total_per_thousand.csv",
+    "daily_change_in_cumulative_total_per_thousand.csv"};
+
+// Returns the fastest time of repeated runs in nanoseconds per amount
+template <typename Run>
+double TimePerAmount(Run run, size_t num_amounts, double& checksum) {
+  double best_ns = 0;
+  for (size_t repetition = 0; repetition < kRepetitions; repetition++) {
+    auto start = std::chrono::steady_clock::now();
+    checksum = run();
+    auto finish = std::chrono::steady_clock::now();
+
+    double ns =
+        std::chrono::duration<double, std::nano>(finish - start).count() /
+        static_cast<double>(num_amounts);
+    if (repetition == 0 || ns < best_ns) best_ns = ns;
+  }
+  return best_ns;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::string directory = argc > 1 ? argv[1] : kDefaultDirectory;
+
+  std::cout << "file,raw_bytes,compressed_bytes,ratio,block_decode_ns,"
+               "random_access_ns"
+            << std::endl;
+
+  for (const std::string& data_file : kDataFiles) {
+    coviddata::DataSet data_set;
+    data_set.ImportData(directory + data_file);
+
+    std::vector<coviddata::CompressedColumn> columns;
+    size_t raw_bytes = 0;
+    size_t compressed_bytes = 0;
+    size_t num_amounts = 0;
+    for (size_t id = 0; id < data_set.Size(); id++) {
+      coviddata::Span<const float> amounts =
+          data_set.GetRegionDataById(id).GetAmounts();
+      columns.emplace_back(amounts);
+      raw_bytes += amounts.Size() * sizeof(float);
+      compressed_bytes += columns.back().GetMemoryUsage();
+      num_amounts += amounts.Size();
+    }
+
+    double checksum = 0;
+    const double block_ns = TimePerAmount(
+        [&columns] {
+          float block[coviddata::CompressedColumn::kBlockSize];
+          double sum = 0;
+          for (const coviddata::CompressedColumn& column : columns) {
+            for (size_t b = 0; b < column.GetNumBlocks(); b++) {
+              size_t count = column.DecodeBlock(b, block);
+              for (size_t i = 0; i < count; i++) sum += block[i];
+            }
+          }
+          return sum;
+        },
+        num_amounts, checksum);
+
+    const double random_ns = TimePerAmount(
+        [&columns] {
+          double sum = 0;
+          for (const coviddata::CompressedColumn& column : columns) {
+            // Stride through the column so consecutive reads hit new blocks
+            for (size_t i = 0; i < column.Size(); i++)
+              sum += column.At(i * 97 % column.Size());
+          }
+          return sum;
+        },
+        num_amounts, checksum);
+
+    std::cout << data_file << ',' << raw_bytes << ',' << compressed_bytes
+              << ',' << static_cast<double>(raw_bytes) /
+                            static_cast<double>(compressed_bytes)
+              << ',' << block_ns << ',' << random_ns << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
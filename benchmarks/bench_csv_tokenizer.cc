@@ -0,0 +1,154 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "coviddata/csvparser.h"
+
+/*
+ * Compares the RFC 4180 tokenizer of CsvParser against the comma splitting
+ * it replaced (SplitStr, copied below as it was).
+ *
+ * Two things are timed per file, each as the best of several runs:
+ *   - buffered: reading the file into lines of strings, as the buffered
+ *     CsvParser constructor does
+ *   - tokenize: splitting rows that are already in memory, as the importers
+ *     do (SplitStr per line versus CsvParser::ForEachRow)
+ *
+ * Usage: bench_csv_tokenizer [csv files...]
+ */
+namespace {
+
+const char* const kDefaultSources[] = {"assets/data/new_cases.csv",
+                                       "assets/data/total_cases.csv",
+                                       "assets/data/total_deaths.csv"};
+const size_t kRepetitions = 20;
+
+// The splitting CsvParser used before it understood quotes
+std::vector<std::string> SplitStr(const std::string& s,
+                                  const std::string& delimiter) {
+  std::vector<std::string> split_string;
+  size_t last = 0;
+  size_t next = 0;
+
+  while ((next = s.find(delimiter, last)) != std::string::npos) {
+    split_string.push_back(s.substr(last, next - last));
+    last = next + 1;
+  }
+  split_string.push_back(s.substr(last));
+
+  return split_string;
+}
+
+// Reads a whole file into memory
+std::string ReadFile(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+// Returns the best time of repeated runs in milliseconds
+template <typename Run>
+double TimeBest(Run run, size_t& num_fields) {
+  double best_ms = 0;
+  for (size_t repetition = 0; repetition < kRepetitions; repetition++) {
+    auto start = std::chrono::steady_clock::now();
+    num_fields = run();
+    auto finish = std::chrono::steady_clock::now();
+
+    double ms =
+        std::chrono::duration<double, std::milli>(finish - start).count();
+    if (repetition == 0 || ms < best_ms) best_ms = ms;
+  }
+  return best_ms;
+}
+
+// Prints one comparison; the field counts must agree
+void Report(const std::string& source, const std::string& name,
+            double split_str_ms, size_t split_str_fields, double tokenizer_ms,
+            size_t tokenizer_fields) {
+  std::cout << source << ',' << name << ',' << split_str_ms << ','
+            << tokenizer_ms << ',' << split_str_ms / tokenizer_ms << ','
+            << (split_str_fields == tokenizer_fields ? "yes" : "NO")
+            << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> sources(argv + 1, argv + argc);
+  if (sources.empty())
+    sources.assign(std::begin(kDefaultSources), std::end(kDefaultSources));
+
+  std::cout << "file,test,split_str_ms,tokenizer_ms,speedup,same_fields"
+            << std::endl;
+
+  for (const std::string& source : sources) {
+    const std::string text = ReadFile(source);
+    if (text.empty()) {
+      std::cerr << "Could not read " << source << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    size_t split_str_fields = 0;
+    size_t tokenizer_fields = 0;
+
+    const double buffered_split_str_ms = TimeBest(
+        [&source] {
+          std::ifstream file(source);
+          std::vector<std::vector<std::string>> lines;
+          std::string line;
+          size_t num_fields = 0;
+          while (std::getline(file, line)) {
+            lines.push_back(SplitStr(line, ","));
+            num_fields += lines.back().size();
+          }
+          return num_fields;
+        },
+        split_str_fields);
+    const double buffered_tokenizer_ms = TimeBest(
+        [&source] {
+          coviddata::CsvParser parser(source);
+          size_t num_fields = 0;
+          for (const coviddata::CsvParser::Line& line : parser.GetLines())
+            num_fields += line.values.size();
+          return num_fields;
+        },
+        tokenizer_fields);
+    Report(source, "buffered", buffered_split_str_ms, split_str_fields,
+           buffered_tokenizer_ms, tokenizer_fields);
+
+    const double tokenize_split_str_ms = TimeBest(
+        [&text] {
+          std::istringstream lines(text);
+          std::string line;
+          size_t num_fields = 0;
+          while (std::getline(lines, line))
+            num_fields += SplitStr(line, ",").size();
+          return num_fields;
+        },
+        split_str_fields);
+    const double tokenize_tokenizer_ms = TimeBest(
+        [&text] {
+          coviddata::CsvParser parser(
+              coviddata::Span<const char>(text.data(), text.size()));
+          size_t num_fields = 0;
+          parser.ForEachRow([&num_fields](size_t,
+                                          coviddata::CsvParser::Row row) {
+            num_fields += row.Size();
+          });
+          return num_fields;
+        },
+        tokenizer_fields);
+    Report(source, "tokenize", tokenize_split_str_ms, split_str_fields,
+           tokenize_tokenizer_ms, tokenizer_fields);
+  }
+
+  return EXIT_SUCCESS;
+}
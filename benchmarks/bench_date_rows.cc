@@ -0,0 +1,164 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "coviddata/amountsearch.h"
+#include "coviddata/amountstats.h"
+#include "coviddata/dataset.h"
+
+/*
+ * Compares finding the region with the largest amount, and the ten largest,
+ * on every date of a dataset:
+ *   - by name: GetRegionDataByName(region).GetAmountAtDate(date) for every
+ *     region, then a scalar search or a sort of the gathered amounts
+ *   - by row: DataSet::GetAmountsAtIndex(date index) and the SIMD searches of
+ *     amountsearch.h
+ * The time to build the date rows is reported separately.
+ *
+ * Usage: bench_date_rows [source csv] [repetitions]
+ */
+namespace {
+
+const char kDefaultSource[] = "assets/data/total_cases.csv";
+const size_t kDefaultRepetitions = 20;
+const size_t kTopCount = 10;
+
+// Returns the fastest time in milliseconds of repeated runs
+template <typename Run>
+double TimeBest(Run run, size_t repetitions) {
+  double best_ms = 0;
+  for (size_t repetition = 0; repetition < repetitions; repetition++) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto finish = std::chrono::steady_clock::now();
+
+    double ms =
+        std::chrono::duration<double, std::milli>(finish - start).count();
+    if (repetition == 0 || ms < best_ms) best_ms = ms;
+  }
+  return best_ms;
+}
+
+// Gathers every region's amount on a date through per-region lookups
+void GatherByName(const coviddata::DataSet& data_set, const std::string& date,
+                  std::vector<float>& amounts) {
+  amounts.clear();
+  for (const std::string& region : data_set.GetRegions()) {
+    amounts.push_back(
+        data_set.GetRegionDataByName(region).GetAmountAtDate(date));
+  }
+}
+
+// Scalar search for the largest non-null amount
+size_t FindMaxIndexScalar(const std::vector<float>& amounts) {
+  size_t max_index = amounts.size();
+  for (size_t index = 0; index < amounts.size(); index++) {
+    if (coviddata::IsNullAmount(amounts[index])) continue;
+    if (max_index == amounts.size() || amounts[index] > amounts[max_index])
+      max_index = index;
+  }
+  return max_index;
+}
+
+// Sorts the indices of the non-null amounts to find the largest
+void FindTopBySort(const std::vector<float>& amounts,
+                   std::vector<size_t>& indices) {
+  indices.clear();
+  for (size_t index = 0; index < amounts.size(); index++) {
+    if (!coviddata::IsNullAmount(amounts[index])) indices.push_back(index);
+  }
+  const size_t count = std::min(kTopCount, indices.size());
+  std::partial_sort(indices.begin(), indices.begin() + count, indices.end(),
+                    [&amounts](size_t x, size_t y) {
+                      return amounts[x] > amounts[y];
+                    });
+  indices.resize(count);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::string source = argc > 1 ? argv[1] : kDefaultSource;
+  const size_t repetitions =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : kDefaultRepetitions;
+
+  coviddata::DataSet data_set;
+  data_set.ImportData(source);
+  const coviddata::DateAxis& date_axis = data_set.GetDateAxis();
+
+  std::cout << "Source: " << source << " (" << data_set.Size()
+            << " regions, " << date_axis.Size() << " dates)\n"
+            << "query,by_name_ms,by_row_ms,speedup,checksum" << std::endl;
+
+  // The first row retrieved transposes every column
+  {
+    coviddata::DataSet fresh_data_set;
+    fresh_data_set.ImportData(source);
+    auto start = std::chrono::steady_clock::now();
+    if (fresh_data_set.GetDateAxis().Size() > 0)
+      fresh_data_set.GetAmountsAtIndex(0);
+    auto finish = std::chrono::steady_clock::now();
+    std::cout << "build_rows,"
+              << std::chrono::duration<double, std::milli>(finish - start)
+                     .count()
+              << ",,," << std::endl;
+  }
+
+  std::vector<float> gathered;
+  std::vector<size_t> indices;
+  size_t checksum = 0;
+
+  const double max_by_name_ms = TimeBest(
+      [&]() {
+        checksum = 0;
+        for (const std::string& date : date_axis.GetDates()) {
+          GatherByName(data_set, date, gathered);
+          checksum += FindMaxIndexScalar(gathered);
+        }
+      },
+      repetitions);
+  const double max_by_row_ms = TimeBest(
+      [&]() {
+        checksum = 0;
+        for (size_t date_index = 0; date_index < date_axis.Size();
+             date_index++) {
+          checksum += coviddata::FindMaxAmountIndex(
+              data_set.GetAmountsAtIndex(date_index));
+        }
+      },
+      repetitions);
+  std::cout << "argmax," << max_by_name_ms << ',' << max_by_row_ms << ','
+            << max_by_name_ms / max_by_row_ms << ',' << checksum << std::endl;
+
+  const double top_by_name_ms = TimeBest(
+      [&]() {
+        checksum = 0;
+        for (const std::string& date : date_axis.GetDates()) {
+          GatherByName(data_set, date, gathered);
+          FindTopBySort(gathered, indices);
+          for (size_t index : indices) checksum += index;
+        }
+      },
+      repetitions);
+  const double top_by_row_ms = TimeBest(
+      [&]() {
+        checksum = 0;
+        for (size_t date_index = 0; date_index < date_axis.Size();
+             date_index++) {
+          coviddata::FindTopAmounts(data_set.GetAmountsAtIndex(date_index),
+                                    kTopCount, indices);
+          for (size_t index : indices) checksum += index;
+        }
+      },
+      repetitions);
+  std::cout << "top" << kTopCount << ',' << top_by_name_ms << ','
+            << top_by_row_ms << ',' << top_by_name_ms / top_by_row_ms << ','
+            << checksum << std::endl;
+
+  return EXIT_SUCCESS;
+}
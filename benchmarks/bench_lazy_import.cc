@@ -0,0 +1,62 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "coviddata/dataset.h"
+
+/*
+ * Compares the time until one region is ready to sonify when the whole file
+ * is imported against when the dataset is loaded lazily (see
+ * DataSet::SetLazyLoading), which only parses the requested region.
+ *
+ * Usage: bench_lazy_import [source csv] [region] [repetitions]
+ */
+namespace {
+
+const char kDefaultSource[] = "assets/data/new_cases.csv";
+const char kDefaultRegion[] = "United States";
+const size_t kDefaultRepetitions = 20;
+
+// Returns the fastest time in milliseconds to import a file and retrieve one
+// region from it
+double TimeFirstRegion(const std::string& source, const std::string& region,
+                       bool lazy_loading, size_t repetitions) {
+  double best_ms = 0;
+
+  for (size_t repetition = 0; repetition < repetitions; repetition++) {
+    auto start = std::chrono::steady_clock::now();
+    coviddata::DataSet data_set;
+    data_set.SetLazyLoading(lazy_loading);
+    data_set.ImportData(source);
+    data_set.GetRegionDataByName(region);
+    auto finish = std::chrono::steady_clock::now();
+
+    double ms =
+        std::chrono::duration<double, std::milli>(finish - start).count();
+    if (repetition == 0 || ms < best_ms) best_ms = ms;
+  }
+
+  return best_ms;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::string source = argc > 1 ? argv[1] : kDefaultSource;
+  const std::string region = argc > 2 ? argv[2] : kDefaultRegion;
+  const size_t repetitions =
+      argc > 3 ? std::strtoul(argv[3], nullptr, 10) : kDefaultRepetitions;
+
+  const double eager_ms = TimeFirstRegion(source, region, false, repetitions);
+  const double lazy_ms = TimeFirstRegion(source, region, true, repetitions);
+
+  std::cout << "Source: " << source << ", region: " << region << "\n"
+            << "loader,best_ms\n"
+            << "eager," << eager_ms << "\n"
+            << "lazy," << lazy_ms << "\n"
+            << "Speedup: " << eager_ms / lazy_ms << "x" << std::endl;
+  return EXIT_SUCCESS;
+}
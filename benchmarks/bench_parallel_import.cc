@@ -0,0 +1,89 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "coviddata/dataset.h"
+#include "coviddata/threadpool.h"
+#include "syntheticdata.h"
+
+/*
+ * Measures how DataSet::ImportData scales with its import thread count.
+ *
+ * A synthetic export is generated from new_cases_per_million.csv by repeating
+ * every region column (widening) and every row with later dates
+ * (lengthening), then the same file is imported with 1 to N threads.
+ *
+ * Usage: bench_parallel_import [source csv] [widen] [lengthen] [max threads]
+ */
+namespace {
+
+const char kDefaultSource[] = "assets/data/new_cases_per_million.csv";
+const char kSyntheticFile[] = "bench_parallel_import.csv";
+const size_t kDefaultWiden = 50;
+const size_t kDefaultLengthen = 20;
+const size_t kRepetitions = 5;
+
+// Returns the fastest of several imports in milliseconds
+double TimeImport(size_t num_threads) {
+  double best_ms = 0;
+
+  for (size_t repetition = 0; repetition < kRepetitions; repetition++) {
+    coviddata::DataSet data_set;
+    data_set.SetImportThreadCount(num_threads);
+
+    auto start = std::chrono::steady_clock::now();
+    data_set.ImportData(kSyntheticFile);
+    auto finish = std::chrono::steady_clock::now();
+
+    double ms =
+        std::chrono::duration<double, std::milli>(finish - start).count();
+    if (repetition == 0 || ms < best_ms) best_ms = ms;
+  }
+
+  return best_ms;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::string source = argc > 1 ? argv[1] : kDefaultSource;
+  const size_t widen =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : kDefaultWiden;
+  const size_t lengthen =
+      argc > 3 ? std::strtoul(argv[3], nullptr, 10) : kDefaultLengthen;
+  const size_t max_threads =
+      argc > 4 ? std::strtoul(argv[4], nullptr, 10)
+               : coviddata::ThreadPool::DefaultThreadCount();
+
+  size_t file_bytes = 0;
+  try {
+    file_bytes =
+        benchmarks::WriteSyntheticFile(source, kSyntheticFile, widen, lengthen);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  const double file_mb = static_cast<double>(file_bytes) / (1024.0 * 1024.0);
+  std::cout << "Synthetic file: " << kSyntheticFile << " (" << file_mb
+            << " MB, widen x" << widen << ", lengthen x" << lengthen << ")\n"
+            << "threads,best_ms,speedup,mb_per_s" << std::endl;
+
+  double single_thread_ms = 0;
+  for (size_t num_threads = 1; num_threads <= std::max<size_t>(max_threads, 1);
+       num_threads++) {
+    double ms = TimeImport(num_threads);
+    if (num_threads == 1) single_thread_ms = ms;
+
+    std::cout << num_threads << ',' << ms << ',' << single_thread_ms / ms
+              << ',' << file_mb / (ms / 1000.0) << std::endl;
+  }
+
+  std::remove(kSyntheticFile);
+  return EXIT_SUCCESS;
+}
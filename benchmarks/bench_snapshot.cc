@@ -0,0 +1,98 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "coviddata/dataset.h"
+
+/*
+ * Compares loading a dataset from its .csv file with DataSet::ImportData
+ * against loading a binary snapshot of it with DataSet::LoadSnapshot.
+ *
+ * Each load is timed until the dataset is ready to use: loading the file and
+ * then reading every amount once (which pages in the mapped snapshot). The
+ * first load of each kind is reported as cold start; the best of the rest as
+ * warm.
+ *
+ * Usage: bench_snapshot [source csv] [repetitions]
+ */
+namespace {
+
+const char kDefaultSource[] = "assets/data/total_cases.csv";
+const char kSnapshotFile[] = "bench_snapshot.cvsnap";
+const size_t kDefaultRepetitions = 20;
+
+// Reads every amount so that lazily paged data is counted as loaded
+double SumAmounts(const coviddata::DataSet& data_set) {
+  double sum = 0;
+  for (size_t id = 0; id < data_set.Size(); id++) {
+    for (float amount : data_set.GetRegionDataById(id).GetAmounts())
+      sum += amount;
+  }
+  return sum;
+}
+
+// Times a load until the dataset is ready, in milliseconds
+template <typename Load>
+double TimeLoad(Load load, double& checksum) {
+  auto start = std::chrono::steady_clock::now();
+  coviddata::DataSet data_set;
+  load(data_set);
+  checksum = SumAmounts(data_set);
+  auto finish = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+// Prints the cold and best warm time of repeated loads
+template <typename Load>
+double Report(const std::string& name, Load load, size_t repetitions) {
+  double checksum = 0;
+  const double cold_ms = TimeLoad(load, checksum);
+
+  double warm_ms = cold_ms;
+  for (size_t repetition = 1; repetition < repetitions; repetition++) {
+    double ms = TimeLoad(load, checksum);
+    if (repetition == 1 || ms < warm_ms) warm_ms = ms;
+  }
+
+  std::cout << name << ',' << cold_ms << ',' << warm_ms << ',' << checksum
+            << std::endl;
+  return warm_ms;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::string source = argc > 1 ? argv[1] : kDefaultSource;
+  const size_t repetitions =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : kDefaultRepetitions;
+
+  coviddata::DataSet source_data_set;
+  source_data_set.ImportData(source);
+  source_data_set.SaveSnapshot(kSnapshotFile);
+
+  std::cout << "Source: " << source << " (" << source_data_set.Size()
+            << " regions, " << source_data_set.GetDateAxis().Size()
+            << " dates)\n"
+            << "loader,cold_ms,warm_ms,checksum" << std::endl;
+
+  const double import_ms = Report(
+      "ImportData",
+      [&source](coviddata::DataSet& data_set) { data_set.ImportData(source); },
+      repetitions);
+  const double snapshot_ms = Report(
+      "LoadSnapshot",
+      [](coviddata::DataSet& data_set) {
+        data_set.LoadSnapshot(kSnapshotFile);
+      },
+      repetitions);
+
+  std::cout << "Warm speedup: " << import_ms / snapshot_ms << "x" << std::endl;
+
+  std::remove(kSnapshotFile);
+  return EXIT_SUCCESS;
+}
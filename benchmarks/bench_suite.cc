@@ -0,0 +1,379 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "coviddata/amountsearch.h"
+#include "coviddata/csvparser.h"
+#include "coviddata/dataset.h"
+#include "coviddata/mappedfile.h"
+#include "syntheticdata.h"
+
+/*
+ * Benchmark suite of the coviddata library, meant to be run regularly and
+ * compared against earlier runs to catch regressions. For every file it
+ * measures:
+ *   - parse_buffered, parse_mapped: CsvParser throughput (MB/s) reading every
+ *     row in buffered and memory-mapped mode
+ *   - import_serial, import_parallel: DataSet::ImportData latency (ms) on one
+ *     thread and on every hardware thread
+ *   - lookup_by_date: GetRegionDataByName(region).GetAmountAtDate(date) on
+ *     random regions and dates (million lookups/s)
+ *   - highest_amount: the app's GetHighestAmountInData, the maximum of the
+ *     dataset statistics (ns per call)
+ *   - highest_amount_scan: the same maximum found by scanning every region's
+ *     column (us per scan)
+ *
+ * Files are every bundled dataset, plus copies of the first one scaled up
+ * 10x and 100x in rows and, separately, in columns (see syntheticdata.h).
+ * Each measurement is the best of several repetitions.
+ *
+ * Results are written one per line as CSV (the default) or as a JSON array:
+ *   file,scale,rows,columns,bytes,benchmark,value,unit
+ *
+ * Usage: bench_suite [--format csv|json] [--output file] [--repetitions n]
+ *                    [--scales 10,100] [source csv...]
+ */
+namespace {
+
+const std::vector<std::string> kDefaultSources = {
+    "assets/data/total_cases.csv",
+    "assets/data/total_deaths.csv",
+    "assets/data/new_cases.csv",
+    "assets/data/new_deaths.csv",
+    "assets/data/cumulative_total_tests.csv",
+    "assets/data/daily_change_in_cumulative_total.csv",
+    "assets/data/total_cases_per_million.csv",
+    "assets/data/total_deaths_per_million.csv",
+    "assets/data/new_cases_per_million.csv",
+    "assets/data/new_deaths_per_million.csv",
+    "assets/data/cumulative_total_per_thousand.csv",
+    "assets/data/daily_change_in_cumulative_total_per_thousand.csv"
+};
+const std::vector<size_t> kDefaultScales = {10, 100};
+const size_t kDefaultRepetitions = 5;
+const size_t kNumLookups = 100000;
+const size_t kNumHighestAmountCalls = 1000000;
+const double kBytesPerMegabyte = 1024.0 * 1024.0;
+
+// Measured work stores its result here, so the compiler cannot drop it
+volatile double benchmark_sink = 0;
+
+/**
+ * A file to benchmark: a bundled dataset or a scaled-up copy of one
+ */
+struct BenchmarkFile {
+  std::string filename;
+  std::string scale;  // ex. "1x", "rows x10", "columns x100"
+  bool is_synthetic;
+};
+
+/**
+ * One measurement of one file
+ */
+struct Result {
+  std::string file;
+  std::string scale;
+  size_t rows;
+  size_t columns;
+  size_t bytes;
+  std::string benchmark;
+  double value;
+  std::string unit;
+};
+
+// Returns the fastest time in milliseconds of repeated runs
+template <typename Run>
+double TimeBest(Run run, size_t repetitions) {
+  double best_ms = 0;
+  for (size_t repetition = 0; repetition < repetitions; repetition++) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto finish = std::chrono::steady_clock::now();
+
+    double ms =
+        std::chrono::duration<double, std::milli>(finish - start).count();
+    if (repetition == 0 || ms < best_ms) best_ms = ms;
+  }
+  return best_ms;
+}
+
+void PrintUsage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [--format csv|json] [--output file] [--repetitions n]"
+            << " [--scales 10,100] [source csv...]" << std::endl;
+}
+
+// Parses a comma-separated list of scale factors (ex. "10,100")
+std::vector<size_t> ParseScales(const std::string& list) {
+  std::vector<size_t> scales;
+  std::stringstream stream(list);
+  std::string scale;
+  while (std::getline(stream, scale, ',')) {
+    const size_t factor = std::strtoul(scale.c_str(), nullptr, 10);
+    if (factor > 1) scales.push_back(factor);
+  }
+  return scales;
+}
+
+// Escapes a string for a JSON string literal (ex. Windows paths)
+std::string EscapeJson(const std::string& text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\') escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+// Quotes a CSV field if it holds a delimiter or a quote
+std::string EscapeCsv(const std::string& text) {
+  if (text.find_first_of(",\"") == std::string::npos) return text;
+
+  std::string escaped = "\"";
+  for (char c : text) {
+    if (c == '"') escaped += '"';
+    escaped += c;
+  }
+  return escaped + '"';
+}
+
+void WriteCsv(const std::vector<Result>& results, std::ostream& output) {
+  output << "file,scale,rows,columns,bytes,benchmark,value,unit\n";
+  for (const Result& result : results) {
+    output << EscapeCsv(result.file) << ',' << result.scale << ','
+           << result.rows << ',' << result.columns << ',' << result.bytes
+           << ',' << result.benchmark << ',' << result.value << ','
+           << result.unit << '\n';
+  }
+}
+
+void WriteJson(const std::vector<Result>& results, std::ostream& output) {
+  output << "[\n";
+  for (size_t index = 0; index < results.size(); index++) {
+    const Result& result = results[index];
+    output << "  {\"file\": \"" << EscapeJson(result.file)
+           << "\", \"scale\": \"" << result.scale
+           << "\", \"rows\": " << result.rows
+           << ", \"columns\": " << result.columns
+           << ", \"bytes\": " << result.bytes << ", \"benchmark\": \""
+           << result.benchmark << "\", \"value\": " << result.value
+           << ", \"unit\": \"" << result.unit << "\"}"
+           << (index + 1 < results.size() ? ",\n" : "\n");
+  }
+  output << "]\n";
+}
+
+// Runs every benchmark on one file and appends the results
+void BenchmarkFileInto(const BenchmarkFile& file, size_t repetitions,
+                       std::vector<Result>& results) {
+  size_t bytes = 0;
+  {
+    coviddata::MappedFile mapped_file(file.filename);
+    if (mapped_file.Fail())
+      throw std::invalid_argument("Could not read " + file.filename);
+    bytes = mapped_file.Size();
+  }
+  const double megabytes = static_cast<double>(bytes) / kBytesPerMegabyte;
+
+  coviddata::DataSet data_set;
+  data_set.ImportData(file.filename);
+  const size_t rows = data_set.GetDateAxis().Size();
+  const size_t columns = data_set.Size();
+
+  auto add_result = [&](const std::string& benchmark, double value,
+                        const std::string& unit) {
+    results.push_back(
+        {file.filename, file.scale, rows, columns, bytes, benchmark, value,
+         unit});
+    std::cerr << file.filename << " (" << file.scale << ") " << benchmark
+              << ": " << value << ' ' << unit << std::endl;
+  };
+
+  // Parsing
+  size_t num_fields = 0;
+  const double buffered_ms = TimeBest(
+      [&]() {
+        coviddata::CsvParser parser(file.filename,
+                                    coviddata::CsvParser::ReadMode::kBuffered);
+        num_fields = 0;
+        for (const coviddata::CsvParser::Line& line : parser.GetLines())
+          num_fields += line.values.size();
+      },
+      repetitions);
+  add_result("parse_buffered", megabytes / (buffered_ms / 1000.0), "MB/s");
+
+  const double mapped_ms = TimeBest(
+      [&]() {
+        coviddata::CsvParser parser(
+            file.filename, coviddata::CsvParser::ReadMode::kMemoryMapped);
+        std::vector<coviddata::CsvParser::Field> fields;
+        num_fields = 0;
+        while (parser.ReadRow(fields)) num_fields += fields.size();
+      },
+      repetitions);
+  add_result("parse_mapped", megabytes / (mapped_ms / 1000.0), "MB/s");
+
+  // Importing
+  for (size_t num_threads : {size_t(1), size_t(0)}) {
+    const double import_ms = TimeBest(
+        [&]() {
+          coviddata::DataSet imported_data_set;
+          imported_data_set.SetImportThreadCount(num_threads);
+          imported_data_set.ImportData(file.filename);
+        },
+        repetitions);
+    add_result(num_threads == 1 ? "import_serial" : "import_parallel",
+               import_ms, "ms");
+  }
+
+  // Lookups of random regions and dates, chosen before timing
+  const std::vector<std::string>& regions = data_set.GetRegions();
+  const std::vector<std::string>& dates = data_set.GetDateAxis().GetDates();
+  if (!regions.empty() && !dates.empty()) {
+    std::mt19937 generator(126);
+    std::uniform_int_distribution<size_t> pick_region(0, regions.size() - 1);
+    std::uniform_int_distribution<size_t> pick_date(0, dates.size() - 1);
+    std::vector<std::pair<size_t, size_t>> lookups;
+    for (size_t lookup = 0; lookup < kNumLookups; lookup++)
+      lookups.emplace_back(pick_region(generator), pick_date(generator));
+
+    double checksum = 0;
+    const double lookup_ms = TimeBest(
+        [&]() {
+          checksum = 0;
+          for (const std::pair<size_t, size_t>& lookup : lookups) {
+            checksum += data_set.GetRegionDataByName(regions[lookup.first])
+                            .GetAmountAtDate(dates[lookup.second]);
+          }
+        },
+        repetitions);
+    add_result("lookup_by_date",
+               static_cast<double>(kNumLookups) / (lookup_ms * 1000.0),
+               "Mlookups/s");
+    benchmark_sink = checksum;
+  }
+
+  // Highest amount, as the app finds it and by scanning every column
+  float highest_amount = 0;
+  const double highest_ms = TimeBest(
+      [&]() {
+        for (size_t call = 0; call < kNumHighestAmountCalls; call++) {
+          highest_amount = std::max(
+              highest_amount,
+              std::max(0.0f, data_set.GetStats(call % 2 == 0).GetMax()));
+        }
+      },
+      repetitions);
+  add_result("highest_amount",
+             highest_ms * 1e6 / static_cast<double>(kNumHighestAmountCalls),
+             "ns");
+
+  const double scan_ms = TimeBest(
+      [&]() {
+        highest_amount = 0;
+        for (size_t region_id = 0; region_id < data_set.Size(); region_id++) {
+          highest_amount = std::max(
+              highest_amount,
+              coviddata::FindMaxAmount(
+                  data_set.GetRegionDataById(region_id).GetAmounts()));
+        }
+      },
+      repetitions);
+  add_result("highest_amount_scan", scan_ms * 1000.0, "us");
+
+  benchmark_sink = static_cast<double>(num_fields) + highest_amount;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string format = "csv";
+  std::string output_filename;
+  size_t repetitions = kDefaultRepetitions;
+  std::vector<size_t> scales = kDefaultScales;
+  std::vector<std::string> sources;
+
+  for (int arg = 1; arg < argc; arg++) {
+    const std::string option = argv[arg];
+    const bool has_value = arg + 1 < argc;
+    if (option == "--format" && has_value) {
+      format = argv[++arg];
+    } else if (option == "--output" && has_value) {
+      output_filename = argv[++arg];
+    } else if (option == "--repetitions" && has_value) {
+      repetitions = std::max<size_t>(std::strtoul(argv[++arg], nullptr, 10), 1);
+    } else if (option == "--scales" && has_value) {
+      scales = ParseScales(argv[++arg]);
+    } else if (option.compare(0, 2, "--") == 0) {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    } else {
+      sources.push_back(option);
+    }
+  }
+  if (format != "csv" && format != "json") {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (sources.empty()) sources = kDefaultSources;
+
+  // Bundled files as they are, then scaled-up copies of the first one
+  std::vector<BenchmarkFile> files;
+  for (const std::string& source : sources)
+    files.push_back({source, "1x", false});
+
+  int exit_code = EXIT_SUCCESS;
+  for (size_t factor : scales) {
+    const std::string suffix = std::to_string(factor);
+    const BenchmarkFile longer = {"bench_suite_rows_x" + suffix + ".csv",
+                                  "rows x" + suffix, true};
+    const BenchmarkFile wider = {"bench_suite_columns_x" + suffix + ".csv",
+                                 "columns x" + suffix, true};
+    try {
+      benchmarks::WriteSyntheticFile(sources.front(), longer.filename, 1,
+                                     factor);
+      benchmarks::WriteSyntheticFile(sources.front(), wider.filename, factor,
+                                     1);
+      files.push_back(longer);
+      files.push_back(wider);
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      exit_code = EXIT_FAILURE;
+    }
+  }
+
+  std::vector<Result> results;
+  for (const BenchmarkFile& file : files) {
+    try {
+      BenchmarkFileInto(file, repetitions, results);
+    } catch (const std::exception& e) {
+      std::cerr << file.filename << ": " << e.what() << std::endl;
+      exit_code = EXIT_FAILURE;
+    }
+    if (file.is_synthetic) std::remove(file.filename.c_str());
+  }
+
+  std::ofstream output_file;
+  if (!output_filename.empty()) output_file.open(output_filename);
+  std::ostream& output = output_filename.empty() ? std::cout : output_file;
+
+  if (format == "json") {
+    WriteJson(results, output);
+  } else {
+    WriteCsv(results, output);
+  }
+
+  return exit_code;
+}
@@ -0,0 +1,133 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "../apps/sonification.h"
+#include "../blocks/Cinder-Stk/src/stk/Stk.h"
+
+/*
+ * Measures how many voices of an instrument one core can render in real
+ * time, as the polyphonic mode plays one voice per region.
+ *
+ * For 1 to N voices, every voice is retriggered on each beat at a pitch of
+ * its own, so all of them keep sounding, and a fixed length of audio is
+ * rendered through the effect into memory. The core load is the render time
+ * over the audio time; voices per core is the voice count over the load.
+ *
+ * Usage: bench_voices [instrument] [max voices] [sample rate] [seconds]
+ *            [rawwave directory]
+ */
+namespace {
+
+const char kDefaultInstrument[] = "Clarinet";
+const char kEffect[] = "PRCRev";
+const char kDefaultRawwavePath[] = "blocks/Cinder-Stk/assets/rawwaves/";
+const size_t kDefaultMaxVoices = 128;
+const double kDefaultSampleRate = 48000;
+const double kDefaultSeconds = 10;
+
+const size_t kBlockFrames = 512;
+const unsigned int kNumChannels = 2;
+const size_t kRepetitions = 3;
+
+// Dates per second the app plays at its default tempo of 999 bpm
+const double kBeatsPerSecond = 999.0 / 60.0;
+const float kGain = 0.6f;
+
+// Pitches of the voices wrap around a few octaves, as regions spread out
+const int kLowestPitch = 36;
+const int kNumPitches = 60;
+
+// Renders the voices into memory and returns the seconds it took
+double TimeRender(const std::string& instrument_name, size_t num_voices,
+                  double seconds) {
+  covidsonifapp::PolyphonicSonificationChain chain(instrument_name, kEffect,
+                                                   kGain, num_voices);
+  stk::StkFrames frames(kBlockFrames, kNumChannels);
+
+  const double frames_per_beat = stk::Stk::sampleRate() / kBeatsPerSecond;
+  const size_t num_frames =
+      static_cast<size_t>(seconds * stk::Stk::sampleRate());
+  double next_beat_frame = 0;
+  size_t beat = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t frame = 0; frame < num_frames; frame += kBlockFrames) {
+    // Notes start on block boundaries; the cost of a block does not depend
+    // on where in it they start
+    while (next_beat_frame < static_cast<double>(frame + kBlockFrames)) {
+      for (size_t voice = 0; voice < num_voices; voice++) {
+        const int pitch =
+            kLowestPitch + static_cast<int>((voice * 7 + beat) % kNumPitches);
+        chain.NoteOn(voice, covidsonifapp::ConvertMidiToFrequency(pitch),
+                     kGain);
+      }
+      next_beat_frame += frames_per_beat;
+      beat++;
+    }
+    chain.Tick(frames);
+  }
+  auto finish = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double>(finish - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::string instrument_name = argc > 1 ? argv[1] : kDefaultInstrument;
+  const size_t max_voices =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : kDefaultMaxVoices;
+  const double sample_rate =
+      argc > 3 ? std::strtod(argv[3], nullptr) : kDefaultSampleRate;
+  const double seconds =
+      argc > 4 ? std::strtod(argv[4], nullptr) : kDefaultSeconds;
+  const std::string rawwave_path = argc > 5 ? argv[5] : kDefaultRawwavePath;
+  if (max_voices == 0 || !(sample_rate > 0) || !(seconds > 0)) {
+    std::cerr << "Usage: " << argv[0]
+              << " [instrument] [max voices] [sample rate] [seconds]"
+                 " [rawwave directory]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  stk::Stk::setSampleRate(sample_rate);
+  stk::Stk::setRawwavePath(rawwave_path);
+
+  std::cout << instrument_name << " through " << kEffect << " at "
+            << sample_rate << " Hz, " << seconds << " s of audio per run\n"
+            << "voices,best_ms,core_load,voices_per_core" << std::endl;
+
+  double voices_per_core = 0;
+  try {
+    for (size_t num_voices = 1; num_voices <= max_voices; num_voices *= 2) {
+      double best_seconds = 0;
+      for (size_t repetition = 0; repetition < kRepetitions; repetition++) {
+        const double render_seconds =
+            TimeRender(instrument_name, num_voices, seconds);
+        if (repetition == 0 || render_seconds < best_seconds)
+          best_seconds = render_seconds;
+      }
+
+      // Share of one core the voices take to keep up with playback
+      const double core_load = best_seconds / seconds;
+      voices_per_core = static_cast<double>(num_voices) / core_load;
+      std::cout << num_voices << ',' << best_seconds * 1000.0 << ','
+                << core_load << ',' << voices_per_core << std::endl;
+    }
+  } catch (stk::StkError& e) {
+    std::cerr << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The most voices amortize the effect best, so they give the steady rate
+  std::cout << "Voices per core: " << voices_per_core << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_BENCHMARKS_SYNTHETICDATA_H
+#define FINALPROJECT_BENCHMARKS_SYNTHETICDATA_H
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "coviddata/csvparser.h"
+#include "coviddata/dateaxis.h"
+
+/*
+ * Scaled-up copies of the bundled datasets, shared by the benchmarks.
+ *
+ * A copy repeats every region column (widening, with " #<copy>" appended to
+ * the region names) and every row with later dates (lengthening), so it
+ * parses like a real export of a larger dataset.
+ */
+namespace benchmarks {
+
+// Inverse of DateAxis::ToDayNumber (civil_from_days by Howard Hinnant)
+inline std::string ToDate(int32_t day_number) {
+  day_number += 719468;
+  const int32_t era = (day_number >= 0 ? day_number : day_number - 146096) /
+                      146097;
+  const int32_t day_of_era = day_number - era * 146097;
+  const int32_t year_of_era = (day_of_era - day_of_era / 1460 +
+                               day_of_era / 36524 - day_of_era / 146096) /
+                              365;
+  const int32_t day_of_year =
+      day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  const int32_t shifted_month = (5 * day_of_year + 2) / 153;
+  const int32_t day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+  const int32_t month = shifted_month + (shifted_month < 10 ? 3 : -9);
+  const int32_t year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+
+  char date[32];
+  std::snprintf(date, sizeof(date), "%04d-%02d-%02d", year, month, day);
+  return date;
+}
+
+// Writes a widened and lengthened copy of the source file to the target file
+// and returns its size in bytes
+inline size_t WriteSyntheticFile(const std::string& source,
+                                 const std::string& target, size_t widen,
+                                 size_t lengthen) {
+  coviddata::CsvParser parser(source);
+  if (parser.Fail() || parser.GetLines().size() < 2)
+    throw std::invalid_argument("Could not read " + source);
+
+  const auto& lines = parser.GetLines();
+  std::ofstream output(target, std::ios::binary);
+
+  output << "date";
+  for (size_t copy = 0; copy < widen; copy++) {
+    for (size_t col = 1; col < lines.at(0).values.size(); col++)
+      output << ',' << lines.at(0).values.at(col) << " #" << copy;
+  }
+  output << '\n';
+
+  const int32_t first_day =
+      coviddata::DateAxis::ToDayNumber(lines.at(1).values.at(0));
+  const size_t num_source_rows = lines.size() - 1;
+  for (size_t block = 0; block < lengthen; block++) {
+    for (size_t row = 1; row < lines.size(); row++) {
+      const auto& values = lines.at(row).values;
+      const size_t day = block * num_source_rows + row - 1;
+
+      output << ToDate(first_day + static_cast<int32_t>(day));
+      for (size_t copy = 0; copy < widen; copy++) {
+        for (size_t col = 1; col < values.size(); col++)
+          output << ',' << values.at(col);
+      }
+      output << '\n';
+    }
+  }
+
+  return static_cast<size_t>(output.tellp());
+}
+
+}  // namespace benchmarks
+
+#endif  // FINALPROJECT_BENCHMARKS_SYNTHETICDATA_H
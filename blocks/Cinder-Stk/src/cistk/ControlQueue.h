@@ -0,0 +1,57 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be found in the LICENSE.txt file.
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Log.h"
+#include "cinder/audio/dsp/RingBuffer.h"
+
+#include "../stk/Stk.h"
+
+namespace cistk {
+
+//! A control change to an stk object that is made on the audio thread, at the start of a node's next process() call.
+struct ControlMessage {
+	enum class Type { NOTE_ON, NOTE_OFF, SET_FREQUENCY, CONTROL_CHANGE, CLEAR, RESET, SET_EFFECT_MIX };
+
+	Type			mType;
+	int				mNumber;	// control number of a CONTROL_CHANGE
+	stk::StkFloat	mValue;		// frequency, amplitude, control value or mix, depending on mType
+	stk::StkFloat	mAmplitude;	// amplitude of a NOTE_ON
+};
+
+//! Wait-free single-producer / single-consumer queue of ControlMessages. One non-audio thread pushes messages and the
+//! audio thread drains them, so stk state is only ever mutated by the thread that ticks it.
+class ControlQueue {
+  public:
+	static const size_t DEFAULT_CAPACITY = 256;
+
+	explicit ControlQueue( size_t capacity = DEFAULT_CAPACITY )
+		: mMessages( capacity )
+	{}
+
+	//! Queues \a message without blocking. If the audio thread has fallen behind and the queue is full, the message is dropped.
+	void push( ControlMessage::Type type, int number = 0, stk::StkFloat value = 0, stk::StkFloat amplitude = 0 )
+	{
+		const ControlMessage message = { type, number, value, amplitude };
+		if( ! mMessages.write( &message, 1 ) )
+			CI_LOG_W( "control queue full, dropping message" );
+	}
+
+	//! Calls \a apply with every message queued before the call, in order. Must only be called from the audio thread.
+	template <typename ApplyFn>
+	void drain( ApplyFn apply )
+	{
+		ControlMessage message;
+		for( size_t available = mMessages.getAvailableRead(); available > 0; available-- ) {
+			mMessages.read( &message, 1 );
+			apply( message );
+		}
+	}
+
+  private:
+	ci::audio::dsp::RingBufferT<ControlMessage>	mMessages;
+};
+
+} // namespace cistk
@@ -27,6 +27,14 @@ void EffectNode::initialize()
 // - should also try to optimize for those Effects that take a mono input and output stereo, no need to copy both channels for them
 void EffectNode::process( audio::Buffer *buffer )
 {
+	mControls.drain( [this]( const ControlMessage &message ) {
+		switch( message.mType ) {
+			case ControlMessage::Type::CLEAR:			mEffect->clear(); break;
+			case ControlMessage::Type::SET_EFFECT_MIX:	mEffect->setEffectMix( message.mValue ); break;
+			default:									break;
+		}
+	} );
+
 	const size_t numChannels = buffer->getNumChannels();
 	const size_t numFrames = buffer->getNumFrames();
 
@@ -7,6 +7,8 @@
 #include "cinder/Cinder.h"
 #include "cinder/audio/Node.h"
 
+#include "ControlQueue.h"
+
 #include "../stk/Stk.h"
 #include "../stk/Effect.h"
 
@@ -16,8 +18,15 @@ typedef std::shared_ptr<class EffectNode>			EffectNodeRef;
 
 //! Base class for GenNodes that wrap an stk::Instrmnt. By defautl InstrumentNodes are auto-enabled so you
 //! don't need to call enable(), instead you trigger them with stk::Instrmnt's noteOn() and noteOff methods.
+//!
+//! The controls below can be called from any one non-audio thread: they are queued and applied to the stk::Effect at
+//! the start of the next process() call.
 class EffectNode : public ci::audio::Node {
   public:
+	//! Reset and clear all internal state.
+	void clear()								{ mControls.push( ControlMessage::Type::CLEAR ); }
+	//! Set the mixture of input and "effected" levels in the output (0.0 = input only, 1.0 = effect only).
+	void setEffectMix( stk::StkFloat mix )		{ mControls.push( ControlMessage::Type::SET_EFFECT_MIX, 0, mix ); }
 
   protected:
 	EffectNode( stk::Effect *instrmnt, const ci::audio::Node::Format &format = Format() );
@@ -29,8 +38,9 @@ class EffectNode : public ci::audio::Node {
 	virtual void performTick( stk::StkFrames *frames ) = 0;
 
   private:
-	stk::Effect*	mEffect; // TODO: remove if not used (think it was copied from InstrumentNode
+	stk::Effect*	mEffect;
 	stk::StkFrames	mStkFrames;
+	ControlQueue	mControls;
 };
 
 } // namespace cistk
\ No newline at end of file
@@ -28,6 +28,10 @@ class ChorusNode : public EffectNode, public stk::Chorus {
 		: Chorus( baseDelay ), EffectNode( this, format )
 	{}
 
+	// controls are queued for the audio thread
+	using EffectNode::clear;
+	using EffectNode::setEffectMix;
+
   protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
 };
@@ -38,6 +42,10 @@ class EchoNode : public EffectNode, public stk::Echo {
 		: Echo( maximumDelay ), EffectNode( this, format )
 	{}
 
+	// controls are queued for the audio thread
+	using EffectNode::clear;
+	using EffectNode::setEffectMix;
+
   protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
 };
@@ -48,6 +56,10 @@ class FreeVerbNode : public EffectNode, public stk::FreeVerb {
 		: EffectNode( this, format )
 	{}
 
+	// controls are queued for the audio thread
+	using EffectNode::clear;
+	using EffectNode::setEffectMix;
+
   protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
 };
@@ -58,6 +70,10 @@ class JCRevNode : public EffectNode, public stk::JCRev {
 		: JCRev( T60 ), EffectNode( this, format )
 	{}
 
+	// controls are queued for the audio thread
+	using EffectNode::clear;
+	using EffectNode::setEffectMix;
+
   protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
 };
@@ -68,6 +84,10 @@ class NRevNode : public EffectNode, public stk::NRev {
 		: NRev( T60 ), EffectNode( this, format )
 	{}
 
+	// controls are queued for the audio thread
+	using EffectNode::clear;
+	using EffectNode::setEffectMix;
+
   protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
 };
@@ -78,6 +98,10 @@ class PRCRevNode : public EffectNode, public stk::PRCRev {
 		: PRCRev( T60 ), EffectNode( this, format )
 	{}
 
+	// controls are queued for the audio thread
+	using EffectNode::clear;
+	using EffectNode::setEffectMix;
+
   protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
 };
@@ -88,6 +112,10 @@ class PitShiftNode : public EffectNode, public stk::PitShift {
 		: EffectNode( this, format )
 	{}
 
+	// controls are queued for the audio thread
+	using EffectNode::clear;
+	using EffectNode::setEffectMix;
+
   protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
 };
@@ -98,6 +126,10 @@ class LentPitShiftNode : public EffectNode, public stk::LentPitShift {
 		: LentPitShift( periodRatio, tMax ), EffectNode( this, format )
 	{}
 
+	// controls are queued for the audio thread
+	using EffectNode::clear;
+	using EffectNode::setEffectMix;
+
   protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
 };
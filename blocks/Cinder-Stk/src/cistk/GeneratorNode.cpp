@@ -22,6 +22,8 @@ void GeneratorNode::initialize()
 
 void GeneratorNode::process( audio::Buffer *buffer )
 {
+	mControls.drain( [this]( const ControlMessage &message ) { performControl( message ); } );
+
 	mGenerator->tick( mStkFrames );
 	for( size_t ch = 0; ch < buffer->getNumChannels(); ch++ ) {
 		float *channel = buffer->getChannel( ch );
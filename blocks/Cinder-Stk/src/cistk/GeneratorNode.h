@@ -7,6 +7,8 @@
 #include "cinder/Cinder.h"
 #include "cinder/audio/InputNode.h"
 
+#include "ControlQueue.h"
+
 #include "../stk/Stk.h"
 #include "../stk/Generator.h"
 
@@ -16,8 +18,15 @@ typedef std::shared_ptr<class GeneratorNode>			GeneratorNodeRef;
 
 //! Base class for InputNode that wrap an stk::GeneratorNode. By defautl InstrumentNodes are auto-enabled so you
 //! don't need to call enable(), instead you trigger them with stk::Instrmnt's noteOn() and noteOff methods.
+//!
+//! The controls below can be called from any one non-audio thread: they are queued and handed to performControl() at
+//! the start of the next process() call. Generators without a control ignore it.
 class GeneratorNode : public ci::audio::InputNode {
   public:
+	//! Set the frequency of the generated signal, in hertz.
+	void setFrequency( stk::StkFloat frequency )	{ mControls.push( ControlMessage::Type::SET_FREQUENCY, 0, frequency ); }
+	//! Reset the generator to its initial state.
+	void reset()									{ mControls.push( ControlMessage::Type::RESET ); }
 
   protected:
 	GeneratorNode( stk::Generator *generator, const ci::audio::Node::Format &format = Format() );
@@ -27,10 +36,13 @@ class GeneratorNode : public ci::audio::InputNode {
 
 	//! Called by subclasses to copy frames to buffer
 	virtual void performTick( stk::StkFrames *frames ) = 0;
+	//! Called on the audio thread for every queued control, for subclasses to apply to their generator
+	virtual void performControl( const ControlMessage & /*message*/ )	{}
 
   private:
 	stk::Generator*	mGenerator;
 	stk::StkFrames	mStkFrames;
+	ControlQueue	mControls;
 };
 
 } // namespace cistk
@@ -17,8 +17,20 @@ public:
 		: GeneratorNode( this, format )
 	{}
 
+	// controls are queued for the audio thread
+	using GeneratorNode::setFrequency;
+	using GeneratorNode::reset;
+
 protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
+
+	void performControl( const ControlMessage &message ) override
+	{
+		if( message.mType == ControlMessage::Type::SET_FREQUENCY )
+			Blit::setFrequency( message.mValue );
+		else if( message.mType == ControlMessage::Type::RESET )
+			Blit::reset();
+	}
 };
 
 class GranulateNode : public GeneratorNode, public stk::Granulate {
@@ -59,8 +71,17 @@ public:
 		loadBuffer( *buffer );
 	}
 
+	// controls are queued for the audio thread
+	using GeneratorNode::reset;
+
 protected:
 	void performTick( stk::StkFrames *frames ) override	{ tick( *frames ); }
+
+	void performControl( const ControlMessage &message ) override
+	{
+		if( message.mType == ControlMessage::Type::RESET )
+			Granulate::reset();
+	}
 };
 
 // -------------------
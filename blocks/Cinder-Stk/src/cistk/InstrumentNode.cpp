@@ -20,8 +20,24 @@ void InstrumentNode::initialize()
 	mStkFrames.resize( getFramesPerBlock(), getNumChannels() );
 }
 
+void InstrumentNode::drainControlMessages()
+{
+	mControls.drain( [this]( const ControlMessage &message ) {
+		switch( message.mType ) {
+			case ControlMessage::Type::NOTE_ON:			mInstrument->noteOn( message.mValue, message.mAmplitude ); break;
+			case ControlMessage::Type::NOTE_OFF:		mInstrument->noteOff( message.mValue ); break;
+			case ControlMessage::Type::SET_FREQUENCY:	mInstrument->setFrequency( message.mValue ); break;
+			case ControlMessage::Type::CONTROL_CHANGE:	mInstrument->controlChange( message.mNumber, message.mValue ); break;
+			case ControlMessage::Type::CLEAR:			mInstrument->clear(); break;
+			default:									break;
+		}
+	} );
+}
+
 void InstrumentNode::process( audio::Buffer *buffer )
 {
+	drainControlMessages();
+
 	mInstrument->tick( mStkFrames );
 	for( size_t ch = 0; ch < buffer->getNumChannels(); ch++ ) {
 		float *channel = buffer->getChannel( ch );
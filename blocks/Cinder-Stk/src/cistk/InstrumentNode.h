@@ -7,6 +7,8 @@
 #include "cinder/Cinder.h"
 #include "cinder/audio/InputNode.h"
 
+#include "ControlQueue.h"
+
 #include "../stk/Stk.h"
 #include "../stk/Instrmnt.h"
 
@@ -16,18 +18,25 @@ typedef std::shared_ptr<class InstrumentNode>		InstrumentNodeRef;
 
 //! Base class for GenNodes that wrap an stk::Instrmnt. By defautl InstrumentNodes are auto-enabled so you
 //! don't need to call enable(), instead you trigger them with stk::Instrmnt's noteOn() and noteOff methods.
+//!
+//! The methods below can be called from any one non-audio thread: they are queued and applied to the stk::Instrmnt at
+//! the start of the next process() call, so the instrument is never mutated while it is being ticked.
 class InstrumentNode : public ci::audio::InputNode {
   public:
     //! Reset and clear all internal state (for subclasses).
-    void clear()													{ mInstrument->clear(); }
+    void clear()													{ mControls.push( ControlMessage::Type::CLEAR ); }
 	//! Start a note with the given frequency and amplitude.
-	void noteOn( stk::StkFloat frequency, stk::StkFloat amplitude )	{ mInstrument->noteOn( frequency, amplitude ); }
+	void noteOn( stk::StkFloat frequency, stk::StkFloat amplitude )	{ mControls.push( ControlMessage::Type::NOTE_ON, 0, frequency, amplitude ); }
 	//! Stop a note with the given amplitude (speed of decay).
-	void noteOff( stk::StkFloat amplitude )							{ mInstrument->noteOff( amplitude ); }
+	void noteOff( stk::StkFloat amplitude )							{ mControls.push( ControlMessage::Type::NOTE_OFF, 0, amplitude ); }
 	//! Set instrument parameters for a particular frequency.
-	void setFrequency( stk::StkFloat frequency )					{ mInstrument->setFrequency( frequency ); }
+	void setFrequency( stk::StkFloat frequency )					{ mControls.push( ControlMessage::Type::SET_FREQUENCY, 0, frequency ); }
 	//! Perform the control change specified by \e number and \e value (0.0 - 128.0).
-	void controlChange( int number, stk::StkFloat value )			{ mInstrument->controlChange( number, value ); }
+	void controlChange( int number, stk::StkFloat value )			{ mControls.push( ControlMessage::Type::CONTROL_CHANGE, number, value ); }
+
+	//! Applies the queued control messages to the instrument. Called by process(); nodes that tick this instrument
+	//! themselves instead of connecting it must call it from their own process().
+	void drainControlMessages();
 
   protected:
 	InstrumentNode( stk::Instrmnt *instrmnt, const ci::audio::Node::Format &format = Format() );
@@ -38,6 +47,7 @@ class InstrumentNode : public ci::audio::InputNode {
   private:
 	stk::Instrmnt*	mInstrument;
 	stk::StkFrames	mStkFrames;
+	ControlQueue	mControls;
 };
 
 } // namespace cistk
\ No newline at end of file
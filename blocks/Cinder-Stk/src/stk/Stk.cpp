@@ -52,6 +52,7 @@
 
 #include "Stk.h"
 #include <stdlib.h>
+#include <mutex>
 
 namespace stk {
 
@@ -66,7 +67,11 @@ const Stk::StkFormat Stk :: STK_FLOAT64 = 0x20;
 bool Stk :: showWarnings_ = true;
 bool Stk :: printErrors_ = true;
 std::vector<Stk *> Stk :: alertList_;
-std::ostringstream Stk :: oStream_;
+thread_local std::ostringstream Stk :: oStream_;
+
+// Guards alertList_, so objects can be created and destroyed on several
+// threads at once.  The sample rate itself must not change while they run.
+static std::mutex alertListMutex;
 
 Stk :: Stk( void )
   : ignoreSampleRateChange_(false)
@@ -83,6 +88,7 @@ void Stk :: setSampleRate( StkFloat rate )
     StkFloat oldRate = srate_;
     srate_ = rate;
 
+    std::lock_guard<std::mutex> lock( alertListMutex );
     for ( unsigned int i=0; i<alertList_.size(); i++ )
       alertList_[i]->sampleRateChanged( srate_, oldRate );
   }
@@ -97,6 +103,7 @@ void Stk :: sampleRateChanged( StkFloat /*newRate*/, StkFloat /*oldRate*/ )
 
 void Stk :: addSampleRateAlert( Stk *ptr )
 {
+  std::lock_guard<std::mutex> lock( alertListMutex );
   for ( unsigned int i=0; i<alertList_.size(); i++ )
     if ( alertList_[i] == ptr ) return;
 
@@ -105,6 +112,7 @@ void Stk :: addSampleRateAlert( Stk *ptr )
 
 void Stk :: removeSampleRateAlert( Stk *ptr )
 {
+  std::lock_guard<std::mutex> lock( alertListMutex );
   for ( unsigned int i=0; i<alertList_.size(); i++ ) {
     if ( alertList_[i] == ptr ) {
       alertList_.erase( alertList_.begin() + i );
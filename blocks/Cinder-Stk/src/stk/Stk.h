@@ -218,7 +218,8 @@ private:
 
 protected:
 
-  static std::ostringstream oStream_;
+  // Per thread, so objects on different threads can report errors at once
+  static thread_local std::ostringstream oStream_;
   bool ignoreSampleRateChange_;
 
   //! Default constructor.
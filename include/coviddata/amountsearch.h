@@ -0,0 +1,29 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_AMOUNTSEARCH_H
+#define FINALPROJECT_AMOUNTSEARCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "span.h"
+
+namespace coviddata {
+
+/*
+ * Searches over a contiguous run of amounts, such as every region's amount
+ * on one date (see DataSet::GetAmountsAtIndex).
+ *
+ * Null amounts (see IsNullAmount) are never found. Amounts are compared 8
+ * (AVX2) or 4 (SSE2) at a time where the compiler targets those instruction
+ * sets.
+ */
+
+float FindMaxAmount(Span<const float> amounts);
+size_t FindMaxAmountIndex(Span<const float> amounts);
+void FindTopAmounts(Span<const float> amounts, size_t count,
+                    std::vector<size_t>& indices);
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_AMOUNTSEARCH_H
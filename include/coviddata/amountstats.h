@@ -0,0 +1,40 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_AMOUNTSTATS_H
+#define FINALPROJECT_AMOUNTSTATS_H
+
+#include <cstddef>
+
+namespace coviddata {
+
+const int kNullAmount = -1;
+
+bool IsNullAmount(float amount);
+
+/**
+ * Running statistics (max, min, sum and count) over the non-null amounts of
+ * a region or dataset.
+ *
+ * Amounts can be added one at a time and statistics of disjoint sets of
+ * amounts can be merged, so they are cheap to keep up to date as data grows.
+ */
+class AmountStats {
+ public:
+  AmountStats();
+  void Add(float amount);
+  void Merge(const AmountStats& other);
+  float GetMax() const;
+  float GetMin() const;
+  double GetSum() const;
+  size_t GetCount() const;
+
+ private:
+  float max_;
+  float min_;
+  double sum_;
+  size_t count_;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_AMOUNTSTATS_H
@@ -0,0 +1,75 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_COMPRESSEDCOLUMN_H
+#define FINALPROJECT_COMPRESSEDCOLUMN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "amountstats.h"
+#include "span.h"
+
+namespace coviddata {
+
+/**
+ * Read-only, losslessly compressed column of amounts.
+ *
+ * Amounts are split into blocks of kBlockSize. A block of whole numbers is
+ * stored either as bit-packed offsets from its minimum (frame of reference)
+ * or as bit-packed differences between neighbouring amounts (delta), which
+ * suits cumulative series; other blocks keep their raw float bits. Each block
+ * also records the statistics of its amounts, so ranges can be bounded
+ * without decoding them.
+ *
+ * Whole blocks decode sequentially with DecodeBlock(); single amounts are
+ * available by index with At().
+ *
+ * This is a standalone utility: DataSet keeps every region column as plain
+ * floats, since regions, views and the sonifier read them as contiguous
+ * spans, so importing a dataset saves no memory by itself. Callers that hold
+ * columns for long (ex. a cache of many datasets) can pack them with it;
+ * columns the Schema types as integer are the ones that pack well.
+ */
+class CompressedColumn {
+ public:
+  static const size_t kBlockSize = 128;
+
+  CompressedColumn();
+  explicit CompressedColumn(Span<const float> amounts);
+  size_t Size() const;
+  float At(size_t index) const;
+  size_t GetNumBlocks() const;
+  size_t DecodeBlock(size_t block_index, float* amounts) const;
+  void Decode(std::vector<float>& amounts) const;
+  const AmountStats& GetBlockStats(size_t block_index) const;
+  size_t GetMemoryUsage() const;
+
+ private:
+  enum class Encoding : uint8_t { kFrameOfReference, kDelta, kRaw };
+
+  /**
+   * Where a block's packed values start and how to turn them into amounts
+   */
+  struct Block {
+    uint64_t bit_offset;
+    int64_t reference;
+    uint8_t bit_width;
+    Encoding encoding;
+    AmountStats stats;
+  };
+
+  void EncodeBlock(Span<const float> amounts);
+  void AppendBits(uint64_t value, uint8_t bit_width);
+  uint64_t ReadBits(uint64_t bit_offset, uint8_t bit_width) const;
+  float DecodeValue(const Block& block, uint64_t packed) const;
+
+  std::vector<Block> blocks_;
+  std::vector<uint64_t> words_;
+  uint64_t num_bits_;
+  size_t size_;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_COMPRESSEDCOLUMN_H
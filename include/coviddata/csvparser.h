@@ -5,13 +5,38 @@
 #ifndef FINALPROJECT_CSVPARSER_H
 #define FINALPROJECT_CSVPARSER_H
 
+#include <fstream>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "decompressingreader.h"
+#include "mappedfile.h"
+#include "span.h"
+
 namespace coviddata {
 
 /**
  * Reads and stores values from CSV files
+ *
+ * In buffered mode (the default) every line is split and copied into
+ * GetLines(). In memory-mapped mode nothing is copied: rows are read one at a
+ * time with ReadRow(), whose fields point straight into the mapped file. In
+ * streaming mode rows are read one line at a time from disk, so only a single
+ * row is ever held in memory. A parser can also read rows straight out of a
+ * buffer the caller already holds (ex. one chunk of a larger mapped file).
+ *
+ * Compressed files (.csv.gz, .csv.zst) are always streamed, whatever mode is
+ * asked for: a DecompressingReader inflates them block by block on another
+ * thread while rows are split out of the blocks it has already produced.
+ *
+ * ForEachRow() pushes every remaining row to a callback in any mode.
+ *
+ * Rows are tokenized following RFC 4180: quoted fields may hold commas,
+ * newlines and escaped quotes (""), lines may end with \r\n, and a UTF-8 byte
+ * order mark before the header is dropped. Rows without quotes take a fast
+ * path that splits on every comma in one vectorized scan.
  */
 class CsvParser {
  public:
@@ -22,14 +47,51 @@ class CsvParser {
     std::vector<std::string> values{};
   };
 
-  CsvParser(const std::string& filename);
+  /**
+   * View of a single field. Valid for as long as the parser is alive, except
+   * in streaming mode, and for quoted fields with escaped quotes, where it is
+   * only valid until the next row is read.
+   */
+  using Field = Span<const char>;
+  using Row = Span<const Field>;
+  using RowCallback = std::function<void(size_t row_index, Row row)>;
+
+  enum class ReadMode { kBuffered, kMemoryMapped, kStreaming, kInMemory };
+
+  CsvParser(const std::string& filename,
+            ReadMode mode = ReadMode::kBuffered);
+  explicit CsvParser(Span<const char> buffer);
   std::vector<Line>& GetLines();
+  bool ReadRow(std::vector<Field>& fields);
+  void ForEachRow(const RowCallback& callback);
+  void Rewind();
   bool Fail() const;
+  static std::string ToString(const Field& field);
+  static const char* FindRowEnd(const char* begin, const char* end);
 
  private:
   std::vector<Line> lines_{};
-  static std::vector<std::string> SplitStr(const std::string& s,
-                                           const std::string& delimiter);
+  static bool HasOpenQuote(const char* begin, const char* end);
+  void SplitFields(const char* begin, const char* end,
+                   std::vector<Field>& fields);
+  void SplitQuotedFields(const char* begin, const char* end,
+                         std::vector<Field>& fields);
+  bool ReadStreamedRow(std::vector<Field>& fields);
+  bool ReadDecompressedRow(std::vector<Field>& fields);
+  void SplitLine(const char* begin, const char* end,
+                 std::vector<Field>& fields);
+  ReadMode mode_;
+  MappedFile mapped_file_;
+  Span<const char> buffer_;
+  std::ifstream stream_;
+  std::string stream_line_;
+  std::string filename_;
+  std::unique_ptr<DecompressingReader> reader_;
+  std::string block_;
+  std::vector<size_t> delimiter_positions_;
+  std::string scratch_;
+  size_t cursor_;
+  size_t row_index_;
   bool fail_;
 };
 
@@ -6,15 +6,25 @@
 #define FINALPROJECT_DATASET_H
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
+#include "amountstats.h"
 #include "csvparser.h"
+#include "dateaxis.h"
+#include "mappedfile.h"
 #include "regiondata.h"
+#include "rollingkernels.h"
+#include "schema.h"
 
 namespace coviddata {
 
-const int kNullAmount = -1;
+// Region holding the global totals of a dataset
+const char kWorldRegion[] = "World";
 
 /**
  * Represents global and country-specific data for COVID-19.
@@ -24,24 +34,145 @@ const int kNullAmount = -1;
  *   2020-05-06,100,0,2
  *   ...
  * and stores those values by region for ease of retrieval.
+ *
+ * Storage is columnar: every region is identified by an integer region id
+ * (its position among the unique regions of the header) and holds one
+ * contiguous column of amounts along a date axis shared by the whole dataset.
+ *
+ * Large files can be imported on several threads (see SetImportThreadCount).
+ * A dataset can also be saved as a binary snapshot (see snapshot.h), which
+ * loads by mapping the file and reading amounts in place without parsing.
+ *
+ * Statistics of every region, and of the whole dataset with and without the
+ * "World" region, are computed once while importing.
+ *
+ * A Schema describing the metric, its units and the type of every column is
+ * inferred while importing, from the filename, the header and a sample of
+ * rows.
+ *
+ * Rows appended to an imported file can be picked up with RefreshData(),
+ * which parses only the new rows and extends the region columns in place. A
+ * last line without a newline that is missing columns is taken to be still
+ * being written, and is left for a later refresh.
+ *
+ * With lazy loading (see SetLazyLoading) an import only indexes the rows of
+ * the file; each region's column is parsed the first time it is retrieved,
+ * and dataset statistics the first time they are retrieved.
+ *
+ * Rolling analytics of a region (see RollingKernel) can be retrieved as
+ * derived regions. Results are cached per region, kernel and window; when
+ * RefreshData() appends days only the results of the new days are computed.
+ *
+ * Every region's amount on one date can be retrieved as a contiguous row
+ * (see GetAmountsAtIndex), read from a transposed copy of the columns that is
+ * built the first time a row is retrieved.
+ *
+ * Compressed .csv.gz and .csv.zst files are streamed through a
+ * DecompressingReader and parsed as they are decompressed; they can only be
+ * read front to back, so they are always imported eagerly on one thread and
+ * cannot be refreshed.
  */
 class DataSet {
  public:
   DataSet();
   void ImportData(const std::string& filename);
-  size_t Size();
+  size_t RefreshData();
+  void SaveSnapshot(const std::string& filename) const;
+  void LoadSnapshot(const std::string& filename);
+  size_t Size() const;
   coviddata::RegionData& GetRegionDataByName(
       const std::string& region_name) const;
+  coviddata::RegionData& GetRegionDataById(size_t region_id) const;
+  size_t GetRegionId(const std::string& region_name) const;
   std::vector<std::string>& GetRegions() const;
+  const coviddata::DateAxis& GetDateAxis() const;
+  const coviddata::AmountStats& GetStats(bool include_world = true) const;
+  Span<const float> GetAmountsAtIndex(size_t date_index) const;
+  const coviddata::Schema& GetSchema() const;
+  coviddata::RegionData GetDerivedRegionData(size_t region_id,
+                                             RollingKernel kernel,
+                                             size_t window) const;
+  void SetImportThreadCount(size_t num_threads);
+  size_t GetImportThreadCount() const;
+  void SetLazyLoading(bool lazy_loading);
+  bool IsLazyLoading() const;
+  bool IsRegionLoaded(size_t region_id) const;
   void Reset();
-  bool Empty();
+  bool Empty() const;
  private:
-  std::map<std::string, coviddata::RegionData> region_to_data_;
+  // Builds datasets from long-format files through the same members
+  friend class LongFormatImporter;
+
+  std::vector<coviddata::RegionData> region_data_;
+  std::unordered_map<std::string, size_t> region_to_id_;
   std::vector<std::string> regions_;
+  std::shared_ptr<coviddata::DateAxis> date_axis_;
   std::string data_type_;
+  size_t import_thread_count_;
+  coviddata::AmountStats stats_;
+  coviddata::AmountStats stats_excluding_world_;
+  coviddata::Schema schema_;
+  std::string imported_header_;
+  size_t imported_bytes_;
+  bool lazy_loading_;
+  // Lazily loaded file, where each row starts, its date index, and which
+  // regions have been parsed so far
+  std::shared_ptr<coviddata::MappedFile> lazy_file_;
+  std::vector<size_t> row_offsets_;
+  std::vector<size_t> row_date_indices_;
+  std::vector<std::vector<size_t>> region_columns_;
+  mutable std::vector<bool> loaded_regions_;
+  mutable bool lazy_stats_loaded_;
+  mutable std::mutex lazy_mutex_;
  private:
-  void InitializeRegionalData(coviddata::CsvParser::Line header);
-  static float GetNumberFromString(const std::string& num_string);
+  /**
+   * Cached results of a rolling kernel over one region, and how many of its
+   * days are up to date. Results are replaced rather than modified, so
+   * regions already borrowing them stay valid.
+   */
+  struct DerivedSeries {
+    std::shared_ptr<const std::vector<float>> results;
+    size_t num_valid_days;
+  };
+  using DerivedSeriesKey = std::tuple<size_t, RollingKernel, size_t>;
+
+  mutable std::map<DerivedSeriesKey, DerivedSeries> derived_series_;
+  mutable std::mutex derived_mutex_;
+  // Amounts transposed into one row of every region per date index
+  mutable std::vector<float> date_rows_;
+  mutable bool date_rows_built_;
+  mutable std::mutex date_rows_mutex_;
+ private:
+  /**
+   * Rows of one chunk of a file parsed during a parallel import
+   */
+  struct ParsedChunk {
+    std::vector<std::string> dates;
+    std::vector<size_t> date_indices;
+    std::vector<float> amounts;  // row-major, one amount per header column
+  };
+
+  void ImportDataInParallel(const std::string& filename);
+  void ImportDataLazily(const std::string& filename);
+  void ImportCompressedData(const std::string& filename);
+  void ImportRows(coviddata::CsvParser& parser);
+  void LoadRegion(size_t region_id) const;
+  void LoadAllRegions() const;
+  void FinishImport();
+  void MergeRegionStats();
+  void BuildDateRows() const;
+  void RememberImportedText(const char* file_begin, const char* file_end);
+  void SampleSchemaRows(const char* rows_begin, const char* rows_end);
+  void InferSchemaFromAmounts(const std::string& metric);
+  std::vector<size_t> MapColumnsToIds() const;
+  static const char* FindLineEnd(const char* position, const char* end);
+  static const char* FindCompleteRowsEnd(const char* file_begin,
+                                         const char* file_end);
+  void InitializeRegionalData(coviddata::CsvParser::Row header);
+  void AddRegionColumn(const std::string& region_name, size_t region_index);
+  void ImportRow(coviddata::CsvParser::Row row,
+                 const std::vector<size_t>& column_to_id);
+  static float GetNumberFromString(const coviddata::CsvParser::Field& field);
 };
 
 } // namespace coviddata
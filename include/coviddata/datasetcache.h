@@ -0,0 +1,54 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_DATASETCACHE_H
+#define FINALPROJECT_DATASETCACHE_H
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dataset.h"
+#include "threadpool.h"
+
+namespace coviddata {
+
+/**
+ * Loads datasets in the background and keeps them resident by filename.
+ *
+ * Preload() starts importing files on a thread pool and returns immediately.
+ * Once a file has loaded, Get() hands out the same DataSet without any
+ * further work, so switching between cached datasets is constant time.
+ *
+ * The metrics of a long-format file are loaded together in one pass and
+ * cached under keys made by GetMetricKey().
+ */
+class DataSetCache {
+ public:
+  explicit DataSetCache(size_t num_threads = 0);
+  void Preload(const std::vector<std::string>& filenames);
+  void Preload(const std::string& filename);
+  void PreloadLongFormat(const std::string& filename,
+                         const std::vector<std::string>& metrics);
+  static std::string GetMetricKey(const std::string& filename,
+                                  const std::string& metric);
+  bool IsLoaded(const std::string& filename) const;
+  std::shared_ptr<DataSet> Get(const std::string& filename);
+  std::shared_ptr<DataSet> Wait(const std::string& filename);
+
+ private:
+  using LoadResult = std::shared_future<std::shared_ptr<DataSet>>;
+  using LoadPromise = std::promise<std::shared_ptr<DataSet>>;
+
+  LoadResult FindOrLoad(const std::string& filename);
+
+  ThreadPool pool_;
+  std::unordered_map<std::string, LoadResult> filename_to_result_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_DATASETCACHE_H
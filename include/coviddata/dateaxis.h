@@ -0,0 +1,50 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_DATEAXIS_H
+#define FINALPROJECT_DATEAXIS_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace coviddata {
+
+/**
+ * Ordered list of dates shared by every region of a dataset.
+ *
+ * Each date is stored once and identified by its position (date index) in
+ * the order it was first seen, so regions only need to store one amount per
+ * date index.
+ *
+ * Dates in [year]-[month]-[day] format are also packed into day numbers
+ * (days since 1970-01-01). While the axis holds consecutive days, looking up
+ * a date's index is plain arithmetic on its day number.
+ */
+class DateAxis {
+ public:
+  static const int32_t kInvalidDay;
+
+  DateAxis();
+  size_t Intern(const std::string& date);
+  size_t IndexOf(const std::string& date) const;
+  size_t IndexOfDay(int32_t day_number) const;
+  bool Contains(const std::string& date) const;
+  const std::string& GetDate(size_t date_index) const;
+  int32_t GetDayNumber(size_t date_index) const;
+  const std::vector<std::string>& GetDates() const;
+  size_t Size() const;
+  bool IsConsecutive() const;
+  void Clear();
+  static int32_t ToDayNumber(const std::string& date);
+
+ private:
+  std::vector<std::string> dates_;
+  std::vector<int32_t> day_numbers_;
+  std::unordered_map<std::string, size_t> date_to_index_;
+  bool is_consecutive_;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_DATEAXIS_H
@@ -0,0 +1,76 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_DECOMPRESSINGREADER_H
+#define FINALPROJECT_DECOMPRESSINGREADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+
+namespace coviddata {
+
+/**
+ * Streams the decompressed contents of a file in blocks.
+ *
+ * A producer thread reads and decompresses the file into blocks of about
+ * block_size bytes and hands them over through a bounded queue, so the
+ * consumer (usually CsvParser) parses one block while the next is being
+ * decompressed, and at most max_queued_blocks are held in memory at once.
+ *
+ * Gzip (.gz) files are supported when built with COVIDDATA_HAVE_ZLIB and
+ * zstd (.zst) files when built with COVIDDATA_HAVE_ZSTD. Uncompressed files
+ * are passed through as they are.
+ */
+class DecompressingReader {
+ public:
+  enum class Compression { kNone, kGzip, kZstd };
+
+  static const size_t kDefaultBlockSize = 64 * 1024;
+  static const size_t kDefaultMaxQueuedBlocks = 4;
+
+  explicit DecompressingReader(
+      const std::string& filename, size_t block_size = kDefaultBlockSize,
+      size_t max_queued_blocks = kDefaultMaxQueuedBlocks);
+  ~DecompressingReader();
+
+  DecompressingReader(const DecompressingReader&) = delete;
+  DecompressingReader& operator=(const DecompressingReader&) = delete;
+
+  bool ReadBlock(std::string& block);
+  bool Fail() const;
+  static Compression DetectCompression(const std::string& filename);
+  static bool IsSupported(Compression compression);
+
+ private:
+  void RunProducer();
+  void CopyBlocks();
+  void InflateGzipBlocks();
+  void DecompressZstdBlocks();
+  bool PushBlock(std::string& block);
+
+  std::ifstream file_;
+  Compression compression_;
+  size_t block_size_;
+  size_t max_queued_blocks_;
+  bool fail_;
+
+  std::queue<std::string> blocks_;
+  std::mutex mutex_;
+  std::condition_variable block_pushed_;
+  std::condition_variable block_popped_;
+  bool finished_;
+  // Written under the mutex, but also checked by the producer outside it
+  std::atomic<bool> stopping_;
+  std::exception_ptr error_;
+  std::thread producer_;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_DECOMPRESSINGREADER_H
@@ -0,0 +1,57 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_LONGFORMATIMPORTER_H
+#define FINALPROJECT_LONGFORMATIMPORTER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dataset.h"
+
+namespace coviddata {
+
+/**
+ * Imports a long-format .csv file (such as OWID's owid-covid-data.csv) into
+ * one DataSet per metric.
+ *
+ * A long-format file has one row per location and date, with a column per
+ * metric:
+ *   iso_code,location,date,total_cases,new_cases,... (header)
+ *   AFG,Afghanistan,2020-05-06,100,5,...
+ *   ...
+ * Every requested metric is pivoted into the same region/date layout that
+ * DataSet::ImportData produces for wide files, all in a single pass over the
+ * file. Dates are ordered chronologically and regions by first appearance.
+ */
+class LongFormatImporter {
+ public:
+  explicit LongFormatImporter(const std::vector<std::string>& metrics);
+  void ImportData(const std::string& filename);
+  const std::vector<std::string>& GetMetrics() const;
+  std::shared_ptr<DataSet> GetDataSet(const std::string& metric) const;
+
+ private:
+  /**
+   * Amounts of one metric gathered while reading the file, one column per
+   * region indexed by the order in which dates first appeared
+   */
+  struct MetricColumns {
+    size_t column_index;
+    std::vector<std::vector<float>> region_columns;
+  };
+
+  std::shared_ptr<DataSet> BuildDataSet(
+      const std::string& filename, const std::string& metric,
+      const MetricColumns& metric_columns,
+      const std::vector<std::string>& regions, const DateAxis& date_slots,
+      const std::vector<size_t>& slot_order) const;
+
+  std::vector<std::string> metrics_;
+  std::unordered_map<std::string, std::shared_ptr<DataSet>> data_sets_;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_LONGFORMATIMPORTER_H
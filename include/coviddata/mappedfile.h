@@ -0,0 +1,42 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_MAPPEDFILE_H
+#define FINALPROJECT_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace coviddata {
+
+/**
+ * Read-only memory mapping of an entire file.
+ *
+ * The mapping is released when the object is destroyed, so any pointers into
+ * Data() must not outlive it.
+ */
+class MappedFile {
+ public:
+  MappedFile();
+  explicit MappedFile(const std::string& filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  const char* Data() const;
+  size_t Size() const;
+  bool Fail() const;
+
+ private:
+  void Unmap();
+
+  const char* data_;
+  size_t size_;
+  bool fail_;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_MAPPEDFILE_H
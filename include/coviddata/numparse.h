@@ -0,0 +1,25 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_NUMPARSE_H
+#define FINALPROJECT_NUMPARSE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace coviddata {
+
+/*
+ * Allocation-free helpers for turning CSV rows into numbers.
+ *
+ * ParseFloat matches `std::stringstream >> float` in the "C" locale and only
+ * falls back to a stream for input it cannot round exactly on its own.
+ * FindDelimiters scans a whole row at once using SSE2/AVX2 where available.
+ */
+
+float ParseFloat(const char* begin, const char* end);
+void FindDelimiters(const char* begin, const char* end, char delimiter,
+                    std::vector<size_t>& positions);
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_NUMPARSE_H
@@ -5,31 +5,65 @@
 #ifndef FINALPROJECT_REGIONDATA_H
 #define FINALPROJECT_REGIONDATA_H
 
-#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "amountstats.h"
+#include "dateaxis.h"
+#include "span.h"
+
 namespace coviddata {
 
 /**
  * Holds COVID-19 data for a specific region by assigning dates in format
  * [year]-[month]-[date] (ex. 2020-05-05) to an amount (float).
+ *
+ * Amounts are stored contiguously by date index. Regions of the same dataset
+ * share a single DateAxis; a standalone region creates its own.
+ *
+ * A region can also borrow its amounts from memory it does not own (such as a
+ * mapped snapshot file), kept alive by a shared handle. Borrowed amounts are
+ * copied the first time the region is modified.
+ *
+ * Statistics of the amounts are kept up to date as they are stored, so
+ * GetStats() never scans the amounts.
  */
 class RegionData {
  public:
   RegionData();
   RegionData(const std::string& region_name, size_t region_index);
+  RegionData(const std::string& region_name, size_t region_index,
+             std::shared_ptr<DateAxis> date_axis);
   void SetAmountToDate(const std::string& date, float amount);
+  void SetAmountAtIndex(size_t date_index, float amount);
+  void Resize(size_t num_dates);
+  void BorrowAmounts(Span<const float> amounts,
+                     std::shared_ptr<const void> owner);
+  bool IsBorrowed() const;
   float GetAmountAtDate(const std::string& date) const;
+  float GetAmountAtIndex(size_t date_index) const;
+  Span<const float> GetAmounts() const;
+  const AmountStats& GetStats() const;
   std::string GetRegionName() const;
-  std::vector<std::string> GetDates() const;
+  const std::vector<std::string>& GetDates() const;
+  const DateAxis& GetDateAxis() const;
   size_t GetRegionIndex() const;
   size_t Size() const;
 
  private:
   std::string region_name_;
   size_t region_index_;
-  std::map<std::string, float> date_to_amount_;
+  std::shared_ptr<DateAxis> date_axis_;
+  std::vector<float> amounts_;
+  Span<const float> borrowed_amounts_;
+  std::shared_ptr<const void> borrowed_owner_;
+  AmountStats stats_;
+
+ private:
+  Span<const float> Amounts() const;
+  void CopyBorrowedAmounts();
+  void RecomputeStats();
 };
 
 }  // namespace coviddata
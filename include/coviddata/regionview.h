@@ -0,0 +1,103 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_REGIONVIEW_H
+#define FINALPROJECT_REGIONVIEW_H
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+
+#include "amountstats.h"
+#include "dateaxis.h"
+#include "regiondata.h"
+#include "span.h"
+
+namespace coviddata {
+
+/**
+ * How a downsampled view combines the amounts of each bucket of dates.
+ * Null amounts are skipped; a bucket with only null amounts is null.
+ */
+enum class Aggregation { kSum, kMean, kMax };
+
+/**
+ * Read-only view over a region's column of amounts: a range of dates, every
+ * Nth date, and/or buckets of N dates combined into one amount (ex. weekly
+ * totals).
+ *
+ * Views never copy amounts. Each entry is computed from the column when it
+ * is read, so building a view is constant time whatever the length of the
+ * series. Views compose (ex. the weekly totals of the last 90 days) and point
+ * into the region's memory, which must outlive them and not be modified.
+ */
+class RegionView {
+ public:
+  /**
+   * Iterates over the entries of a view, computing each as it is read
+   */
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = float;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const float*;
+    using reference = float;
+
+    Iterator(const RegionView* view, size_t index)
+        : view_(view), index_(index) {}
+
+    float operator*() const { return (*view_)[index_]; }
+    Iterator& operator++() {
+      index_++;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator previous = *this;
+      index_++;
+      return previous;
+    }
+    bool operator==(const Iterator& other) const {
+      return index_ == other.index_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return index_ != other.index_;
+    }
+
+   private:
+    const RegionView* view_;
+    size_t index_;
+  };
+
+  RegionView();
+  explicit RegionView(const RegionData& region_data);
+  RegionView Range(size_t first, size_t last) const;
+  RegionView Last(size_t num_entries) const;
+  RegionView Stride(size_t stride) const;
+  RegionView Downsample(size_t bucket_size, Aggregation aggregation) const;
+  size_t Size() const;
+  bool Empty() const;
+  float At(size_t index) const;
+  float operator[](size_t index) const;
+  size_t GetDateIndex(size_t index) const;
+  const std::string& GetDate(size_t index) const;
+  AmountStats GetStats() const;
+  Iterator begin() const;
+  Iterator end() const;
+
+ private:
+  Span<const float> amounts_;
+  const DateAxis* date_axis_;
+  // Entry i starts at amount first_ + i * step_ and combines bucket_size_
+  // amounts spacing_ apart, stopping at limit_
+  size_t first_;
+  size_t size_;
+  size_t step_;
+  size_t spacing_;
+  size_t bucket_size_;
+  size_t limit_;
+  Aggregation aggregation_;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_REGIONVIEW_H
@@ -0,0 +1,43 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_ROLLINGKERNELS_H
+#define FINALPROJECT_ROLLINGKERNELS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "span.h"
+
+namespace coviddata {
+
+/**
+ * Analytics computed over a trailing window of days of a region's amounts:
+ *   - kMovingAverage: mean of the non-null amounts of the last N days
+ *   - kGrowthRate: average daily growth over the last N days, in percent
+ *     (N = 1 is day-over-day growth)
+ *   - kDoublingTime: days for the amount to double at the growth of the last
+ *     N days; only defined while the amount grows
+ *   - kZScore: standard deviations of an amount from the mean of the last N
+ *     days (itself included)
+ */
+enum class RollingKernel { kMovingAverage, kGrowthRate, kDoublingTime, kZScore };
+
+/*
+ * Single-pass kernels over a column of amounts.
+ *
+ * Each result depends only on the amounts of its own and earlier days, so
+ * when days are appended to a column only the new results are computed:
+ * results before `first` are kept as they are. Results that are undefined
+ * (ex. growth from a null or zero amount) are NaN, which IsNullAmount()
+ * treats as null like every other missing amount. Defined results are never
+ * null: one that would equal kNullAmount exactly (ex. a 1% drop) is stored as
+ * the nearest float above it.
+ */
+
+void ComputeRollingKernel(RollingKernel kernel, size_t window,
+                          Span<const float> amounts, size_t first,
+                          std::vector<float>& results);
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_ROLLINGKERNELS_H
@@ -0,0 +1,75 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_SCHEMA_H
+#define FINALPROJECT_SCHEMA_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "csvparser.h"
+
+namespace coviddata {
+
+/**
+ * Kind of values found in a column. kUnknown means every sampled value was
+ * missing.
+ */
+enum class ColumnType { kUnknown, kDate, kInteger, kFractional, kText };
+
+/**
+ * Metadata of a single column of a dataset
+ */
+struct ColumnSchema {
+  std::string name;    // as written in the header
+  std::string region;  // name without its unit suffix
+  std::string unit;    // suffix after " - ", ex. "tests performed"
+  ColumnType type;
+};
+
+/**
+ * Typed metadata of a dataset, inferred from its metric name, its header and
+ * a sample of its rows.
+ *
+ * The metric name (the filename of a wide export, or an OWID metric such as
+ * "total_cases_per_million") gives the quantity being counted and whether
+ * it is scaled per capita. Header names give each column's region and unit
+ * ("Argentina - tests performed"). Sampled values give each column's type.
+ *
+ * Columns are indexed as in the header, so column 0 is the date and a
+ * region's column is RegionData::GetRegionIndex().
+ */
+class Schema {
+ public:
+  static const size_t kSampleRows = 32;
+
+  Schema();
+  Schema(const std::string& metric, const std::string& date_column,
+         const std::vector<std::string>& value_columns);
+  void AddSampleRow(CsvParser::Row row);
+  void AddSampleAmount(size_t column, float amount);
+  size_t Size() const;
+  const ColumnSchema& GetColumn(size_t column) const;
+  const std::string& GetMetric() const;
+  const std::string& GetQuantity() const;
+  double GetPerCapitaScale() const;
+  bool IsPerCapita() const;
+  ColumnType GetValueType() const;
+  std::string GetUnitLabel(size_t column) const;
+  static std::string GetMetricName(const std::string& filename);
+
+ private:
+  std::vector<ColumnSchema> columns_;
+  std::string metric_;
+  std::string quantity_;
+  std::string per_capita_;
+  double per_capita_scale_;
+
+ private:
+  static ColumnType ClassifyField(CsvParser::Field field);
+  static ColumnType MergeTypes(ColumnType seen, ColumnType sample);
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_SCHEMA_H
@@ -0,0 +1,48 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_SNAPSHOT_H
+#define FINALPROJECT_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace coviddata {
+
+/**
+ * Layout of a binary DataSet snapshot (see DataSet::SaveSnapshot).
+ *
+ * A snapshot is a SnapshotHeader followed by four sections at the offsets it
+ * records:
+ *   - region-name table: num_columns strings, one per header column
+ *   - date axis: num_dates strings in date index order
+ *   - payload: num_regions * num_dates float32 amounts, one contiguous column
+ *     per region id, aligned to kSnapshotAlignment
+ *   - null bitmap: num_regions * num_dates bits in payload order, set where
+ *     the amount is missing (kNullAmount or NaN); loading checks the payload
+ *     against it
+ * Strings are a uint32_t byte length followed by the bytes. Numbers use the
+ * byte order of the machine that saved the snapshot, recorded in byte_order.
+ */
+const char kSnapshotMagic[8] = {'C', 'V', 'D', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t kSnapshotVersion = 1;
+const uint32_t kSnapshotByteOrder = 0x01020304;
+const size_t kSnapshotAlignment = 64;
+const char kSnapshotExtension[] = ".cvsnap";
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t num_columns;
+  uint64_t num_regions;
+  uint64_t num_dates;
+  uint64_t names_offset;
+  uint64_t dates_offset;
+  uint64_t payload_offset;
+  uint64_t null_bitmap_offset;
+  uint64_t file_size;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_SNAPSHOT_H
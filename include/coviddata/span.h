@@ -0,0 +1,44 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_SPAN_H
+#define FINALPROJECT_SPAN_H
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace coviddata {
+
+/**
+ * Non-owning view over a contiguous run of values (pointer and length).
+ *
+ * Spans are cheap to copy and never allocate; the memory they point into must
+ * outlive them.
+ */
+template <typename T>
+class Span {
+ public:
+  Span() : data_(nullptr), size_(0) {}
+  Span(T* data, size_t size) : data_(data), size_(size) {}
+
+  T* Data() const { return data_; }
+  size_t Size() const { return size_; }
+  bool Empty() const { return size_ == 0; }
+
+  T* begin() const { return data_; }
+  T* end() const { return data_ + size_; }
+
+  T& operator[](size_t index) const { return data_[index]; }
+
+  T& At(size_t index) const {
+    if (index >= size_) throw std::out_of_range("Span index out of range");
+    return data_[index];
+  }
+
+ private:
+  T* data_;
+  size_t size_;
+};
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_SPAN_H
@@ -0,0 +1,69 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#ifndef FINALPROJECT_THREADPOOL_H
+#define FINALPROJECT_THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace coviddata {
+
+/**
+ * Fixed set of worker threads that run submitted tasks in submission order.
+ *
+ * Submit() returns a future that becomes ready once the task has run; any
+ * exception thrown by the task is rethrown from the future's get().
+ */
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t num_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  template <typename Task>
+  std::future<void> Submit(Task task);
+  size_t Size() const;
+  static size_t DefaultThreadCount();
+
+ private:
+  void RunWorker();
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool stopping_;
+};
+
+/**
+ * Queues a task to run on the next free worker
+ * @param task callable taking no arguments
+ * @return future that is ready once the task has run
+ */
+template <typename Task>
+std::future<void> ThreadPool::Submit(Task task) {
+  auto packaged_task =
+      std::make_shared<std::packaged_task<void()>>(std::move(task));
+  std::future<void> result = packaged_task->get_future();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.emplace([packaged_task] { (*packaged_task)(); });
+  }
+  condition_.notify_one();
+
+  return result;
+}
+
+}  // namespace coviddata
+
+#endif  // FINALPROJECT_THREADPOOL_H
@@ -0,0 +1,283 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/amountsearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "coviddata/amountstats.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COVIDDATA_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COVIDDATA_USE_SSE2
+#endif
+
+#if defined(_MSC_VER) && \
+    (defined(COVIDDATA_USE_AVX2) || defined(COVIDDATA_USE_SSE2))
+#include <intrin.h>
+#endif
+
+namespace coviddata {
+
+namespace {
+
+const float kNegativeInfinity = -std::numeric_limits<float>::infinity();
+
+/**
+ * Returns the index of the lowest set bit
+ * @param mask non-zero bit mask
+ * @return index of lowest set bit
+ */
+inline size_t CountTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<size_t>(index);
+#else
+  return static_cast<size_t>(__builtin_ctz(mask));
+#endif
+}
+
+#if defined(COVIDDATA_USE_AVX2)
+/**
+ * Replaces null amounts (NaN or kNullAmount) with negative infinity, so they
+ * lose every comparison
+ */
+inline __m256 MaskNullAmounts(__m256 amounts) {
+  const __m256 nulls = _mm256_or_ps(
+      _mm256_cmp_ps(amounts, amounts, _CMP_UNORD_Q),
+      _mm256_cmp_ps(amounts, _mm256_set1_ps(static_cast<float>(kNullAmount)),
+                    _CMP_EQ_OQ));
+  return _mm256_blendv_ps(amounts, _mm256_set1_ps(kNegativeInfinity), nulls);
+}
+#endif
+
+#if defined(COVIDDATA_USE_AVX2) || defined(COVIDDATA_USE_SSE2)
+/**
+ * Replaces null amounts (NaN or kNullAmount) with negative infinity, so they
+ * lose every comparison
+ */
+inline __m128 MaskNullAmounts(__m128 amounts) {
+  const __m128 nulls = _mm_or_ps(
+      _mm_cmpunord_ps(amounts, amounts),
+      _mm_cmpeq_ps(amounts, _mm_set1_ps(static_cast<float>(kNullAmount))));
+  return _mm_or_ps(_mm_andnot_ps(nulls, amounts),
+                   _mm_and_ps(nulls, _mm_set1_ps(kNegativeInfinity)));
+}
+
+/**
+ * Returns the largest of the four lanes of a register
+ */
+inline float HorizontalMax(__m128 values) {
+  values = _mm_max_ps(
+      values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(2, 3, 0, 1)));
+  values = _mm_max_ps(
+      values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(1, 0, 3, 2)));
+  return _mm_cvtss_f32(values);
+}
+#endif
+
+/**
+ * Finds the largest non-null amount
+ * @return largest amount, or negative infinity if every amount is null
+ */
+float FindMaxOrNegativeInfinity(const float* amounts, size_t length) {
+  size_t offset = 0;
+  float max = kNegativeInfinity;
+
+#if defined(COVIDDATA_USE_AVX2)
+  __m256 wide_maxima = _mm256_set1_ps(kNegativeInfinity);
+  for (; offset + 8 <= length; offset += 8) {
+    wide_maxima = _mm256_max_ps(
+        wide_maxima, MaskNullAmounts(_mm256_loadu_ps(amounts + offset)));
+  }
+  max = HorizontalMax(_mm_max_ps(_mm256_castps256_ps128(wide_maxima),
+                                 _mm256_extractf128_ps(wide_maxima, 1)));
+#endif
+
+#if defined(COVIDDATA_USE_AVX2) || defined(COVIDDATA_USE_SSE2)
+  __m128 maxima = _mm_set1_ps(max);
+  for (; offset + 4 <= length; offset += 4) {
+    maxima = _mm_max_ps(maxima, MaskNullAmounts(_mm_loadu_ps(amounts + offset)));
+  }
+  max = HorizontalMax(maxima);
+#endif
+
+  // Scalar fallback, and the tail that does not fill a register
+  for (; offset < length; offset++) {
+    if (!IsNullAmount(amounts[offset]) && amounts[offset] > max)
+      max = amounts[offset];
+  }
+
+  return max;
+}
+
+/**
+ * Finds the first amount equal to a value
+ * @return index of the amount, or length if there is none
+ */
+size_t FindFirstEqual(const float* amounts, size_t length, float value) {
+  size_t offset = 0;
+
+#if defined(COVIDDATA_USE_AVX2)
+  const __m256 wide_values = _mm256_set1_ps(value);
+  for (; offset + 8 <= length; offset += 8) {
+    const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(amounts + offset), wide_values,
+                      _CMP_EQ_OQ)));
+    if (mask != 0) return offset + CountTrailingZeros(mask);
+  }
+#endif
+
+#if defined(COVIDDATA_USE_AVX2) || defined(COVIDDATA_USE_SSE2)
+  const __m128 values = _mm_set1_ps(value);
+  for (; offset + 4 <= length; offset += 4) {
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(
+        _mm_cmpeq_ps(_mm_loadu_ps(amounts + offset), values)));
+    if (mask != 0) return offset + CountTrailingZeros(mask);
+  }
+#endif
+
+  for (; offset < length; offset++) {
+    if (amounts[offset] >= value && amounts[offset] <= value) return offset;
+  }
+
+  return length;
+}
+
+/**
+ * The largest amounts seen so far and their indices, kept as a heap whose
+ * front is the one that would be dropped next
+ */
+class TopAmounts {
+ public:
+  explicit TopAmounts(size_t count) : count_(count), heap_() {
+    heap_.reserve(count);
+  }
+
+  bool IsFull() const { return heap_.size() == count_; }
+
+  // Amounts must be larger than this to be kept once the heap is full
+  float GetThreshold() const { return heap_.front().first; }
+
+  void Consider(float amount, size_t index) {
+    if (IsNullAmount(amount)) return;
+
+    if (!IsFull()) {
+      heap_.emplace_back(amount, index);
+      std::push_heap(heap_.begin(), heap_.end(), IsBetter);
+    } else if (amount > GetThreshold()) {
+      std::pop_heap(heap_.begin(), heap_.end(), IsBetter);
+      heap_.back() = std::make_pair(amount, index);
+      std::push_heap(heap_.begin(), heap_.end(), IsBetter);
+    }
+  }
+
+  // Writes the indices of the kept amounts, largest first
+  void GetIndices(std::vector<size_t>& indices) {
+    std::sort_heap(heap_.begin(), heap_.end(), IsBetter);
+    for (const std::pair<float, size_t>& entry : heap_)
+      indices.push_back(entry.second);
+  }
+
+ private:
+  size_t count_;
+  std::vector<std::pair<float, size_t>> heap_;
+
+  // Larger amounts are better; of equal amounts, the one seen first
+  static bool IsBetter(const std::pair<float, size_t>& x,
+                       const std::pair<float, size_t>& y) {
+    return x.first > y.first || (x.first >= y.first && x.second < y.second);
+  }
+};
+
+}  // namespace
+
+/**
+ * Finds the largest non-null amount
+ * @param amounts amounts to search
+ * @return largest amount, or kNullAmount if every amount is null
+ */
+float FindMaxAmount(Span<const float> amounts) {
+  const float max = FindMaxOrNegativeInfinity(amounts.Data(), amounts.Size());
+  return std::isinf(max) && max < 0 ? static_cast<float>(kNullAmount) : max;
+}
+
+/**
+ * Finds where the largest non-null amount is (ex. the region with the most
+ * cases on a date)
+ * @param amounts amounts to search
+ * @return index of the first occurrence of the largest amount, or
+ *         amounts.Size() if every amount is null
+ */
+size_t FindMaxAmountIndex(Span<const float> amounts) {
+  const float max = FindMaxOrNegativeInfinity(amounts.Data(), amounts.Size());
+  return FindFirstEqual(amounts.Data(), amounts.Size(), max);
+}
+
+/**
+ * Finds where the largest non-null amounts are (ex. the ten regions with the
+ * most cases on a date) in one pass. Once enough amounts are found, whole
+ * registers of amounts that are not larger than all of them are skipped.
+ * @param amounts amounts to search
+ * @param count number of amounts to find
+ * @param indices cleared, then filled with the indices of the largest
+ *                amounts, largest first; equal amounts are ordered by index.
+ *                Holds fewer than count indices if fewer amounts are non-null
+ */
+void FindTopAmounts(Span<const float> amounts, size_t count,
+                    std::vector<size_t>& indices) {
+  indices.clear();
+  if (count == 0) return;
+
+  TopAmounts top_amounts(count);
+  const float* values = amounts.Data();
+  const size_t length = amounts.Size();
+  size_t offset = 0;
+
+#if defined(COVIDDATA_USE_AVX2)
+  for (; offset + 8 <= length; offset += 8) {
+    uint32_t mask = 0xFF;
+    if (top_amounts.IsFull()) {
+      mask = static_cast<uint32_t>(_mm256_movemask_ps(
+          _mm256_cmp_ps(_mm256_loadu_ps(values + offset),
+                        _mm256_set1_ps(top_amounts.GetThreshold()),
+                        _CMP_GT_OQ)));
+    }
+
+    for (; mask != 0; mask &= mask - 1) {
+      const size_t index = offset + CountTrailingZeros(mask);
+      top_amounts.Consider(values[index], index);
+    }
+  }
+#endif
+
+#if defined(COVIDDATA_USE_AVX2) || defined(COVIDDATA_USE_SSE2)
+  for (; offset + 4 <= length; offset += 4) {
+    uint32_t mask = 0xF;
+    if (top_amounts.IsFull()) {
+      mask = static_cast<uint32_t>(_mm_movemask_ps(
+          _mm_cmpgt_ps(_mm_loadu_ps(values + offset),
+                       _mm_set1_ps(top_amounts.GetThreshold()))));
+    }
+
+    for (; mask != 0; mask &= mask - 1) {
+      const size_t index = offset + CountTrailingZeros(mask);
+      top_amounts.Consider(values[index], index);
+    }
+  }
+#endif
+
+  for (; offset < length; offset++) top_amounts.Consider(values[offset], offset);
+
+  top_amounts.GetIndices(indices);
+}
+
+}  // namespace coviddata
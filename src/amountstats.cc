@@ -0,0 +1,84 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/amountstats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace coviddata {
+
+/**
+ * Returns true if an amount is missing from the source data
+ * @param amount amount to check
+ * @return if amount is kNullAmount or NaN
+ */
+bool IsNullAmount(float amount) {
+  return std::isnan(amount) ||
+         (amount >= kNullAmount && amount <= kNullAmount);
+}
+
+/**
+ * Default constructor; statistics of no amounts
+ */
+AmountStats::AmountStats() : max_(0), min_(0), sum_(0), count_(0) {}
+
+/**
+ * Includes an amount in the statistics. Null amounts are skipped.
+ * @param amount amount to include
+ */
+void AmountStats::Add(float amount) {
+  if (IsNullAmount(amount)) return;
+
+  if (count_ == 0) {
+    max_ = amount;
+    min_ = amount;
+  } else {
+    max_ = std::max(max_, amount);
+    min_ = std::min(min_, amount);
+  }
+  sum_ += amount;
+  count_++;
+}
+
+/**
+ * Includes the amounts of other statistics in these statistics
+ * @param other statistics of amounts not already included
+ */
+void AmountStats::Merge(const AmountStats& other) {
+  if (other.count_ == 0) return;
+
+  if (count_ == 0) {
+    *this = other;
+    return;
+  }
+  max_ = std::max(max_, other.max_);
+  min_ = std::min(min_, other.min_);
+  sum_ += other.sum_;
+  count_ += other.count_;
+}
+
+/**
+ * Retrieves the highest amount
+ * @return highest non-null amount, or 0 if there are none
+ */
+float AmountStats::GetMax() const { return max_; }
+
+/**
+ * Retrieves the lowest amount
+ * @return lowest non-null amount, or 0 if there are none
+ */
+float AmountStats::GetMin() const { return min_; }
+
+/**
+ * Retrieves the sum of every amount
+ * @return sum of non-null amounts
+ */
+double AmountStats::GetSum() const { return sum_; }
+
+/**
+ * Retrieves how many amounts are included
+ * @return number of non-null amounts
+ */
+size_t AmountStats::GetCount() const { return count_; }
+
+}  // namespace coviddata
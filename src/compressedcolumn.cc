@@ -0,0 +1,284 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/compressedcolumn.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace coviddata {
+
+namespace {
+
+// Whole amounts up to this magnitude are packed as integers
+const float kMaxPackedMagnitude = 2147483648.0f;  // 2^31
+
+// Converts an amount to an integer if that loses nothing (not even the sign
+// of zero)
+bool ToExactInteger(float amount, int64_t& integer) {
+  if (!(amount >= -kMaxPackedMagnitude && amount <= kMaxPackedMagnitude))
+    return false;
+
+  integer = static_cast<int64_t>(amount);
+  const auto round_trip = static_cast<float>(integer);
+  return std::memcmp(&round_trip, &amount, sizeof(amount)) == 0;
+}
+
+// Number of bits needed to store an unsigned value
+uint8_t GetBitWidth(uint64_t value) {
+  uint8_t bit_width = 0;
+  while (value != 0) {
+    bit_width++;
+    value >>= 1;
+  }
+  return bit_width;
+}
+
+// Maps signed differences to unsigned values, small magnitudes first
+uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value < 0 ? -1 : 0);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+}  // namespace
+
+const size_t CompressedColumn::kBlockSize;
+
+/**
+ * Default constructor; a column without amounts
+ */
+CompressedColumn::CompressedColumn()
+    : blocks_(), words_(), num_bits_(0), size_(0) {}
+
+/**
+ * Compresses a column of amounts
+ * @param amounts amounts ordered by date index
+ */
+CompressedColumn::CompressedColumn(Span<const float> amounts)
+    : blocks_(), words_(), num_bits_(0), size_(amounts.Size()) {
+  for (size_t begin = 0; begin < amounts.Size(); begin += kBlockSize) {
+    const size_t count = std::min(kBlockSize, amounts.Size() - begin);
+    EncodeBlock(Span<const float>(amounts.Data() + begin, count));
+  }
+  blocks_.shrink_to_fit();
+  words_.shrink_to_fit();
+}
+
+/**
+ * Returns the number of amounts in the column
+ * @return number of amounts
+ */
+size_t CompressedColumn::Size() const { return size_; }
+
+/**
+ * Retrieves a single amount without decoding the rest of its block (delta
+ * blocks add up the differences before it)
+ * @param index index of amount
+ * @return amount at index
+ * @throws std::out_of_range if the column has no amount for the index
+ */
+float CompressedColumn::At(size_t index) const {
+  if (index >= size_)
+    throw std::out_of_range("Compressed column index out of range");
+
+  const Block& block = blocks_[index / kBlockSize];
+  const size_t position = index % kBlockSize;
+
+  if (block.encoding != Encoding::kDelta) {
+    return DecodeValue(block, ReadBits(block.bit_offset +
+                                           position * block.bit_width,
+                                       block.bit_width));
+  }
+
+  int64_t value = block.reference;
+  for (size_t delta = 0; delta < position; delta++) {
+    value += ZigZagDecode(
+        ReadBits(block.bit_offset + delta * block.bit_width, block.bit_width));
+  }
+  return static_cast<float>(value);
+}
+
+/**
+ * Returns the number of blocks the column is split into
+ * @return number of blocks
+ */
+size_t CompressedColumn::GetNumBlocks() const { return blocks_.size(); }
+
+/**
+ * Decodes every amount of a block in order
+ * @param block_index index of block
+ * @param amounts destination for at least kBlockSize amounts
+ * @return number of amounts decoded
+ * @throws std::out_of_range if the block does not exist
+ */
+size_t CompressedColumn::DecodeBlock(size_t block_index,
+                                     float* amounts) const {
+  const Block& block = blocks_.at(block_index);
+  const size_t count = std::min(kBlockSize, size_ - block_index * kBlockSize);
+  uint64_t bit_offset = block.bit_offset;
+
+  if (block.encoding == Encoding::kDelta) {
+    int64_t value = block.reference;
+    amounts[0] = static_cast<float>(value);
+    for (size_t position = 1; position < count; position++) {
+      value += ZigZagDecode(ReadBits(bit_offset, block.bit_width));
+      bit_offset += block.bit_width;
+      amounts[position] = static_cast<float>(value);
+    }
+    return count;
+  }
+
+  for (size_t position = 0; position < count; position++) {
+    amounts[position] =
+        DecodeValue(block, ReadBits(bit_offset, block.bit_width));
+    bit_offset += block.bit_width;
+  }
+  return count;
+}
+
+/**
+ * Decodes the whole column
+ * @param amounts receives every amount in order
+ */
+void CompressedColumn::Decode(std::vector<float>& amounts) const {
+  amounts.resize(size_);
+  for (size_t block = 0; block < blocks_.size(); block++)
+    DecodeBlock(block, amounts.data() + block * kBlockSize);
+}
+
+/**
+ * Retrieves statistics of the non-null amounts in a block
+ * @param block_index index of block
+ * @return statistics of block
+ * @throws std::out_of_range if the block does not exist
+ */
+const AmountStats& CompressedColumn::GetBlockStats(size_t block_index) const {
+  return blocks_.at(block_index).stats;
+}
+
+/**
+ * Returns how much memory the column occupies
+ * @return size of column in bytes
+ */
+size_t CompressedColumn::GetMemoryUsage() const {
+  return sizeof(*this) + blocks_.capacity() * sizeof(Block) +
+         words_.capacity() * sizeof(uint64_t);
+}
+
+/**
+ * Packs one block of amounts with whichever encoding takes fewer bits
+ * @param amounts amounts of the block
+ */
+void CompressedColumn::EncodeBlock(Span<const float> amounts) {
+  Block block{};
+  block.bit_offset = num_bits_;
+  for (float amount : amounts) block.stats.Add(amount);
+
+  int64_t integers[kBlockSize] = {};
+  bool is_whole = true;
+  for (size_t position = 0; position < amounts.Size() && is_whole;
+       position++)
+    is_whole = ToExactInteger(amounts[position], integers[position]);
+
+  if (!is_whole) {
+    block.encoding = Encoding::kRaw;
+    block.bit_width = 32;
+    for (float amount : amounts) {
+      uint32_t bits;
+      std::memcpy(&bits, &amount, sizeof(bits));
+      AppendBits(bits, block.bit_width);
+    }
+    blocks_.push_back(block);
+    return;
+  }
+
+  const size_t count = amounts.Size();
+  const int64_t min = *std::min_element(integers, integers + count);
+  const int64_t max = *std::max_element(integers, integers + count);
+  const uint8_t offset_width = GetBitWidth(static_cast<uint64_t>(max - min));
+
+  uint64_t max_delta = 0;
+  for (size_t position = 1; position < count; position++) {
+    max_delta = std::max(
+        max_delta, ZigZagEncode(integers[position] - integers[position - 1]));
+  }
+  const uint8_t delta_width = GetBitWidth(max_delta);
+
+  // Offsets are preferred on ties since they decode in constant time
+  if ((count - 1) * delta_width < count * offset_width) {
+    block.encoding = Encoding::kDelta;
+    block.reference = integers[0];
+    block.bit_width = delta_width;
+    for (size_t position = 1; position < count; position++) {
+      AppendBits(ZigZagEncode(integers[position] - integers[position - 1]),
+                 delta_width);
+    }
+  } else {
+    block.encoding = Encoding::kFrameOfReference;
+    block.reference = min;
+    block.bit_width = offset_width;
+    for (size_t position = 0; position < count; position++)
+      AppendBits(static_cast<uint64_t>(integers[position] - min),
+                 offset_width);
+  }
+
+  blocks_.push_back(block);
+}
+
+/**
+ * Appends the low bits of a value to the packed words
+ * @param value value that fits in bit_width bits
+ * @param bit_width number of bits to append
+ */
+void CompressedColumn::AppendBits(uint64_t value, uint8_t bit_width) {
+  if (bit_width == 0) return;
+
+  const auto shift = static_cast<unsigned>(num_bits_ % 64);
+  if (shift == 0) words_.push_back(0);
+  words_.back() |= value << shift;
+  if (shift + bit_width > 64) words_.push_back(value >> (64 - shift));
+
+  num_bits_ += bit_width;
+}
+
+/**
+ * Reads packed bits, which may straddle two words
+ * @param bit_offset position of first bit
+ * @param bit_width number of bits to read
+ * @return bits as an unsigned value
+ */
+uint64_t CompressedColumn::ReadBits(uint64_t bit_offset,
+                                    uint8_t bit_width) const {
+  if (bit_width == 0) return 0;
+
+  const auto word = static_cast<size_t>(bit_offset / 64);
+  const auto shift = static_cast<unsigned>(bit_offset % 64);
+  uint64_t value = words_[word] >> shift;
+  if (shift + bit_width > 64) value |= words_[word + 1] << (64 - shift);
+
+  return bit_width == 64 ? value : value & ((uint64_t{1} << bit_width) - 1);
+}
+
+/**
+ * Turns a packed value of a raw or frame-of-reference block into an amount
+ * @param block block holding the value
+ * @param packed value as read from the packed words
+ * @return amount
+ */
+float CompressedColumn::DecodeValue(const Block& block,
+                                    uint64_t packed) const {
+  if (block.encoding == Encoding::kRaw) {
+    const auto bits = static_cast<uint32_t>(packed);
+    float amount;
+    std::memcpy(&amount, &bits, sizeof(amount));
+    return amount;
+  }
+
+  return static_cast<float>(block.reference + static_cast<int64_t>(packed));
+}
+
+}  // namespace coviddata
@@ -3,61 +3,407 @@
 //
 
 #include "coviddata/csvparser.h"
+#include "coviddata/numparse.h"
 
-#include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <utility>
 
 namespace coviddata {
 
+namespace {
+
+// UTF-8 byte order mark that some editors write at the start of a file
+const char kByteOrderMark[] = "\xEF\xBB\xBF";
+
+}  // namespace
+
 /**
  * Parses through a single CSV file and stores the values
  * @param filename name of file to parse
+ * @param mode whether to copy every line up front, map the file, or stream
+ *             it from disk; the last two are read row by row. Compressed
+ *             files are always streamed.
  */
-CsvParser::CsvParser(const std::string& filename) : fail_(false) {
-  std::ifstream csv_file(filename);
+CsvParser::CsvParser(const std::string& filename, ReadMode mode)
+    : mode_(mode), filename_(filename), cursor_(0), row_index_(0),
+      fail_(false) {
+  if (DecompressingReader::DetectCompression(filename) !=
+      DecompressingReader::Compression::kNone) {
+    mode_ = ReadMode::kStreaming;
+    reader_.reset(new DecompressingReader(filename));
+    fail_ = reader_->Fail();
+    return;
+  }
 
-  if (csv_file.fail()) {
-    fail_ = true;
+  if (mode_ == ReadMode::kMemoryMapped) {
+    mapped_file_ = MappedFile(filename);
+    buffer_ = Span<const char>(mapped_file_.Data(), mapped_file_.Size());
+    fail_ = mapped_file_.Fail();
     return;
   }
 
-  std::istream& csv_filestream = csv_file;
-  std::string csv_line;
+  if (mode_ == ReadMode::kStreaming) {
+    stream_.open(filename, std::ios::binary);
+    fail_ = stream_.fail();
+    return;
+  }
+
+  // Buffered mode copies every row out of a stream up front
+  stream_.open(filename, std::ios::binary);
+  if (stream_.fail()) {
+    fail_ = true;
+    return;
+  }
 
-  while (std::getline(csv_filestream, csv_line)) {
+  std::vector<Field> fields;
+  while (ReadStreamedRow(fields)) {
     Line l;
-    l.values = (SplitStr(csv_line, ","));
-    lines_.push_back(l);
+    l.values.reserve(fields.size());
+    for (const Field& field : fields) l.values.push_back(ToString(field));
+    lines_.push_back(std::move(l));
   }
+
+  stream_.close();
+  row_index_ = 0;
 }
 
+/**
+ * Reads rows straight out of memory owned by the caller; nothing is copied
+ * @param buffer CSV text that must outlive the parser
+ */
+CsvParser::CsvParser(Span<const char> buffer)
+    : mode_(ReadMode::kInMemory), buffer_(buffer), cursor_(0), row_index_(0),
+      fail_(false) {}
+
 /**
  * Retrieves all lines read from a file
- * @return lines as a vector reference
+ * @return lines as a vector reference (empty in memory-mapped mode)
  */
 std::vector<CsvParser::Line>& CsvParser::GetLines() { return lines_; }
 
-// Implementation taken from an answer on StackOverflow:
-// "Parse (split) a string in C++ using string delimiter (standard C++)"
-// https://stackoverflow.com/questions/14265581/parse-split-a-string-in-c-using-string-delimiter-standard-c#comment44856986_14266139
 /**
- * Splits a string based off a delimiter value; used to separate values from commas
- * @param s string to split
- * @param delimiter string that determines split point
- * @return vector of strings split by delimiter
+ * Reads the next row of the file into a reusable vector of field views.
+ * Fields stay valid until the parser is destroyed, or until the next call in
+ * streaming mode.
+ * @param fields vector to fill with the fields of the row
+ * @return false once there are no rows left
+ * @throws std::runtime_error if a compressed file is corrupt or truncated
  */
-std::vector<std::string> CsvParser::SplitStr(const std::string& s, const std::string& delimiter) {
-  std::vector<std::string> split_string;
-  size_t last = 0;
-  size_t next = 0;
+bool CsvParser::ReadRow(std::vector<Field>& fields) {
+  fields.clear();
+
+  if (mode_ == ReadMode::kBuffered) {
+    if (cursor_ >= lines_.size()) return false;
+
+    for (const std::string& value : lines_.at(cursor_).values)
+      fields.emplace_back(value.data(), value.size());
+    cursor_++;
+    row_index_++;
+    return true;
+  }
+
+  if (mode_ == ReadMode::kStreaming) {
+    if (reader_ != nullptr) return ReadDecompressedRow(fields);
+    return ReadStreamedRow(fields);
+  }
+
+  // Memory-mapped and in-memory rows are both read out of buffer_
+  const char* data = buffer_.Data();
+  const size_t size = buffer_.Size();
+  if (cursor_ >= size) return false;
+
+  const char* line_begin = data + cursor_;
+  const char* line_end = FindRowEnd(line_begin, data + size);
+  cursor_ = static_cast<size_t>(line_end - data);
+  if (line_end > line_begin && line_end[-1] == '\n') line_end--;
+
+  SplitLine(line_begin, line_end, fields);
+  row_index_++;
+  return true;
+}
+
+/**
+ * Reads the next row from the file stream, joining lines while a quoted
+ * field is still open
+ * @param fields vector to fill with the fields of the row
+ * @return false once there are no rows left
+ */
+bool CsvParser::ReadStreamedRow(std::vector<Field>& fields) {
+  fields.clear();
+  if (fail_ || !std::getline(stream_, stream_line_)) return false;
+
+  std::string next_line;
+  while (HasOpenQuote(stream_line_.data(),
+                      stream_line_.data() + stream_line_.size()) &&
+         std::getline(stream_, next_line)) {
+    stream_line_ += '\n';
+    stream_line_ += next_line;
+  }
+
+  SplitLine(stream_line_.data(), stream_line_.data() + stream_line_.size(),
+            fields);
+  row_index_++;
+  return true;
+}
+
+/**
+ * Reads the next row out of the blocks of a compressed file. A row inside a
+ * single block is split in place; a row that crosses into the next block, or
+ * holds a quoted newline, is put together in stream_line_ first.
+ * @param fields vector to fill with the fields of the row
+ * @return false once there are no rows left
+ */
+bool CsvParser::ReadDecompressedRow(std::vector<Field>& fields) {
+  if (fail_) return false;
+
+  // Only ever holds the row returned by the previous call
+  stream_line_.clear();
+
+  while (true) {
+    const char* data = block_.data();
+    const size_t size = block_.size();
+
+    if (cursor_ < size) {
+      const char* line_begin = data + cursor_;
+      const char* line_end = static_cast<const char*>(
+          std::memchr(line_begin, '\n', size - cursor_));
+
+      if (line_end != nullptr) {
+        cursor_ = static_cast<size_t>(line_end - data) + 1;
+        if (stream_line_.empty() && !HasOpenQuote(line_begin, line_end)) {
+          SplitLine(line_begin, line_end, fields);
+          row_index_++;
+          return true;
+        }
+
+        stream_line_.append(line_begin, line_end);
+        if (!HasOpenQuote(stream_line_.data(),
+                          stream_line_.data() + stream_line_.size())) {
+          SplitLine(stream_line_.data(),
+                    stream_line_.data() + stream_line_.size(), fields);
+          row_index_++;
+          return true;
+        }
+
+        // The newline belongs to a quoted field
+        stream_line_ += '\n';
+        continue;
+      }
+
+      stream_line_.append(line_begin, data + size);
+    }
+
+    cursor_ = 0;
+    if (!reader_->ReadBlock(block_)) {
+      block_.clear();
+      break;
+    }
+  }
+
+  // The last line of the file may not end with a newline
+  if (stream_line_.empty()) return false;
+
+  SplitLine(stream_line_.data(), stream_line_.data() + stream_line_.size(),
+            fields);
+  row_index_++;
+  return true;
+}
+
+/**
+ * Pushes every remaining row to a callback, one row at a time. The row and
+ * its fields are only guaranteed to be valid during the call.
+ * @param callback function taking the index of the row (header is 0) and
+ *                 a span over its fields
+ */
+void CsvParser::ForEachRow(const RowCallback& callback) {
+  std::vector<Field> fields;
+
+  while (true) {
+    size_t row_index = row_index_;
+    if (!ReadRow(fields)) break;
+    callback(row_index, Row(fields.data(), fields.size()));
+  }
+}
+
+/**
+ * Moves back to the first row so the file can be read again
+ */
+void CsvParser::Rewind() {
+  cursor_ = 0;
+  row_index_ = 0;
+
+  if (reader_ != nullptr) {
+    // Decompression can only go forwards, so start it over
+    reader_.reset(new DecompressingReader(filename_));
+    fail_ = reader_->Fail();
+    block_.clear();
+    stream_line_.clear();
+  } else if (mode_ == ReadMode::kStreaming && !fail_) {
+    stream_.clear();
+    stream_.seekg(0);
+  }
+}
+
+/**
+ * Copies a field view into a string
+ * @param field field to copy
+ * @return field contents as a string
+ */
+std::string CsvParser::ToString(const Field& field) {
+  return std::string(field.begin(), field.end());
+}
+
+/**
+ * Finds where a row ends. A row normally ends at the next newline, but a
+ * newline inside a quoted field belongs to the field.
+ * @param begin first character of the row
+ * @param end end of the text
+ * @return one past the newline that ends the row, or end if there is none
+ */
+const char* CsvParser::FindRowEnd(const char* begin, const char* end) {
+  const char* newline = static_cast<const char*>(
+      std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+  if (newline == nullptr) newline = end;
+
+  // Most rows have no quotes before their newline
+  if (std::memchr(begin, '"', static_cast<size_t>(newline - begin)) ==
+      nullptr)
+    return newline == end ? end : newline + 1;
+
+  bool in_quotes = false;
+  for (const char* position = begin; position < end; position++) {
+    if (*position == '"') {
+      in_quotes = !in_quotes;
+    } else if (*position == '\n' && !in_quotes) {
+      return position + 1;
+    }
+  }
+  return end;
+}
+
+/**
+ * Returns true if a line leaves a quoted field open, so the row continues
+ * on the next line. Escaped quotes come in pairs and cancel out.
+ * @param begin first character of the line
+ * @param end one past the last character of the line
+ * @return if the line has an odd number of quotes
+ */
+bool CsvParser::HasOpenQuote(const char* begin, const char* end) {
+  const char* quote = static_cast<const char*>(
+      std::memchr(begin, '"', static_cast<size_t>(end - begin)));
+  if (quote == nullptr) return false;
+
+  return std::count(quote, end, '"') % 2 == 1;
+}
+
+/**
+ * Splits a line into fields following RFC 4180. A line without quotes is
+ * split on every comma, all located in one vectorized scan; only lines with
+ * quotes go through SplitQuotedFields().
+ * @param begin first character of the line
+ * @param end one past the last character of the line
+ * @param fields vector to append the fields to
+ */
+void CsvParser::SplitFields(const char* begin, const char* end,
+                            std::vector<Field>& fields) {
+  if (std::memchr(begin, '"', static_cast<size_t>(end - begin)) != nullptr) {
+    SplitQuotedFields(begin, end, fields);
+    return;
+  }
+
+  FindDelimiters(begin, end, ',', delimiter_positions_);
 
-  while ((next = s.find(delimiter, last)) != std::string::npos) {
-    split_string.push_back(s.substr(last, next - last));
+  size_t last = 0;
+  for (size_t next : delimiter_positions_) {
+    fields.emplace_back(begin + last, next - last);
     last = next + 1;
   }
-  split_string.push_back(s.substr(last));
+  fields.emplace_back(begin + last, static_cast<size_t>(end - begin) - last);
+}
+
+/**
+ * Splits a line that contains quotes. A quoted field may hold commas,
+ * newlines and escaped quotes (""); its surrounding quotes are dropped. Quoted
+ * fields without escaped quotes still point into the line, while the rest are
+ * unescaped into scratch_, which only lives until the next row is split.
+ * @param begin first character of the line
+ * @param end one past the last character of the line
+ * @param fields vector to append the fields to
+ */
+void CsvParser::SplitQuotedFields(const char* begin, const char* end,
+                                  std::vector<Field>& fields) {
+  // Unescaped fields are never longer than the line, so views into scratch_
+  // are not moved by a reallocation while the line is split
+  scratch_.clear();
+  scratch_.reserve(static_cast<size_t>(end - begin));
+
+  const char* position = begin;
+  while (true) {
+    const char* field_end;
+
+    if (position < end && *position == '"') {
+      const char* content = ++position;
+      const size_t scratch_begin = scratch_.size();
+      bool escaped = false;
+
+      // Jump from quote to quote until the closing one
+      while (true) {
+        const char* quote = static_cast<const char*>(std::memchr(
+            position, '"', static_cast<size_t>(end - position)));
+        if (quote == nullptr) quote = end;  // unterminated: take the rest
+
+        if (quote + 1 < end && quote[1] == '"') {
+          // Keep the first quote of the pair
+          scratch_.append(position, quote + 1);
+          escaped = true;
+          position = quote + 2;
+          continue;
+        }
+
+        if (escaped) {
+          scratch_.append(position, quote);
+          fields.emplace_back(scratch_.data() + scratch_begin,
+                              scratch_.size() - scratch_begin);
+        } else {
+          fields.emplace_back(content, static_cast<size_t>(quote - content));
+        }
+        position = quote < end ? quote + 1 : end;
+        break;
+      }
+
+      // Anything between the closing quote and the comma is dropped
+      field_end = static_cast<const char*>(
+          std::memchr(position, ',', static_cast<size_t>(end - position)));
+    } else {
+      field_end = static_cast<const char*>(
+          std::memchr(position, ',', static_cast<size_t>(end - position)));
+      const char* value_end = field_end == nullptr ? end : field_end;
+      fields.emplace_back(position, static_cast<size_t>(value_end - position));
+    }
+
+    if (field_end == nullptr) return;
+    position = field_end + 1;
+  }
+}
+
+/**
+ * Splits a line into fields, dropping the \r that ends lines written on
+ * Windows and the byte order mark some editors put before the header
+ * @param begin first character of the line
+ * @param end one past the last character of the line, before any \n
+ * @param fields vector to append the fields to
+ */
+void CsvParser::SplitLine(const char* begin, const char* end,
+                          std::vector<Field>& fields) {
+  if (end > begin && *(end - 1) == '\r') end--;
+
+  const size_t bom_size = sizeof(kByteOrderMark) - 1;
+  if (row_index_ == 0 && static_cast<size_t>(end - begin) >= bom_size &&
+      std::memcmp(begin, kByteOrderMark, bom_size) == 0)
+    begin += bom_size;
 
-  return split_string;
+  SplitFields(begin, end, fields);
 }
 
 /**
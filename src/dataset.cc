@@ -4,64 +4,816 @@
 
 #include "coviddata/csvparser.h"
 #include "coviddata/dataset.h"
+#include "coviddata/decompressingreader.h"
+#include "coviddata/mappedfile.h"
+#include "coviddata/numparse.h"
+#include "coviddata/snapshot.h"
+#include "coviddata/threadpool.h"
 
-#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <limits>
 #include <stdexcept>
 
 
 namespace coviddata {
 
+namespace {
+
+// Appends a snapshot string (byte length, then bytes) to a section
+void AppendSnapshotString(std::string& section, const std::string& value) {
+  const auto length = static_cast<uint32_t>(value.size());
+  section.append(reinterpret_cast<const char*>(&length), sizeof(length));
+  section.append(value);
+}
+
+// Reads the snapshot string at a position and moves past it
+std::string ReadSnapshotString(const char*& position, const char* end) {
+  uint32_t length;
+  if (static_cast<size_t>(end - position) < sizeof(length))
+    throw std::invalid_argument("Snapshot is truncated");
+  std::memcpy(&length, position, sizeof(length));
+  position += sizeof(length);
+
+  if (static_cast<size_t>(end - position) < length)
+    throw std::invalid_argument("Snapshot is truncated");
+  std::string value(position, length);
+  position += length;
+
+  return value;
+}
+
+// Rounds an offset up to the alignment of the snapshot payload
+uint64_t AlignSnapshotOffset(uint64_t offset) {
+  return (offset + kSnapshotAlignment - 1) / kSnapshotAlignment *
+         kSnapshotAlignment;
+}
+
+// Waits for every task before rethrowing the first exception any of them
+// threw, so that no task still uses the caller's state while it unwinds
+void WaitForTasks(std::vector<std::future<void>>& tasks) {
+  std::exception_ptr error;
+  for (std::future<void>& task : tasks) {
+    try {
+      task.get();
+    } catch (...) {
+      if (!error) error = std::current_exception();
+    }
+  }
+  tasks.clear();
+  if (error) std::rethrow_exception(error);
+}
+
+}  // namespace
+
 /**
  * Default constructor
  */
-DataSet::DataSet() : region_to_data_(), regions_() { }
+DataSet::DataSet()
+    : region_data_(), region_to_id_(), regions_(),
+      date_axis_(std::make_shared<DateAxis>()), import_thread_count_(1),
+      stats_(), stats_excluding_world_(), schema_(), imported_header_(),
+      imported_bytes_(0), lazy_loading_(false), lazy_file_(), row_offsets_(),
+      row_date_indices_(), region_columns_(), loaded_regions_(),
+      lazy_stats_loaded_(false), lazy_mutex_(), derived_series_(),
+      derived_mutex_(), date_rows_(), date_rows_built_(false),
+      date_rows_mutex_() { }
 
 /**
  * Imports data from a properly formatted .csv file.
- * @param filename name of file to import data from
+ * @param filename name of file to import data from; .csv.gz and .csv.zst
+ *                 files are decompressed while they are parsed
+ * @throws std::invalid_argument if the file does not exist or is invalid
+ * @throws std::runtime_error if a compressed file is corrupt
  */
 void DataSet::ImportData(const std::string& filename) {
   // Reset before assigning data
   Reset();
 
-  // Get data from .csv file and assign its filename
-  coviddata::CsvParser parser(filename);
-  if (parser.Fail()) throw std::invalid_argument("File does not exist");
+  if (DecompressingReader::DetectCompression(filename) !=
+      DecompressingReader::Compression::kNone) {
+    ImportCompressedData(filename);
+    return;
+  }
+
+  if (lazy_loading_) {
+    ImportDataLazily(filename);
+    return;
+  }
+
+  if (import_thread_count_ != 1) {
+    ImportDataInParallel(filename);
+    return;
+  }
+
+  // Map the .csv file and assign its filename; rows are read in place
+  MappedFile mapped_file(filename);
+  if (mapped_file.Fail()) throw std::invalid_argument("File does not exist");
+
+  data_type_ = filename;
+
+  const char* file_begin = mapped_file.Data();
+  const char* file_end = file_begin + mapped_file.Size();
+  const char* rows_end = FindCompleteRowsEnd(file_begin, file_end);
+  coviddata::CsvParser parser(Span<const char>(
+      file_begin, static_cast<size_t>(rows_end - file_begin)));
+  ImportRows(parser);
+
+  RememberImportedText(file_begin, file_end);
+  FinishImport();
+}
+
+/**
+ * Imports a compressed .csv file, parsing each block as soon as it has been
+ * decompressed. Nothing is remembered for RefreshData(): a compressed file
+ * cannot be extended by appending rows.
+ * @param filename name of compressed file to import data from
+ */
+void DataSet::ImportCompressedData(const std::string& filename) {
+  coviddata::CsvParser parser(filename, CsvParser::ReadMode::kStreaming);
+  if (parser.Fail())
+    throw std::invalid_argument(
+        "File does not exist or its compression is not supported");
+
+  data_type_ = filename;
+
+  ImportRows(parser);
+  FinishImport();
+}
+
+/**
+ * Fills the regional data in a single pass over the rows of a parser
+ * @param parser parser positioned at the header line
+ * @throws std::invalid_argument if the header does not contain regions
+ */
+void DataSet::ImportRows(coviddata::CsvParser& parser) {
+  using Row = CsvParser::Row;
+
+  // Each column is resolved to its region id once instead of once per cell
+  std::vector<size_t> column_to_id;
+
+  parser.ForEachRow([this, &column_to_id](size_t row_index, Row row) {
+    // Get all regions from header line
+    if (row_index == 0) {
+      InitializeRegionalData(row);
+      if (region_data_.empty())
+        throw std::invalid_argument("File does not contain regions in header");
+      column_to_id = MapColumnsToIds();
+      return;
+    }
+
+    if (row_index <= Schema::kSampleRows) schema_.AddSampleRow(row);
+    ImportRow(row, column_to_id);
+  });
+
+  // Files without any lines never reach the header check above
+  if (region_data_.empty())
+    throw std::invalid_argument("File does not contain regions in header");
+}
+
+/**
+ * Imports the rows appended to the file since it was last imported or
+ * refreshed. Only the new rows are parsed: they extend the region columns in
+ * place and update the statistics incrementally. A file that shrank or whose
+ * header changed has been rewritten, so it is imported again from scratch.
+ * @return number of dates added to the date axis
+ * @throws std::logic_error if the dataset was not imported from a .csv file
+ * @throws std::invalid_argument if the file no longer exists or is invalid
+ */
+size_t DataSet::RefreshData() {
+  if (imported_header_.empty())
+    throw std::logic_error("Dataset was not imported from a .csv file");
+
+  // Indexing rows is cheap, so lazy datasets simply index the file again
+  if (lazy_file_ != nullptr) {
+    const size_t num_dates = date_axis_->Size();
+    const std::string filename = data_type_;
+    ImportData(filename);
+    return date_axis_->Size() > num_dates ? date_axis_->Size() - num_dates : 0;
+  }
+
+  MappedFile mapped_file(data_type_);
+  if (mapped_file.Fail()) throw std::invalid_argument("File does not exist");
+
+  const size_t num_dates = date_axis_->Size();
+  const char* file_begin = mapped_file.Data();
+  const char* file_end = file_begin + mapped_file.Size();
+
+  if (mapped_file.Size() < imported_bytes_ ||
+      std::memcmp(file_begin, imported_header_.data(),
+                  imported_header_.size()) != 0) {
+    const std::string filename = data_type_;
+    ImportData(filename);
+    return date_axis_->Size() > num_dates ? date_axis_->Size() - num_dates : 0;
+  }
+
+  // The last imported line is parsed again in case it was only partly
+  // written; its date is already interned, so its amounts are replaced
+  const char* rows_begin = file_begin + imported_bytes_;
+  const char* rows_end = FindCompleteRowsEnd(file_begin, file_end);
+  coviddata::CsvParser parser(Span<const char>(
+      rows_begin, static_cast<size_t>(rows_end - rows_begin)));
+  const std::vector<size_t> column_to_id = MapColumnsToIds();
+  parser.ForEachRow([this, &column_to_id](size_t, CsvParser::Row row) {
+    ImportRow(row, column_to_id);
+  });
+
+  RememberImportedText(file_begin, file_end);
+  FinishImport();
+
+  // Rolling results only look back, so they stay valid up to the last line
+  // that was parsed again
+  {
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    const size_t num_unchanged_dates = num_dates > 0 ? num_dates - 1 : 0;
+    for (auto& entry : derived_series_) {
+      entry.second.num_valid_days =
+          std::min(entry.second.num_valid_days, num_unchanged_dates);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(date_rows_mutex_);
+    date_rows_.clear();
+    date_rows_built_ = false;
+  }
+
+  return date_axis_->Size() - num_dates;
+}
+
+/**
+ * Imports a .csv file on a pool of import threads. The rows after the header
+ * are split into chunks at line boundaries, each chunk is parsed on its own
+ * thread, and the chunks are merged back into the region columns in file
+ * order (so dates keep their order), one range of regions per thread.
+ * @param filename name of file to import data from
+ */
+void DataSet::ImportDataInParallel(const std::string& filename) {
+  MappedFile mapped_file(filename);
+  if (mapped_file.Fail()) throw std::invalid_argument("File does not exist");
+
+  data_type_ = filename;
+
+  const char* file_begin = mapped_file.Data();
+  const char* file_end = file_begin + mapped_file.Size();
+  const char* header_end = CsvParser::FindRowEnd(file_begin, file_end);
+  const char* rows_end = FindCompleteRowsEnd(file_begin, file_end);
+
+  // Get all regions from header line
+  CsvParser header_parser(Span<const char>(
+      file_begin, static_cast<size_t>(header_end - file_begin)));
+  header_parser.ForEachRow([this](size_t, CsvParser::Row row) {
+    InitializeRegionalData(row);
+  });
+  if (region_data_.empty())
+    throw std::invalid_argument("File does not contain regions in header");
+  SampleSchemaRows(header_end, rows_end);
+
+  const std::vector<size_t> column_to_id = MapColumnsToIds();
+  const size_t num_columns = column_to_id.size();
+
+  // The tasks write into the chunks, so they must outlive the pool's workers
+  std::vector<ParsedChunk> chunks;
+  std::vector<std::future<void>> tasks;
+  ThreadPool pool(import_thread_count_);
+
+  // Chunks are cut at newlines, which could fall inside a quoted field; rows
+  // with quotes are rare enough that such files are parsed as a single chunk
+  const bool has_quotes =
+      std::memchr(header_end, '"',
+                  static_cast<size_t>(rows_end - header_end)) != nullptr;
+  const size_t num_chunks = has_quotes ? 1 : pool.Size();
+
+  // Split the remaining rows into chunks of roughly equal size
+  std::vector<const char*> chunk_bounds = {header_end};
+  for (size_t chunk = 1; chunk < num_chunks; chunk++) {
+    const char* target =
+        header_end + static_cast<size_t>(rows_end - header_end) * chunk /
+                         num_chunks;
+    chunk_bounds.push_back(
+        std::max(chunk_bounds.back(), FindLineEnd(target, rows_end)));
+  }
+  chunk_bounds.push_back(rows_end);
+
+  // Parse every chunk into its own row-major block of amounts
+  chunks.resize(num_chunks);
+  for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+    Span<const char> text(
+        chunk_bounds.at(chunk),
+        static_cast<size_t>(chunk_bounds.at(chunk + 1) -
+                            chunk_bounds.at(chunk)));
+    ParsedChunk& parsed = chunks.at(chunk);
+
+    tasks.push_back(pool.Submit([text, &parsed, num_columns] {
+      CsvParser chunk_parser(text);
+      chunk_parser.ForEachRow([&parsed, num_columns](size_t,
+                                                     CsvParser::Row row) {
+        if (row.Size() < 2) return;
+        if (row.Size() - 1 > num_columns)
+          throw std::out_of_range("Line has more values than the header");
+
+        parsed.dates.push_back(CsvParser::ToString(row[0]));
+        for (size_t column = 1; column <= num_columns; column++) {
+          parsed.amounts.push_back(column < row.Size()
+                                       ? GetNumberFromString(row[column])
+                                       : static_cast<float>(kNullAmount));
+        }
+      });
+    }));
+  }
+  WaitForTasks(tasks);
+
+  // Dates are interned in file order before any amounts are stored
+  for (ParsedChunk& parsed : chunks) {
+    for (const std::string& date : parsed.dates)
+      parsed.date_indices.push_back(date_axis_->Intern(date));
+  }
+  for (RegionData& region_data : region_data_)
+    region_data.Resize(date_axis_->Size());
+
+  // Each thread fills a disjoint range of regions, so no column is shared
+  const size_t num_regions = region_data_.size();
+  const size_t num_parts = pool.Size();
+  for (size_t part = 0; part < num_parts; part++) {
+    const size_t first_id = num_regions * part / num_parts;
+    const size_t last_id = num_regions * (part + 1) / num_parts;
+
+    tasks.push_back(pool.Submit([this, &chunks, &column_to_id, first_id,
+                                 last_id, num_columns] {
+      for (const ParsedChunk& parsed : chunks) {
+        for (size_t row = 0; row < parsed.date_indices.size(); row++) {
+          const float* amounts = parsed.amounts.data() + row * num_columns;
+
+          for (size_t column = 0; column < num_columns; column++) {
+            size_t region_id = column_to_id[column];
+            if (region_id < first_id || region_id >= last_id) continue;
+
+            region_data_[region_id].SetAmountAtIndex(
+                parsed.date_indices[row], amounts[column]);
+          }
+        }
+      }
+    }));
+  }
+  WaitForTasks(tasks);
+
+  RememberImportedText(file_begin, file_end);
+  FinishImport();
+}
+
+/**
+ * Indexes a .csv file without parsing its amounts. Only the header and the
+ * date of each row are read; the file stays mapped so that LoadRegion() can
+ * parse a region's column when it is first retrieved.
+ * @param filename name of file to import data from
+ */
+void DataSet::ImportDataLazily(const std::string& filename) {
+  auto mapped_file = std::make_shared<MappedFile>(filename);
+  if (mapped_file->Fail()) throw std::invalid_argument("File does not exist");
 
   data_type_ = filename;
 
-  using Line = CsvParser::Line;
-  Line header = parser.GetLines().at(0);
+  const char* file_begin = mapped_file->Data();
+  const char* file_end = file_begin + mapped_file->Size();
+  const char* header_end = CsvParser::FindRowEnd(file_begin, file_end);
+  const char* rows_end = FindCompleteRowsEnd(file_begin, file_end);
 
   // Get all regions from header line
-  InitializeRegionalData(header);
-  if (region_to_data_.empty())
+  CsvParser header_parser(Span<const char>(
+      file_begin, static_cast<size_t>(header_end - file_begin)));
+  header_parser.ForEachRow([this](size_t, CsvParser::Row row) {
+    InitializeRegionalData(row);
+  });
+  if (region_data_.empty())
     throw std::invalid_argument("File does not contain regions in header");
+  SampleSchemaRows(header_end, rows_end);
+
+  // Rows without any amounts are skipped, as in a full import
+  std::vector<CsvParser::Field> fields;
+  for (const char* line = header_end; line < rows_end;) {
+    const char* next_line = CsvParser::FindRowEnd(line, rows_end);
+    const size_t line_size = static_cast<size_t>(next_line - line);
+
+    if (std::memchr(line, '"', line_size) != nullptr) {
+      // A quoted date or amount may hide commas, so split the row properly
+      CsvParser row_parser(Span<const char>(line, line_size));
+      row_parser.ReadRow(fields);
+      if (fields.size() >= 2) {
+        row_offsets_.push_back(static_cast<size_t>(line - file_begin));
+        row_date_indices_.push_back(
+            date_axis_->Intern(CsvParser::ToString(fields[0])));
+      }
+    } else {
+      const char* date_end =
+          static_cast<const char*>(std::memchr(line, ',', line_size));
+      if (date_end != nullptr) {
+        row_offsets_.push_back(static_cast<size_t>(line - file_begin));
+        row_date_indices_.push_back(
+            date_axis_->Intern(std::string(line, date_end)));
+      }
+    }
+    line = next_line;
+  }
+
+  // Each region parses every column it appears in, in header order
+  const std::vector<size_t> column_to_id = MapColumnsToIds();
+  region_columns_.resize(region_data_.size());
+  for (size_t column = 0; column < column_to_id.size(); column++) {
+    // Columns are offset by 1 because the first column is the date
+    region_columns_[column_to_id[column]].push_back(column + 1);
+  }
+  loaded_regions_.assign(region_data_.size(), false);
+
+  RememberImportedText(file_begin, file_end);
+  lazy_file_ = mapped_file;
+}
+
+/**
+ * Parses the column of a lazily imported region unless it is already parsed.
+ * Each indexed row is split at its delimiters and only the region's fields
+ * are converted.
+ * @param region_id id of region
+ */
+void DataSet::LoadRegion(size_t region_id) const {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  if (lazy_file_ == nullptr || loaded_regions_.at(region_id)) return;
+
+  auto& region_data = const_cast<RegionData&>(region_data_[region_id]);
+  region_data.Resize(date_axis_->Size());
+
+  const std::vector<size_t>& columns = region_columns_[region_id];
+  const char* file_begin = lazy_file_->Data();
+  const char* file_end = file_begin + lazy_file_->Size();
+  std::vector<size_t> delimiter_positions;
+
+  std::vector<CsvParser::Field> fields;
+
+  for (size_t row = 0; row < row_offsets_.size(); row++) {
+    const char* line = file_begin + row_offsets_[row];
+    const char* line_end = CsvParser::FindRowEnd(line, file_end);
+    const size_t line_size = static_cast<size_t>(line_end - line);
+
+    if (std::memchr(line, '"', line_size) != nullptr) {
+      // Quoted fields may hide commas, so split the row properly
+      CsvParser row_parser(Span<const char>(line, line_size));
+      row_parser.ReadRow(fields);
+      for (size_t column : columns) {
+        if (column >= fields.size()) continue;
+        region_data.SetAmountAtIndex(row_date_indices_[row],
+                                     GetNumberFromString(fields[column]));
+      }
+      continue;
+    }
+
+    while (line_end > line && (line_end[-1] == '\n' || line_end[-1] == '\r'))
+      line_end--;
+    FindDelimiters(line, line_end, ',', delimiter_positions);
+
+    for (size_t column : columns) {
+      // Short lines leave trailing regions without their last dates
+      if (column > delimiter_positions.size()) continue;
+
+      // A field lies between the delimiter before it and the one after it
+      const char* field_begin = line + delimiter_positions[column - 1] + 1;
+      const char* field_end = column < delimiter_positions.size()
+                                  ? line + delimiter_positions[column]
+                                  : line_end;
+      CsvParser::Field field(field_begin,
+                             static_cast<size_t>(field_end - field_begin));
+      region_data.SetAmountAtIndex(row_date_indices_[row],
+                                   GetNumberFromString(field));
+    }
+  }
+
+  loaded_regions_[region_id] = true;
+}
+
+/**
+ * Parses every region of a lazily imported dataset that is not parsed yet,
+ * then gathers the statistics of the dataset
+ */
+void DataSet::LoadAllRegions() const {
+  if (lazy_file_ == nullptr) return;
+
+  for (size_t region_id = 0; region_id < region_data_.size(); region_id++)
+    LoadRegion(region_id);
+
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  if (lazy_stats_loaded_) return;
+  const_cast<DataSet*>(this)->MergeRegionStats();
+  lazy_stats_loaded_ = true;
+}
+
+/**
+ * Completes an import once every amount is stored: pads regions to the full
+ * date axis and gathers the statistics of the dataset.
+ */
+void DataSet::FinishImport() {
+  // Short lines leave trailing regions without their last dates
+  for (RegionData& region_data : region_data_)
+    region_data.Resize(date_axis_->Size());
+
+  MergeRegionStats();
+}
+
+/**
+ * Gathers the statistics of every region into the statistics of the dataset
+ */
+void DataSet::MergeRegionStats() {
+  stats_ = AmountStats();
+  stats_excluding_world_ = AmountStats();
+  for (const RegionData& region_data : region_data_) {
+    stats_.Merge(region_data.GetStats());
+    if (region_data.GetRegionName() != kWorldRegion)
+      stats_excluding_world_.Merge(region_data.GetStats());
+  }
+}
+
+/**
+ * Remembers the header and the end of the last complete line of an imported
+ * file, so that RefreshData() can resume from there
+ * @param file_begin first character of the file
+ * @param file_end one past the last character of the file
+ */
+void DataSet::RememberImportedText(const char* file_begin,
+                                   const char* file_end) {
+  const char* header_end = CsvParser::FindRowEnd(file_begin, file_end);
+  imported_header_.assign(file_begin, header_end);
+
+  const char* line_end = file_end;
+  while (line_end > header_end && line_end[-1] != '\n') line_end--;
+  imported_bytes_ = static_cast<size_t>(line_end - file_begin);
+}
+
+/**
+ * Refines the schema from the first rows after the header of a file
+ * @param rows_begin first character after the header
+ * @param rows_end one past the last row to sample
+ */
+void DataSet::SampleSchemaRows(const char* rows_begin, const char* rows_end) {
+  CsvParser sample_parser(
+      Span<const char>(rows_begin, static_cast<size_t>(rows_end - rows_begin)));
+  std::vector<CsvParser::Field> fields;
+
+  for (size_t row = 0; row < Schema::kSampleRows; row++) {
+    if (!sample_parser.ReadRow(fields)) break;
+    schema_.AddSampleRow(CsvParser::Row(fields.data(), fields.size()));
+  }
+}
 
-  // Extract data date-by-date region-by-region
-  for (size_t line_num = 1; line_num < parser.GetLines().size(); line_num++) {
-    Line current_line = parser.GetLines().at(line_num);
-
-    for (size_t region_index = 1;
-         region_index < current_line.values.size();
-         region_index++) {
-      // Find the particular region and its corresponding data
-      std::string region_name = header.values.at(region_index);
-      RegionData& region_data = region_to_data_.at(region_name);
-
-      // Update the data with information from the line in the .csv file
-      std::string date = current_line.values.at(0);
-      float amount = GetNumberFromString(current_line.values.at(region_index));
-      region_data.SetAmountToDate(date, amount);
+/**
+ * Infers the schema of a dataset that was not imported from text, sampling
+ * the first amounts of each region instead of rows
+ * @param metric name of the metric of the dataset
+ */
+void DataSet::InferSchemaFromAmounts(const std::string& metric) {
+  schema_ = Schema(metric, "date", regions_);
+
+  for (size_t column = 0; column < regions_.size(); column++) {
+    const RegionData& region_data =
+        region_data_[region_to_id_.at(regions_[column])];
+    size_t num_sampled = 0;
+
+    for (float amount : region_data.GetAmounts()) {
+      if (num_sampled == Schema::kSampleRows) break;
+      if (IsNullAmount(amount)) continue;
+
+      // Columns are offset by 1 because the first column is the date
+      schema_.AddSampleAmount(column + 1, amount);
+      num_sampled++;
+    }
+  }
+}
+
+/**
+ * Saves the dataset as a binary snapshot that LoadSnapshot() can map back in.
+ * @param filename name of snapshot file to write
+ * @throws std::runtime_error if the file could not be written
+ */
+void DataSet::SaveSnapshot(const std::string& filename) const {
+  LoadAllRegions();
+
+  const size_t num_dates = date_axis_->Size();
+  const size_t num_amounts = region_data_.size() * num_dates;
+
+  std::string names;
+  for (const std::string& region_name : regions_)
+    AppendSnapshotString(names, region_name);
+
+  std::string dates;
+  for (const std::string& date : date_axis_->GetDates())
+    AppendSnapshotString(dates, date);
+
+  SnapshotHeader header{};
+  std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+  header.version = kSnapshotVersion;
+  header.byte_order = kSnapshotByteOrder;
+  header.num_columns = regions_.size();
+  header.num_regions = region_data_.size();
+  header.num_dates = num_dates;
+  header.names_offset = sizeof(header);
+  header.dates_offset = header.names_offset + names.size();
+  header.payload_offset =
+      AlignSnapshotOffset(header.dates_offset + dates.size());
+  header.null_bitmap_offset =
+      header.payload_offset + num_amounts * sizeof(float);
+  header.file_size = header.null_bitmap_offset + (num_amounts + 7) / 8;
+
+  std::ofstream output(filename, std::ios::binary | std::ios::trunc);
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.write(names.data(), static_cast<std::streamsize>(names.size()));
+  output.write(dates.data(), static_cast<std::streamsize>(dates.size()));
+  const std::string padding(
+      header.payload_offset - header.dates_offset - dates.size(), '\0');
+  output.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+  // Regions are written column by column, padded to the full date axis
+  std::vector<uint8_t> null_bitmap((num_amounts + 7) / 8, 0);
+  std::vector<float> column(num_dates);
+  for (size_t region_id = 0; region_id < region_data_.size(); region_id++) {
+    Span<const float> amounts = region_data_[region_id].GetAmounts();
+
+    for (size_t date_index = 0; date_index < num_dates; date_index++) {
+      column[date_index] = date_index < amounts.Size()
+                               ? amounts[date_index]
+                               : static_cast<float>(kNullAmount);
+
+      if (IsNullAmount(column[date_index])) {
+        size_t bit = region_id * num_dates + date_index;
+        null_bitmap[bit / 8] |= static_cast<uint8_t>(1u << (bit % 8));
+      }
+    }
+
+    output.write(reinterpret_cast<const char*>(column.data()),
+                 static_cast<std::streamsize>(num_dates * sizeof(float)));
+  }
+  output.write(reinterpret_cast<const char*>(null_bitmap.data()),
+               static_cast<std::streamsize>(null_bitmap.size()));
+
+  if (!output) throw std::runtime_error("Could not write snapshot file");
+}
+
+/**
+ * Loads a snapshot written by SaveSnapshot(). The file is memory-mapped and
+ * every region reads its amounts straight from the mapping, which stays open
+ * for as long as any of the regions (or copies of them) do.
+ * @param filename name of snapshot file to load
+ * @throws std::invalid_argument if the file does not exist or is not a valid
+ *         snapshot, including when its amounts disagree with its null bitmap
+ */
+void DataSet::LoadSnapshot(const std::string& filename) {
+  // Reset before assigning data
+  Reset();
+
+  auto mapped_file = std::make_shared<MappedFile>(filename);
+  if (mapped_file->Fail()) throw std::invalid_argument("File does not exist");
+
+  const char* file_begin = mapped_file->Data();
+  const uint64_t file_size = mapped_file->Size();
+
+  SnapshotHeader header{};
+  if (file_size < sizeof(header))
+    throw std::invalid_argument("File is not a snapshot");
+  std::memcpy(&header, file_begin, sizeof(header));
+
+  if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 ||
+      header.byte_order != kSnapshotByteOrder)
+    throw std::invalid_argument("File is not a snapshot");
+  if (header.version != kSnapshotVersion)
+    throw std::invalid_argument("Unsupported snapshot version");
+
+  // Guard the payload size against overflow before checking that every
+  // section lies inside the file, in order
+  const uint64_t num_dates = header.num_dates;
+  const uint64_t max_amounts =
+      std::numeric_limits<uint64_t>::max() / sizeof(float);
+  if (num_dates != 0 && header.num_regions > max_amounts / num_dates)
+    throw std::invalid_argument("Snapshot is corrupt");
+  const uint64_t num_amounts = header.num_regions * num_dates;
+
+  if (header.file_size != file_size ||
+      header.names_offset < sizeof(header) ||
+      header.dates_offset < header.names_offset ||
+      header.payload_offset < header.dates_offset ||
+      header.payload_offset % kSnapshotAlignment != 0 ||
+      header.null_bitmap_offset - header.payload_offset !=
+          num_amounts * sizeof(float) ||
+      header.null_bitmap_offset > file_size ||
+      file_size - header.null_bitmap_offset < (num_amounts + 7) / 8)
+    throw std::invalid_argument("Snapshot is corrupt");
+
+  data_type_ = filename;
+
+  const char* position = file_begin + header.names_offset;
+  const char* names_end = file_begin + header.dates_offset;
+  for (size_t column = 0; column < header.num_columns; column++) {
+    regions_.push_back(ReadSnapshotString(position, names_end));
+    // Columns are offset by 1 because the first column is the date
+    AddRegionColumn(regions_.back(), column + 1);
+  }
+
+  position = file_begin + header.dates_offset;
+  const char* dates_end = file_begin + header.payload_offset;
+  for (size_t date_index = 0; date_index < num_dates; date_index++)
+    date_axis_->Intern(ReadSnapshotString(position, dates_end));
+
+  if (region_data_.size() != header.num_regions ||
+      date_axis_->Size() != num_dates)
+    throw std::invalid_argument("Snapshot is corrupt");
+
+  // The mapping is page aligned and so is the payload, so amounts are read
+  // in place as floats
+  const auto* payload =
+      reinterpret_cast<const float*>(file_begin + header.payload_offset);
+
+  // Every amount must be missing exactly where the null bitmap says so
+  const auto* null_bitmap = reinterpret_cast<const uint8_t*>(
+      file_begin + header.null_bitmap_offset);
+  for (uint64_t bit = 0; bit < num_amounts; bit++) {
+    const bool is_null = ((null_bitmap[bit / 8] >> (bit % 8)) & 1u) != 0;
+    if (is_null != IsNullAmount(payload[bit]))
+      throw std::invalid_argument("Snapshot is corrupt");
+  }
+
+  std::shared_ptr<const void> owner = mapped_file;
+  for (size_t region_id = 0; region_id < region_data_.size(); region_id++) {
+    region_data_[region_id].BorrowAmounts(
+        Span<const float>(payload + region_id * num_dates, num_dates), owner);
+  }
+
+  InferSchemaFromAmounts(Schema::GetMetricName(filename));
+  FinishImport();
+}
+
+/**
+ * Retrieves the schema inferred while importing
+ * @return schema of the dataset
+ */
+const coviddata::Schema& DataSet::GetSchema() const { return schema_; }
+
+/**
+ * Retrieves a rolling kernel of a region's amounts (ex. its 7-day moving
+ * average) as a region with the same name and dates. The results are
+ * computed once and cached; after RefreshData() only the new days are
+ * computed.
+ * @param region_id id of region
+ * @param kernel analytic to compute
+ * @param window number of days the kernel looks back over
+ * @return region borrowing the cached results, one per date
+ * @throws std::out_of_range if there is no region with the id
+ * @throws std::invalid_argument if window is 0
+ */
+coviddata::RegionData DataSet::GetDerivedRegionData(size_t region_id,
+                                                    RollingKernel kernel,
+                                                    size_t window) const {
+  if (window == 0) throw std::invalid_argument("Window must be at least 1");
+
+  const coviddata::RegionData& region_data = GetRegionDataById(region_id);
+  const Span<const float> amounts = region_data.GetAmounts();
+
+  std::shared_ptr<const std::vector<float>> results;
+  {
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    DerivedSeries& series =
+        derived_series_[DerivedSeriesKey(region_id, kernel, window)];
+
+    if (series.results == nullptr || series.num_valid_days < amounts.Size() ||
+        series.results->size() != amounts.Size()) {
+      // Extend a copy of the days that are still valid
+      auto updated_results = std::make_shared<std::vector<float>>();
+      if (series.results != nullptr) {
+        const size_t num_valid_days =
+            std::min(series.num_valid_days, series.results->size());
+        updated_results->reserve(amounts.Size());
+        updated_results->assign(series.results->begin(),
+                                series.results->begin() +
+                                    static_cast<std::ptrdiff_t>(num_valid_days));
+      }
+
+      ComputeRollingKernel(kernel, window, amounts, updated_results->size(),
+                           *updated_results);
+      series.results = updated_results;
+      series.num_valid_days = amounts.Size();
     }
+
+    results = series.results;
   }
+
+  coviddata::RegionData derived(region_data.GetRegionName(),
+                                region_data.GetRegionIndex(), date_axis_);
+  derived.BorrowAmounts(Span<const float>(results->data(), results->size()),
+                        results);
+  return derived;
 }
 
 /**
  * Returns number of regions stored internally.
  * @return number of regions
  */
-size_t DataSet::Size() { return region_to_data_.size(); }
+size_t DataSet::Size() const { return region_data_.size(); }
 
 /**
  * Retrieves the data of a region by its name
@@ -70,10 +822,29 @@ size_t DataSet::Size() { return region_to_data_.size(); }
  */
 coviddata::RegionData& DataSet::GetRegionDataByName(
     const std::string& region_name) const {
-  const coviddata::RegionData& region_data = region_to_data_.at(region_name);
+  return GetRegionDataById(GetRegionId(region_name));
+}
+
+/**
+ * Retrieves the data of a region by its id
+ * @param region_id id of region (order of first appearance in header)
+ * @return data corresponding with id
+ */
+coviddata::RegionData& DataSet::GetRegionDataById(size_t region_id) const {
+  const coviddata::RegionData& region_data = region_data_.at(region_id);
+  LoadRegion(region_id);
   return const_cast<RegionData&>(region_data);
 }
 
+/**
+ * Retrieves the id of a region by its name
+ * @param region_name name of region
+ * @return id of region
+ */
+size_t DataSet::GetRegionId(const std::string& region_name) const {
+  return region_to_id_.at(region_name);
+}
+
 /**
  * Retrieves a list of all regions contained in dataset
  * @return vector of region names as strings
@@ -82,21 +853,182 @@ std::vector<std::string>& DataSet::GetRegions() const {
   return (std::vector<std::string>&)regions_;
 }
 
+/**
+ * Retrieves the dates shared by every region in the dataset
+ * @return date axis of dataset
+ */
+const coviddata::DateAxis& DataSet::GetDateAxis() const { return *date_axis_; }
+
+/**
+ * Retrieves statistics of every amount in the dataset without scanning them
+ * @param include_world whether to include the "World" region
+ * @return statistics of amounts
+ */
+const coviddata::AmountStats& DataSet::GetStats(bool include_world) const {
+  LoadAllRegions();
+  return include_world ? stats_ : stats_excluding_world_;
+}
+
+/**
+ * Retrieves the amount of every region on one date, without a lookup per
+ * region. The first call transposes every region's column into rows.
+ * @param date_index index of date on the date axis
+ * @return one amount per region id; valid until the dataset is next imported,
+ *         refreshed or reset
+ * @throws std::out_of_range if there is no date with the index
+ */
+Span<const float> DataSet::GetAmountsAtIndex(size_t date_index) const {
+  if (date_index >= date_axis_->Size())
+    throw std::out_of_range("Date index is out of range");
+
+  BuildDateRows();
+  const size_t num_regions = region_data_.size();
+  return Span<const float>(date_rows_.data() + date_index * num_regions,
+                           num_regions);
+}
+
+/**
+ * Transposes the region columns into date rows unless that is already done.
+ * Blocks of regions and dates are copied together, so reads and writes both
+ * stay within a few cache lines at a time.
+ */
+void DataSet::BuildDateRows() const {
+  LoadAllRegions();
+
+  std::lock_guard<std::mutex> lock(date_rows_mutex_);
+  if (date_rows_built_) return;
+
+  const size_t kBlockSize = 64;
+  const size_t num_regions = region_data_.size();
+  const size_t num_dates = date_axis_->Size();
+  date_rows_.assign(num_regions * num_dates,
+                    static_cast<float>(kNullAmount));
+
+  for (size_t first_region = 0; first_region < num_regions;
+       first_region += kBlockSize) {
+    const size_t last_region = std::min(first_region + kBlockSize, num_regions);
+    for (size_t first_date = 0; first_date < num_dates;
+         first_date += kBlockSize) {
+      const size_t last_date = std::min(first_date + kBlockSize, num_dates);
+
+      for (size_t region_id = first_region; region_id < last_region;
+           region_id++) {
+        const Span<const float> amounts = region_data_[region_id].GetAmounts();
+        // Regions shorter than the axis keep null amounts for later dates
+        const size_t end_date = std::min(last_date, amounts.Size());
+        for (size_t date_index = first_date; date_index < end_date;
+             date_index++) {
+          date_rows_[date_index * num_regions + region_id] =
+              amounts[date_index];
+        }
+      }
+    }
+  }
+
+  date_rows_built_ = true;
+}
+
+/**
+ * Sets how many threads ImportData() parses with. With 1 (the default) the
+ * file is imported on the calling thread.
+ * @param num_threads number of import threads; 0 uses every hardware thread
+ */
+void DataSet::SetImportThreadCount(size_t num_threads) {
+  import_thread_count_ = num_threads;
+}
+
+/**
+ * Retrieves how many threads ImportData() parses with
+ * @return number of import threads, or 0 for every hardware thread
+ */
+size_t DataSet::GetImportThreadCount() const { return import_thread_count_; }
+
+/**
+ * Sets whether ImportData() only indexes the file and parses each region's
+ * column the first time it is retrieved. Lazy imports ignore the import
+ * thread count.
+ * @param lazy_loading whether to load regions lazily
+ */
+void DataSet::SetLazyLoading(bool lazy_loading) {
+  lazy_loading_ = lazy_loading;
+}
+
+/**
+ * Returns true if ImportData() loads regions lazily
+ * @return if regions are loaded lazily
+ */
+bool DataSet::IsLazyLoading() const { return lazy_loading_; }
+
+/**
+ * Returns true if a region's amounts have been parsed. Regions of datasets
+ * that were not imported lazily are always loaded.
+ * @param region_id id of region
+ * @return if the region is loaded
+ */
+bool DataSet::IsRegionLoaded(size_t region_id) const {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  return lazy_file_ == nullptr || loaded_regions_.at(region_id);
+}
+
 /**
  * Clears all data from the dataset
  */
 void DataSet::Reset() {
-  region_to_data_.clear();
+  region_data_.clear();
+  region_to_id_.clear();
   regions_.clear();
+  // Copies of regions may still point to the old axis, so replace it
+  date_axis_ = std::make_shared<DateAxis>();
   data_type_ = std::string();
+  stats_ = AmountStats();
+  stats_excluding_world_ = AmountStats();
+  schema_ = Schema();
+  imported_header_.clear();
+  imported_bytes_ = 0;
+  lazy_file_.reset();
+  row_offsets_.clear();
+  row_date_indices_.clear();
+  region_columns_.clear();
+  loaded_regions_.clear();
+  lazy_stats_loaded_ = false;
+
+  {
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    derived_series_.clear();
+  }
+
+  std::lock_guard<std::mutex> lock(date_rows_mutex_);
+  date_rows_.clear();
+  date_rows_built_ = false;
 }
 
 /**
  * Returns true if the dataset has no data.
  * @return if dataset is empty
  */
-bool DataSet::Empty() {
-  return region_to_data_.empty() && regions_.empty() && data_type_.empty();
+bool DataSet::Empty() const {
+  return region_data_.empty() && regions_.empty() && data_type_.empty();
+}
+
+/**
+ * Stores every amount of a single .csv line under the line's date
+ * @param row fields of the line, starting with the date
+ * @param column_to_id region id for each column after the date
+ */
+void DataSet::ImportRow(coviddata::CsvParser::Row row,
+                        const std::vector<size_t>& column_to_id) {
+  if (row.Size() < 2) return;
+  size_t date_index = date_axis_->Intern(CsvParser::ToString(row[0]));
+
+  // Extract data region-by-region
+  for (size_t region_index = 1; region_index < row.Size(); region_index++) {
+    // Columns are offset by 1 because the first column is the date
+    RegionData& region_data = region_data_[column_to_id.at(region_index - 1)];
+
+    // Update the data with information from the line in the .csv file
+    float amount = GetNumberFromString(row[region_index]);
+    region_data.SetAmountAtIndex(date_index, amount);
+  }
 }
 
 /**
@@ -107,34 +1039,98 @@ bool DataSet::Empty() {
  *
  * @param header header line of .csv file
  */
-void DataSet::InitializeRegionalData(coviddata::CsvParser::Line header) {
+void DataSet::InitializeRegionalData(coviddata::CsvParser::Row header) {
   // Start at index 1 because first line is always the date
-  for (size_t region_index = 1; region_index < header.values.size();
+  for (size_t region_index = 1; region_index < header.Size();
        region_index++) {
     // Extract region name and create data for each region
-    std::string region_name = header.values.at(region_index);
+    std::string region_name = CsvParser::ToString(header[region_index]);
     regions_.push_back(region_name);
-
-    RegionData region_data(region_name, region_index);
-    region_to_data_.insert({region_name, region_data});
+    AddRegionColumn(region_name, region_index);
   }
+
+  schema_ = Schema(Schema::GetMetricName(data_type_),
+                   CsvParser::ToString(header[0]), regions_);
+}
+
+/**
+ * Creates the region of a header column unless an earlier column already did
+ * @param region_name name of region in the column
+ * @param region_index index of the column in the header
+ */
+void DataSet::AddRegionColumn(const std::string& region_name,
+                              size_t region_index) {
+  // Repeated names share the region created for their first column
+  auto inserted = region_to_id_.insert({region_name, region_data_.size()});
+  if (inserted.second)
+    region_data_.emplace_back(region_name, region_index, date_axis_);
 }
 
 /**
- * Extracts numerical data as a float from a string
- * @param num_string string containing numerical information
+ * Resolves every column after the date to the id of its region
+ * @return region id of each column in header order
+ */
+std::vector<size_t> DataSet::MapColumnsToIds() const {
+  std::vector<size_t> column_to_id;
+  for (const std::string& region_name : regions_)
+    column_to_id.push_back(region_to_id_.at(region_name));
+
+  return column_to_id;
+}
+
+/**
+ * Finds the start of the line after the one containing a position
+ * @param position any character of a line
+ * @param end one past the last character of the text
+ * @return first character of the next line, or end if there is none
+ */
+const char* DataSet::FindLineEnd(const char* position, const char* end) {
+  const char* newline = static_cast<const char*>(
+      std::memchr(position, '\n', static_cast<size_t>(end - position)));
+
+  return newline == nullptr ? end : newline + 1;
+}
+
+/**
+ * Finds the end of the rows of a file that are complete enough to import. A
+ * last line without a newline may still be being written, so unless it has a
+ * field for every header column it is left out: a date cut short would be
+ * interned for good. RefreshData() imports the line once it is finished.
+ * @param file_begin first character of the file
+ * @param file_end one past the last character of the file
+ * @return one past the last row to import
+ */
+const char* DataSet::FindCompleteRowsEnd(const char* file_begin,
+                                         const char* file_end) {
+  const char* header_end = CsvParser::FindRowEnd(file_begin, file_end);
+  const char* last_line = file_end;
+  while (last_line > header_end && last_line[-1] != '\n') last_line--;
+  if (last_line == file_end) return file_end;
+
+  std::vector<CsvParser::Field> header_fields;
+  CsvParser header_parser(Span<const char>(
+      file_begin, static_cast<size_t>(header_end - file_begin)));
+  header_parser.ReadRow(header_fields);
+
+  std::vector<CsvParser::Field> last_fields;
+  CsvParser last_parser(Span<const char>(
+      last_line, static_cast<size_t>(file_end - last_line)));
+  last_parser.ReadRow(last_fields);
+
+  return last_fields.size() < header_fields.size() ? last_line : file_end;
+}
+
+/**
+ * Extracts numerical data as a float from a field
+ * @param field field containing numerical information
  * @return numerical information as float
  */
-float DataSet::GetNumberFromString(const std::string& num_string) {
+float DataSet::GetNumberFromString(const coviddata::CsvParser::Field& field) {
   // Empty entries cannot be converted into integers
-  if (num_string.empty())
+  if (field.Empty())
     return kNullAmount;
 
-  std::stringstream num_stringstream(num_string);
-  float num;
-  num_stringstream >> num;
-
-  return num;
+  return ParseFloat(field.begin(), field.end());
 }
 
 
@@ -0,0 +1,173 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/datasetcache.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "coviddata/longformatimporter.h"
+#include "coviddata/snapshot.h"
+
+namespace coviddata {
+
+namespace {
+
+// Returns true if a filename has the extension of a binary snapshot
+bool IsSnapshotFile(const std::string& filename) {
+  const size_t extension_length = std::strlen(kSnapshotExtension);
+  return filename.size() >= extension_length &&
+         filename.compare(filename.size() - extension_length,
+                          extension_length, kSnapshotExtension) == 0;
+}
+
+}  // namespace
+
+/**
+ * Creates an empty cache
+ * @param num_threads number of files loaded at once; 0 uses every hardware
+ *                    thread
+ */
+DataSetCache::DataSetCache(size_t num_threads)
+    : pool_(num_threads), filename_to_result_() {}
+
+/**
+ * Starts loading every file that is not already cached or loading
+ * @param filenames names of files to load
+ */
+void DataSetCache::Preload(const std::vector<std::string>& filenames) {
+  for (const std::string& filename : filenames) Preload(filename);
+}
+
+/**
+ * Starts loading a file if it is not already cached or loading. Files with
+ * the snapshot extension are loaded as snapshots, anything else as a .csv.
+ * @param filename name of file to load
+ */
+void DataSetCache::Preload(const std::string& filename) {
+  FindOrLoad(filename);
+}
+
+/**
+ * Starts loading metrics of a long-format file that are not already cached
+ * or loading. All of them are imported together in a single pass over the
+ * file.
+ * @param filename name of long-format file to load
+ * @param metrics names of the metric columns to load
+ */
+void DataSetCache::PreloadLongFormat(const std::string& filename,
+                                     const std::vector<std::string>& metrics) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::vector<std::string> metrics_to_load;
+  std::vector<std::shared_ptr<LoadPromise>> promises;
+  for (const std::string& metric : metrics) {
+    const std::string key = GetMetricKey(filename, metric);
+    if (filename_to_result_.count(key) != 0) continue;
+
+    auto promise = std::make_shared<LoadPromise>();
+    filename_to_result_.insert({key, promise->get_future().share()});
+    metrics_to_load.push_back(metric);
+    promises.push_back(promise);
+  }
+  if (metrics_to_load.empty()) return;
+
+  pool_.Submit([promises, filename, metrics_to_load] {
+    try {
+      LongFormatImporter importer(metrics_to_load);
+      importer.ImportData(filename);
+      for (size_t metric = 0; metric < metrics_to_load.size(); metric++) {
+        promises[metric]->set_value(
+            importer.GetDataSet(metrics_to_load[metric]));
+      }
+    } catch (...) {
+      for (const std::shared_ptr<LoadPromise>& promise : promises)
+        promise->set_exception(std::current_exception());
+    }
+  });
+}
+
+/**
+ * Creates the key that a metric of a long-format file is cached under
+ * @param filename name of long-format file
+ * @param metric name of metric column
+ * @return key to pass to IsLoaded(), Get() and Wait()
+ */
+std::string DataSetCache::GetMetricKey(const std::string& filename,
+                                       const std::string& metric) {
+  return filename + "#" + metric;
+}
+
+/**
+ * Returns true if a file has finished loading (or failed to load), meaning
+ * Get() will not return null for it
+ * @param filename name of file
+ * @return if the file has finished loading
+ */
+bool DataSetCache::IsLoaded(const std::string& filename) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = filename_to_result_.find(filename);
+  return it != filename_to_result_.end() &&
+         it->second.wait_for(std::chrono::seconds(0)) ==
+             std::future_status::ready;
+}
+
+/**
+ * Retrieves a loaded dataset without blocking; files that were never
+ * preloaded start loading now
+ * @param filename name of file
+ * @return loaded dataset, or null if it is still loading
+ * @throws std::invalid_argument if the file could not be imported
+ */
+std::shared_ptr<DataSet> DataSetCache::Get(const std::string& filename) {
+  LoadResult result = FindOrLoad(filename);
+  if (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return nullptr;
+
+  return result.get();
+}
+
+/**
+ * Retrieves a dataset, blocking until it has loaded
+ * @param filename name of file
+ * @return loaded dataset
+ * @throws std::invalid_argument if the file could not be imported
+ */
+std::shared_ptr<DataSet> DataSetCache::Wait(const std::string& filename) {
+  return FindOrLoad(filename).get();
+}
+
+/**
+ * Retrieves the pending or finished load of a file, starting it if needed
+ * @param filename name of file
+ * @return result of loading the file
+ */
+DataSetCache::LoadResult DataSetCache::FindOrLoad(
+    const std::string& filename) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = filename_to_result_.find(filename);
+  if (it != filename_to_result_.end()) return it->second;
+
+  auto promise = std::make_shared<LoadPromise>();
+  LoadResult result = promise->get_future().share();
+  filename_to_result_.insert({filename, result});
+
+  pool_.Submit([promise, filename] {
+    try {
+      auto data_set = std::make_shared<DataSet>();
+      if (IsSnapshotFile(filename)) {
+        data_set->LoadSnapshot(filename);
+      } else {
+        data_set->ImportData(filename);
+      }
+      promise->set_value(data_set);
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+  });
+
+  return result;
+}
+
+}  // namespace coviddata
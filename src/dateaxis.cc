@@ -0,0 +1,181 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/dateaxis.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace coviddata {
+
+const int32_t DateAxis::kInvalidDay = INT32_MIN;
+
+/**
+ * Default constructor; creates an axis without dates
+ */
+DateAxis::DateAxis()
+    : dates_(), day_numbers_(), date_to_index_(), is_consecutive_(true) {}
+
+/**
+ * Retrieves the index of a date, appending the date if it is new.
+ * @param date date to look up
+ * @return index of the date
+ */
+size_t DateAxis::Intern(const std::string& date) {
+  auto inserted = date_to_index_.insert({date, dates_.size()});
+  if (!inserted.second) return inserted.first->second;
+
+  int32_t day_number = ToDayNumber(date);
+
+  // Arithmetic lookups only hold while every date is the day after the last
+  if (day_number == kInvalidDay ||
+      (!day_numbers_.empty() && day_number != day_numbers_.back() + 1)) {
+    is_consecutive_ = false;
+  }
+
+  dates_.push_back(date);
+  day_numbers_.push_back(day_number);
+  return inserted.first->second;
+}
+
+/**
+ * Retrieves the index of an existing date.
+ * @param date date to look up
+ * @return index of the date
+ * @throws std::out_of_range if the date is not on the axis
+ */
+size_t DateAxis::IndexOf(const std::string& date) const {
+  if (is_consecutive_) {
+    int32_t day_number = ToDayNumber(date);
+    if (day_number != kInvalidDay) {
+      // Out of range days (ex. 2020-02-30) alias a real day, so confirm it
+      size_t date_index = IndexOfDay(day_number);
+      if (dates_[date_index] != date)
+        throw std::out_of_range("Date is not on date axis");
+      return date_index;
+    }
+  }
+
+  return date_to_index_.at(date);
+}
+
+/**
+ * Retrieves the index of an existing date by its day number.
+ * @param day_number days since 1970-01-01
+ * @return index of the date
+ * @throws std::out_of_range if the day is not on the axis
+ */
+size_t DateAxis::IndexOfDay(int32_t day_number) const {
+  if (is_consecutive_) {
+    if (day_numbers_.empty() || day_number < day_numbers_.front() ||
+        day_number > day_numbers_.back()) {
+      throw std::out_of_range("Day is not on date axis");
+    }
+    return static_cast<size_t>(day_number - day_numbers_.front());
+  }
+
+  auto it = std::find(day_numbers_.begin(), day_numbers_.end(), day_number);
+  if (day_number == kInvalidDay || it == day_numbers_.end())
+    throw std::out_of_range("Day is not on date axis");
+
+  return static_cast<size_t>(it - day_numbers_.begin());
+}
+
+/**
+ * Returns true if the date is on the axis.
+ * @param date date to look up
+ * @return if the date is on the axis
+ */
+bool DateAxis::Contains(const std::string& date) const {
+  return date_to_index_.count(date) > 0;
+}
+
+/**
+ * Retrieves the date at an index.
+ * @param date_index index of the date
+ * @return date as a string
+ */
+const std::string& DateAxis::GetDate(size_t date_index) const {
+  return dates_.at(date_index);
+}
+
+/**
+ * Retrieves the day number of the date at an index.
+ * @param date_index index of the date
+ * @return days since 1970-01-01, or kInvalidDay if the date is not in
+ *         [year]-[month]-[day] format
+ */
+int32_t DateAxis::GetDayNumber(size_t date_index) const {
+  return day_numbers_.at(date_index);
+}
+
+/**
+ * Retrieves every date on the axis in index order.
+ * @return vector of dates as strings
+ */
+const std::vector<std::string>& DateAxis::GetDates() const { return dates_; }
+
+/**
+ * Returns the number of dates on the axis.
+ * @return number of dates
+ */
+size_t DateAxis::Size() const { return dates_.size(); }
+
+/**
+ * Returns true if every date is the day after the previous one, which makes
+ * index lookups constant time arithmetic.
+ * @return if the dates are consecutive days
+ */
+bool DateAxis::IsConsecutive() const { return is_consecutive_; }
+
+/**
+ * Removes every date from the axis.
+ */
+void DateAxis::Clear() {
+  dates_.clear();
+  day_numbers_.clear();
+  date_to_index_.clear();
+  is_consecutive_ = true;
+}
+
+// Implementation of days_from_civil by Howard Hinnant:
+// "chrono-Compatible Low-Level Date Algorithms"
+// http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+/**
+ * Packs a date in [year]-[month]-[day] format into a day number.
+ * @param date date as a string (ex. 2020-05-05)
+ * @return days since 1970-01-01, or kInvalidDay if the format does not match
+ */
+int32_t DateAxis::ToDayNumber(const std::string& date) {
+  const size_t iso_date_length = 10;
+  if (date.size() != iso_date_length || date[4] != '-' || date[7] != '-')
+    return kInvalidDay;
+
+  int32_t parts[3] = {0, 0, 0};
+  const size_t part_begin[3] = {0, 5, 8};
+  const size_t part_length[3] = {4, 2, 2};
+
+  for (size_t part = 0; part < 3; part++) {
+    for (size_t i = 0; i < part_length[part]; i++) {
+      char digit = date[part_begin[part] + i];
+      if (digit < '0' || digit > '9') return kInvalidDay;
+      parts[part] = parts[part] * 10 + (digit - '0');
+    }
+  }
+
+  int32_t year = parts[0];
+  int32_t month = parts[1];
+  int32_t day = parts[2];
+  if (month < 1 || month > 12 || day < 1 || day > 31) return kInvalidDay;
+
+  year -= month <= 2 ? 1 : 0;
+  const int32_t era = year / 400;
+  const int32_t year_of_era = year - era * 400;
+  const int32_t day_of_year =
+      (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const int32_t day_of_era =
+      year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+
+  return era * 146097 + day_of_era - 719468;
+}
+
+}  // namespace coviddata
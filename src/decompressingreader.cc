@@ -0,0 +1,324 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/decompressingreader.h"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef COVIDDATA_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef COVIDDATA_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace coviddata {
+
+namespace {
+
+// Returns true if a filename ends with an extension
+bool HasExtension(const std::string& filename, const std::string& extension) {
+  return filename.size() >= extension.size() &&
+         filename.compare(filename.size() - extension.size(),
+                          extension.size(), extension) == 0;
+}
+
+}  // namespace
+
+const size_t DecompressingReader::kDefaultBlockSize;
+const size_t DecompressingReader::kDefaultMaxQueuedBlocks;
+
+/**
+ * Opens a file and starts decompressing it on a producer thread
+ * @param filename name of file; .gz and .zst files are decompressed
+ * @param block_size number of decompressed bytes per block
+ * @param max_queued_blocks number of blocks decompressed ahead of the reader
+ */
+DecompressingReader::DecompressingReader(const std::string& filename,
+                                         size_t block_size,
+                                         size_t max_queued_blocks)
+    : file_(filename, std::ios::binary),
+      compression_(DetectCompression(filename)),
+      block_size_(block_size == 0 ? kDefaultBlockSize : block_size),
+      max_queued_blocks_(max_queued_blocks == 0 ? 1 : max_queued_blocks),
+      fail_(file_.fail() || !IsSupported(compression_)), blocks_(), mutex_(),
+      block_pushed_(), block_popped_(), finished_(false), stopping_(false),
+      error_(), producer_() {
+  if (!fail_) producer_ = std::thread(&DecompressingReader::RunProducer, this);
+}
+
+/**
+ * Stops the producer thread, discarding any blocks not read yet
+ */
+DecompressingReader::~DecompressingReader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  block_popped_.notify_all();
+
+  if (producer_.joinable()) producer_.join();
+}
+
+/**
+ * Takes the next decompressed block, waiting for it if necessary
+ * @param block string to move the block into
+ * @return false once the whole file has been read
+ * @throws std::runtime_error if the file could not be decompressed
+ */
+bool DecompressingReader::ReadBlock(std::string& block) {
+  if (fail_) return false;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  block_pushed_.wait(lock, [this] { return !blocks_.empty() || finished_; });
+
+  if (!blocks_.empty()) {
+    block = std::move(blocks_.front());
+    blocks_.pop();
+    lock.unlock();
+    block_popped_.notify_one();
+    return true;
+  }
+
+  if (error_ != nullptr) std::rethrow_exception(error_);
+  return false;
+}
+
+/**
+ * Returns true if the file could not be opened or its compression is not
+ * supported by this build
+ * @return true if the file cannot be read
+ */
+bool DecompressingReader::Fail() const { return fail_; }
+
+/**
+ * Determines how a file is compressed from its extension
+ * @param filename name of file
+ * @return compression of file
+ */
+DecompressingReader::Compression DecompressingReader::DetectCompression(
+    const std::string& filename) {
+  if (HasExtension(filename, ".gz")) return Compression::kGzip;
+  if (HasExtension(filename, ".zst")) return Compression::kZstd;
+  return Compression::kNone;
+}
+
+/**
+ * Returns true if this build can decompress a kind of compression
+ * @param compression kind of compression
+ * @return if the compression is supported
+ */
+bool DecompressingReader::IsSupported(Compression compression) {
+  switch (compression) {
+    case Compression::kNone:
+      return true;
+    case Compression::kGzip:
+#ifdef COVIDDATA_HAVE_ZLIB
+      return true;
+#else
+      return false;
+#endif
+    case Compression::kZstd:
+#ifdef COVIDDATA_HAVE_ZSTD
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+/**
+ * Decompresses the whole file into the queue, then marks the queue finished.
+ * Errors are handed to the reader through ReadBlock().
+ */
+void DecompressingReader::RunProducer() {
+  try {
+    switch (compression_) {
+      case Compression::kNone:
+        CopyBlocks();
+        break;
+      case Compression::kGzip:
+        InflateGzipBlocks();
+        break;
+      case Compression::kZstd:
+        DecompressZstdBlocks();
+        break;
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_ = std::current_exception();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+  }
+  block_pushed_.notify_all();
+}
+
+/**
+ * Queues an uncompressed file as it is, one block at a time
+ */
+void DecompressingReader::CopyBlocks() {
+  while (true) {
+    std::string block(block_size_, '\0');
+    file_.read(&block[0], static_cast<std::streamsize>(block_size_));
+    block.resize(static_cast<size_t>(file_.gcount()));
+
+    if (block.empty() || !PushBlock(block)) return;
+  }
+}
+
+/**
+ * Inflates a gzip file (including several concatenated gzip members) into
+ * blocks
+ * @throws std::runtime_error if the data is corrupt or truncated
+ */
+void DecompressingReader::InflateGzipBlocks() {
+#ifdef COVIDDATA_HAVE_ZLIB
+  z_stream stream{};
+  // 32 lets zlib detect the gzip header on its own
+  if (inflateInit2(&stream, 15 + 32) != Z_OK)
+    throw std::runtime_error("Could not start gzip decompression");
+
+  std::vector<char> input(block_size_);
+  std::string block(block_size_, '\0');
+  size_t block_used = 0;
+  bool end_of_file = false;
+  bool read_any_input = false;
+  bool member_finished = false;
+
+  try {
+    while (true) {
+      if (stream.avail_in == 0 && !end_of_file) {
+        file_.read(input.data(), static_cast<std::streamsize>(input.size()));
+        stream.next_in = reinterpret_cast<Bytef*>(input.data());
+        stream.avail_in = static_cast<uInt>(file_.gcount());
+        end_of_file = stream.avail_in == 0;
+        read_any_input = read_any_input || !end_of_file;
+      }
+
+      stream.next_out = reinterpret_cast<Bytef*>(&block[block_used]);
+      stream.avail_out = static_cast<uInt>(block_size_ - block_used);
+      int status = inflate(&stream, Z_NO_FLUSH);
+      if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+        throw std::runtime_error("Gzip data is corrupt");
+      block_used = block_size_ - stream.avail_out;
+
+      if (status != Z_BUF_ERROR) member_finished = status == Z_STREAM_END;
+      if (status == Z_STREAM_END) inflateReset(&stream);
+
+      // A full block may leave more output waiting inside zlib
+      const bool block_full = block_used == block_size_;
+      if (block_full) {
+        if (!PushBlock(block)) break;
+        block.assign(block_size_, '\0');
+        block_used = 0;
+      }
+      if (end_of_file && !block_full) break;
+    }
+  } catch (...) {
+    inflateEnd(&stream);
+    throw;
+  }
+  inflateEnd(&stream);
+
+  if (read_any_input && !member_finished && !stopping_)
+    throw std::runtime_error("Gzip data is truncated");
+
+  block.resize(block_used);
+  if (!block.empty()) PushBlock(block);
+#else
+  throw std::runtime_error("Gzip support is not built in");
+#endif
+}
+
+/**
+ * Decompresses a zstd file (including several concatenated frames) into
+ * blocks
+ * @throws std::runtime_error if the data is corrupt or truncated
+ */
+void DecompressingReader::DecompressZstdBlocks() {
+#ifdef COVIDDATA_HAVE_ZSTD
+  ZSTD_DStream* stream = ZSTD_createDStream();
+  if (stream == nullptr || ZSTD_isError(ZSTD_initDStream(stream))) {
+    ZSTD_freeDStream(stream);
+    throw std::runtime_error("Could not start zstd decompression");
+  }
+
+  std::vector<char> input(ZSTD_DStreamInSize());
+  ZSTD_inBuffer in{input.data(), 0, 0};
+  std::string block(block_size_, '\0');
+  ZSTD_outBuffer out{&block[0], block_size_, 0};
+  bool end_of_file = false;
+  // No frame has been started yet, so an empty file is complete
+  bool frame_finished = true;
+
+  try {
+    while (true) {
+      if (in.pos == in.size && !end_of_file) {
+        file_.read(input.data(), static_cast<std::streamsize>(input.size()));
+        in.size = static_cast<size_t>(file_.gcount());
+        in.pos = 0;
+        end_of_file = in.size == 0;
+      }
+      if (end_of_file && frame_finished) break;
+
+      const size_t input_before = in.pos;
+      const size_t output_before = out.pos;
+      const size_t hint = ZSTD_decompressStream(stream, &out, &in);
+      if (ZSTD_isError(hint)) throw std::runtime_error("Zstd data is corrupt");
+
+      // Zero means a frame was completed and fully flushed. A call that
+      // neither consumed nor produced anything returns a nonzero hint even
+      // between frames, so it says nothing about where the data ended.
+      if (in.pos != input_before || out.pos != output_before)
+        frame_finished = hint == 0;
+
+      // A full block may leave more output waiting inside zstd
+      const bool block_full = out.pos == out.size;
+      if (block_full) {
+        if (!PushBlock(block)) break;
+        block.assign(block_size_, '\0');
+        out = ZSTD_outBuffer{&block[0], block_size_, 0};
+      }
+      if (end_of_file && !block_full) break;
+    }
+  } catch (...) {
+    ZSTD_freeDStream(stream);
+    throw;
+  }
+  ZSTD_freeDStream(stream);
+
+  if (!frame_finished && !stopping_)
+    throw std::runtime_error("Zstd data is truncated");
+
+  block.resize(out.pos);
+  if (!block.empty()) PushBlock(block);
+#else
+  throw std::runtime_error("Zstd support is not built in");
+#endif
+}
+
+/**
+ * Hands a block to the reader, waiting while the queue is full
+ * @param block block to move into the queue
+ * @return false if the reader is being destroyed
+ */
+bool DecompressingReader::PushBlock(std::string& block) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  block_popped_.wait(lock, [this] {
+    return blocks_.size() < max_queued_blocks_ || stopping_;
+  });
+  if (stopping_) return false;
+
+  blocks_.push(std::move(block));
+  lock.unlock();
+  block_pushed_.notify_one();
+  return true;
+}
+
+}  // namespace coviddata
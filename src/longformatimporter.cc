@@ -0,0 +1,204 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/longformatimporter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "coviddata/csvparser.h"
+#include "coviddata/numparse.h"
+
+namespace coviddata {
+
+namespace {
+
+const char kLocationColumn[] = "location";
+const char kDateColumn[] = "date";
+
+// Returns true if a field holds exactly the characters of a string
+bool FieldEquals(const CsvParser::Field& field, const std::string& value) {
+  return field.Size() == value.size() &&
+         std::memcmp(field.Data(), value.data(), value.size()) == 0;
+}
+
+}  // namespace
+
+/**
+ * Creates an importer for a set of metrics
+ * @param metrics names of the metric columns to import
+ */
+LongFormatImporter::LongFormatImporter(const std::vector<std::string>& metrics)
+    : metrics_(metrics), data_sets_() {}
+
+/**
+ * Imports every metric from a long-format .csv file in a single pass. Each
+ * row's location and date are looked up once, then its amount for every
+ * metric goes straight into that metric's column for the location.
+ * @param filename name of file to import data from; may be .gz or .zst
+ * @throws std::invalid_argument if the file does not exist or lacks the
+ *         location, date or any metric column
+ */
+void LongFormatImporter::ImportData(const std::string& filename) {
+  data_sets_.clear();
+
+  // Compressed files are streamed; anything else is mapped and read in place
+  CsvParser parser(filename, CsvParser::ReadMode::kMemoryMapped);
+  if (parser.Fail()) throw std::invalid_argument("File does not exist");
+
+  bool has_header = false;
+  size_t location_index = 0;
+  size_t date_index = 0;
+  size_t min_row_size = 0;
+  std::vector<MetricColumns> metric_columns(metrics_.size());
+
+  std::unordered_map<std::string, size_t> location_to_id;
+  std::vector<std::string> regions;
+  DateAxis date_slots;
+
+  // Rows of one location are usually adjacent, so its id is reused
+  std::string last_location;
+  size_t last_location_id = 0;
+
+  parser.ForEachRow([&](size_t row_index, CsvParser::Row row) {
+    // Find the location, date and metric columns from the header line
+    if (row_index == 0) {
+      std::unordered_map<std::string, size_t> column_to_index;
+      for (size_t column = 0; column < row.Size(); column++)
+        column_to_index.insert({CsvParser::ToString(row[column]), column});
+
+      auto location = column_to_index.find(kLocationColumn);
+      auto date = column_to_index.find(kDateColumn);
+      if (location == column_to_index.end() || date == column_to_index.end())
+        throw std::invalid_argument(
+            "File does not contain location and date columns");
+      location_index = location->second;
+      date_index = date->second;
+      min_row_size = std::max(location_index, date_index) + 1;
+      has_header = true;
+
+      for (size_t metric = 0; metric < metrics_.size(); metric++) {
+        auto column = column_to_index.find(metrics_[metric]);
+        if (column == column_to_index.end())
+          throw std::invalid_argument("File does not contain metric " +
+                                      metrics_[metric]);
+        metric_columns[metric].column_index = column->second;
+      }
+      return;
+    }
+
+    if (row.Size() < min_row_size) return;
+
+    const CsvParser::Field& location = row[location_index];
+    if (regions.empty() || !FieldEquals(location, last_location)) {
+      last_location = CsvParser::ToString(location);
+      auto inserted = location_to_id.insert({last_location, regions.size()});
+      if (inserted.second) regions.push_back(last_location);
+      last_location_id = inserted.first->second;
+    }
+
+    const size_t slot =
+        date_slots.Intern(CsvParser::ToString(row[date_index]));
+
+    for (MetricColumns& metric : metric_columns) {
+      if (metric.column_index >= row.Size()) continue;
+      const CsvParser::Field& field = row[metric.column_index];
+      if (field.Empty()) continue;
+
+      if (metric.region_columns.size() <= last_location_id)
+        metric.region_columns.resize(last_location_id + 1);
+      std::vector<float>& column = metric.region_columns[last_location_id];
+      if (column.size() <= slot)
+        column.resize(slot + 1, static_cast<float>(kNullAmount));
+      column[slot] = ParseFloat(field.begin(), field.end());
+    }
+  });
+
+  // Files without any lines never reach the header check above
+  if (!has_header)
+    throw std::invalid_argument(
+        "File does not contain location and date columns");
+
+  // Dates were seen in file order, which is chronological per location only
+  std::vector<size_t> slot_order(date_slots.Size());
+  for (size_t slot = 0; slot < slot_order.size(); slot++)
+    slot_order[slot] = slot;
+  std::sort(slot_order.begin(), slot_order.end(),
+            [&date_slots](size_t x, size_t y) {
+              if (date_slots.GetDayNumber(x) != date_slots.GetDayNumber(y))
+                return date_slots.GetDayNumber(x) < date_slots.GetDayNumber(y);
+              return date_slots.GetDate(x) < date_slots.GetDate(y);
+            });
+
+  for (size_t metric = 0; metric < metrics_.size(); metric++) {
+    data_sets_[metrics_[metric]] =
+        BuildDataSet(filename, metrics_[metric], metric_columns[metric],
+                     regions, date_slots, slot_order);
+  }
+}
+
+/**
+ * Retrieves the names of the imported metrics
+ * @return metric column names
+ */
+const std::vector<std::string>& LongFormatImporter::GetMetrics() const {
+  return metrics_;
+}
+
+/**
+ * Retrieves the dataset of an imported metric
+ * @param metric name of metric column
+ * @return dataset holding the metric for every location
+ * @throws std::out_of_range if the metric was not imported
+ */
+std::shared_ptr<DataSet> LongFormatImporter::GetDataSet(
+    const std::string& metric) const {
+  return data_sets_.at(metric);
+}
+
+/**
+ * Assembles the dataset of one metric from its gathered columns
+ * @param filename name of imported file
+ * @param metric name of the metric
+ * @param metric_columns amounts of the metric by region and date slot
+ * @param regions location names by region id
+ * @param date_slots dates in the order they were first seen
+ * @param slot_order date slots in chronological order
+ * @return dataset of the metric
+ */
+std::shared_ptr<DataSet> LongFormatImporter::BuildDataSet(
+    const std::string& filename, const std::string& metric,
+    const MetricColumns& metric_columns,
+    const std::vector<std::string>& regions, const DateAxis& date_slots,
+    const std::vector<size_t>& slot_order) const {
+  auto data_set = std::make_shared<DataSet>();
+  data_set->data_type_ = filename;
+
+  for (size_t slot : slot_order)
+    data_set->date_axis_->Intern(date_slots.GetDate(slot));
+
+  for (size_t region_id = 0; region_id < regions.size(); region_id++) {
+    data_set->regions_.push_back(regions[region_id]);
+    // Region indices are offset by 1 as if the date were the first column
+    data_set->AddRegionColumn(regions[region_id], region_id + 1);
+
+    RegionData& region_data = data_set->region_data_[region_id];
+    region_data.Resize(slot_order.size());
+    if (region_id >= metric_columns.region_columns.size()) continue;
+
+    const std::vector<float>& column =
+        metric_columns.region_columns[region_id];
+    for (size_t date_index = 0; date_index < slot_order.size();
+         date_index++) {
+      if (slot_order[date_index] < column.size())
+        region_data.SetAmountAtIndex(date_index,
+                                     column[slot_order[date_index]]);
+    }
+  }
+
+  data_set->InferSchemaFromAmounts(metric);
+  data_set->FinishImport();
+  return data_set;
+}
+
+}  // namespace coviddata
@@ -0,0 +1,173 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/mappedfile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace coviddata {
+
+/**
+ * Default constructor; creates an empty mapping
+ */
+MappedFile::MappedFile() : data_(nullptr), size_(0), fail_(false) {}
+
+/**
+ * Maps an entire file into memory for reading.
+ * Empty files succeed with a null Data() and Size() of zero.
+ * @param filename name of file to map
+ */
+MappedFile::MappedFile(const std::string& filename)
+    : data_(nullptr), size_(0), fail_(false) {
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    fail_ = true;
+    return;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    fail_ = true;
+    return;
+  }
+
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  if (size_ == 0) {
+    CloseHandle(file);
+    return;
+  }
+
+  // The view keeps the mapping alive, so both handles can be closed here
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    size_ = 0;
+    fail_ = true;
+    return;
+  }
+
+  data_ = static_cast<const char*>(
+      MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  CloseHandle(mapping);
+  if (data_ == nullptr) {
+    size_ = 0;
+    fail_ = true;
+  }
+#else
+  int file = open(filename.c_str(), O_RDONLY);
+  if (file < 0) {
+    fail_ = true;
+    return;
+  }
+
+  struct stat file_stat {};
+  if (fstat(file, &file_stat) != 0) {
+    close(file);
+    fail_ = true;
+    return;
+  }
+
+  size_ = static_cast<size_t>(file_stat.st_size);
+  if (size_ == 0) {
+    close(file);
+    return;
+  }
+
+  // The mapping stays valid after the descriptor is closed
+  void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+  close(file);
+  if (mapped == MAP_FAILED) {
+    size_ = 0;
+    fail_ = true;
+    return;
+  }
+
+  madvise(mapped, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<const char*>(mapped);
+#endif
+}
+
+/**
+ * Releases the mapping
+ */
+MappedFile::~MappedFile() { Unmap(); }
+
+/**
+ * Takes over the mapping of another file
+ * @param other mapping to move from
+ */
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(other.data_), size_(other.size_), fail_(other.fail_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+/**
+ * Releases the current mapping and takes over the mapping of another file
+ * @param other mapping to move from
+ * @return this mapping
+ */
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    Unmap();
+    data_ = other.data_;
+    size_ = other.size_;
+    fail_ = other.fail_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+/**
+ * Retrieves the first byte of the mapped file
+ * @return pointer to mapped bytes, or null if nothing is mapped
+ */
+const char* MappedFile::Data() const { return data_; }
+
+/**
+ * Returns the number of mapped bytes
+ * @return size of file in bytes
+ */
+size_t MappedFile::Size() const { return size_; }
+
+/**
+ * Returns true if file failed to open or map
+ * @return true if file failed to open or map
+ */
+bool MappedFile::Fail() const { return fail_; }
+
+/**
+ * Unmaps the file if one is mapped
+ */
+void MappedFile::Unmap() {
+  if (data_ == nullptr) return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(data_);
+#else
+  munmap(const_cast<char*>(data_), size_);
+#endif
+
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace coviddata
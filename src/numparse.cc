@@ -0,0 +1,189 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/numparse.h"
+
+#include <cstdint>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COVIDDATA_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COVIDDATA_USE_SSE2
+#endif
+
+#if defined(_MSC_VER) && \
+    (defined(COVIDDATA_USE_AVX2) || defined(COVIDDATA_USE_SSE2))
+#include <intrin.h>
+#endif
+
+namespace coviddata {
+
+namespace {
+
+// Largest integer below which every float-sized mantissa is exact
+const uint64_t kMaxExactFloatMantissa = uint64_t(1) << 24;
+// Mantissas with more digits than this could overflow a uint64_t
+const size_t kMaxFastPathDigits = 19;
+
+// Powers of ten that are exactly representable as a float
+const float kExactPowersOfTen[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                   1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+const size_t kNumExactPowersOfTen =
+    sizeof(kExactPowersOfTen) / sizeof(kExactPowersOfTen[0]);
+
+/**
+ * Parses a number through a stream in the "C" locale; used for anything the
+ * fast path cannot round exactly (exponents, very long mantissas, etc.)
+ * @param begin first character of the field
+ * @param end one past the last character of the field
+ * @return parsed value
+ */
+float ParseFloatWithStream(const char* begin, const char* end) {
+  std::istringstream num_stringstream(std::string(begin, end));
+  num_stringstream.imbue(std::locale::classic());
+
+  float num = 0;
+  num_stringstream >> num;
+  return num;
+}
+
+#if defined(COVIDDATA_USE_AVX2) || defined(COVIDDATA_USE_SSE2)
+/**
+ * Returns the index of the lowest set bit
+ * @param mask non-zero bit mask
+ * @return index of lowest set bit
+ */
+inline size_t CountTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<size_t>(index);
+#else
+  return static_cast<size_t>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * Appends the offset of every set bit of a comparison mask
+ * @param mask one bit per byte that matched the delimiter
+ * @param offset offset of the first byte covered by the mask
+ * @param positions vector of offsets to append to
+ */
+inline void AppendMaskPositions(uint32_t mask, size_t offset,
+                                std::vector<size_t>& positions) {
+  while (mask != 0) {
+    positions.push_back(offset + CountTrailingZeros(mask));
+    mask &= mask - 1;
+  }
+}
+#endif
+
+}  // namespace
+
+/**
+ * Parses a decimal number the same way `std::stringstream >> float` does in
+ * the "C" locale. Plain values such as "-12.75" never allocate; anything else
+ * (whitespace, exponents, trailing text) is handed to a stream so results
+ * always match.
+ * @param begin first character of the field
+ * @param end one past the last character of the field
+ * @return parsed value, or 0 if the field holds no number
+ */
+float ParseFloat(const char* begin, const char* end) {
+  const char* current = begin;
+
+  bool negative = false;
+  if (current != end && (*current == '-' || *current == '+')) {
+    negative = *current == '-';
+    current++;
+  }
+
+  uint64_t mantissa = 0;
+  size_t num_digits = 0;
+  size_t num_fraction_digits = 0;
+
+  while (current != end && *current >= '0' && *current <= '9') {
+    mantissa = mantissa * 10 + static_cast<uint64_t>(*current - '0');
+    num_digits++;
+    current++;
+  }
+
+  if (current != end && *current == '.') {
+    current++;
+    while (current != end && *current >= '0' && *current <= '9') {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*current - '0');
+      num_digits++;
+      num_fraction_digits++;
+      current++;
+    }
+  }
+
+  if (current != end || num_digits == 0 || num_digits > kMaxFastPathDigits)
+    return ParseFloatWithStream(begin, end);
+
+  float magnitude;
+  if (num_fraction_digits == 0) {
+    // A single integer-to-float conversion is correctly rounded
+    magnitude = static_cast<float>(mantissa);
+  } else if (mantissa < kMaxExactFloatMantissa &&
+             num_fraction_digits < kNumExactPowersOfTen) {
+    // Both operands are exact, so one division is correctly rounded
+    magnitude = static_cast<float>(mantissa) /
+                kExactPowersOfTen[num_fraction_digits];
+  } else {
+    return ParseFloatWithStream(begin, end);
+  }
+
+  return negative ? -magnitude : magnitude;
+}
+
+/**
+ * Finds every occurrence of a delimiter in a row, comparing 32 (AVX2) or 16
+ * (SSE2) bytes at a time where the compiler targets those instruction sets.
+ * @param begin first character of the row
+ * @param end one past the last character of the row
+ * @param delimiter character to search for (ex. ',')
+ * @param positions cleared, then filled with the offset of each delimiter
+ *                  from begin in ascending order
+ */
+void FindDelimiters(const char* begin, const char* end, char delimiter,
+                    std::vector<size_t>& positions) {
+  positions.clear();
+
+  const size_t length = static_cast<size_t>(end - begin);
+  size_t offset = 0;
+
+#if defined(COVIDDATA_USE_AVX2)
+  const __m256i delimiters = _mm256_set1_epi8(delimiter);
+  for (; offset + 32 <= length; offset += 32) {
+    __m256i chunk = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(begin + offset));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, delimiters)));
+    AppendMaskPositions(mask, offset, positions);
+  }
+#endif
+
+#if defined(COVIDDATA_USE_AVX2) || defined(COVIDDATA_USE_SSE2)
+  const __m128i narrow_delimiters = _mm_set1_epi8(delimiter);
+  for (; offset + 16 <= length; offset += 16) {
+    __m128i chunk = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(begin + offset));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, narrow_delimiters)));
+    AppendMaskPositions(mask, offset, positions);
+  }
+#endif
+
+  // Scalar fallback, and the tail of the row that does not fill a register
+  for (; offset < length; offset++) {
+    if (begin[offset] == delimiter) positions.push_back(offset);
+  }
+}
+
+}  // namespace coviddata
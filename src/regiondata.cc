@@ -4,13 +4,18 @@
 
 #include "coviddata/regiondata.h"
 
+#include <stdexcept>
+#include <utility>
+
 namespace coviddata {
 
 /**
  * Default constructor
  */
 RegionData::RegionData()
-    : date_to_amount_(), region_name_(), region_index_(0) {}
+    : region_name_(), region_index_(0),
+      date_axis_(std::make_shared<DateAxis>()), amounts_(),
+      borrowed_amounts_(), borrowed_owner_(), stats_() {}
 
 /**
  * Assigns specific region name and index.
@@ -18,10 +23,20 @@ RegionData::RegionData()
  * @param region_index index of region
  */
 RegionData::RegionData(const std::string& region_name, size_t region_index)
-    : date_to_amount_() {
-  region_name_ = region_name;
-  region_index_ = region_index;
-}
+    : RegionData(region_name, region_index, std::make_shared<DateAxis>()) {}
+
+/**
+ * Assigns specific region name and index, storing amounts along a date axis
+ * shared with other regions.
+ * @param region_name name of region
+ * @param region_index index of region
+ * @param date_axis dates shared by the dataset
+ */
+RegionData::RegionData(const std::string& region_name, size_t region_index,
+                       std::shared_ptr<DateAxis> date_axis)
+    : region_name_(region_name), region_index_(region_index),
+      date_axis_(std::move(date_axis)), amounts_(), borrowed_amounts_(),
+      borrowed_owner_(), stats_() {}
 
 /**
  * Stores a desired date/amount key/value pair.
@@ -29,18 +44,97 @@ RegionData::RegionData(const std::string& region_name, size_t region_index)
  * @param amount amount value
  */
 void RegionData::SetAmountToDate(const std::string& date, float amount) {
-  date_to_amount_.insert({date, amount});
+  SetAmountAtIndex(date_axis_->Intern(date), amount);
+}
+
+/**
+ * Stores an amount for the date at an index of the date axis. Any dates
+ * skipped over are filled with kNullAmount.
+ * @param date_index index of date in date axis
+ * @param amount amount value
+ */
+void RegionData::SetAmountAtIndex(size_t date_index, float amount) {
+  CopyBorrowedAmounts();
+  if (date_index >= amounts_.size()) Resize(date_index + 1);
+
+  // Replacing an amount that was already counted means a full recount
+  const bool replaces_amount = !IsNullAmount(amounts_[date_index]);
+  amounts_[date_index] = amount;
+
+  if (replaces_amount) {
+    RecomputeStats();
+  } else {
+    stats_.Add(amount);
+  }
+}
+
+/**
+ * Pads (with kNullAmount) or trims the amounts to a number of dates.
+ * @param num_dates number of dates to hold amounts for
+ */
+void RegionData::Resize(size_t num_dates) {
+  if (num_dates == Size()) return;
+
+  CopyBorrowedAmounts();
+  const bool trims_amounts = num_dates < amounts_.size();
+  amounts_.resize(num_dates, static_cast<float>(kNullAmount));
+
+  if (trims_amounts) RecomputeStats();
 }
 
 /**
  * Retrieves an amount at a specific date.
  * @param date date key to retrieve from
  * @return retrieved amount value
+ * @throws std::out_of_range if the region has no amount for the date
  */
 float RegionData::GetAmountAtDate(const std::string& date) const {
-  return date_to_amount_.at(date);
+  return Amounts().At(date_axis_->IndexOf(date));
+}
+
+/**
+ * Retrieves an amount by the index of its date in the date axis.
+ * @param date_index index of date
+ * @return retrieved amount value
+ * @throws std::out_of_range if the region has no amount for the index
+ */
+float RegionData::GetAmountAtIndex(size_t date_index) const {
+  return Amounts().At(date_index);
+}
+
+/**
+ * Retrieves every amount, ordered by date index.
+ * @return contiguous view of amounts
+ */
+Span<const float> RegionData::GetAmounts() const { return Amounts(); }
+
+/**
+ * Retrieves statistics of every non-null amount without scanning them.
+ * @return statistics of amounts
+ */
+const AmountStats& RegionData::GetStats() const { return stats_; }
+
+/**
+ * Uses amounts stored outside of the region instead of its own, without
+ * copying them.
+ * @param amounts amounts ordered by date index
+ * @param owner handle that keeps the memory of amounts alive
+ */
+void RegionData::BorrowAmounts(Span<const float> amounts,
+                               std::shared_ptr<const void> owner) {
+  amounts_.clear();
+  amounts_.shrink_to_fit();
+  borrowed_amounts_ = amounts;
+  borrowed_owner_ = std::move(owner);
+  RecomputeStats();
 }
 
+/**
+ * Returns true if the amounts are borrowed rather than owned by the region
+ * @return if amounts are borrowed
+ */
+bool RegionData::IsBorrowed() const { return borrowed_owner_ != nullptr; }
+
 /**
  * Retrieves region name.
  * @return region name
@@ -57,20 +151,49 @@ size_t RegionData::GetRegionIndex() const { return region_index_; }
  * Returns the amount of key/value data/amount pairs stored
  * @return number of date/amount pairs
  */
-size_t RegionData::Size() const { return date_to_amount_.size(); }
+size_t RegionData::Size() const { return Amounts().Size(); }
 
 /**
- * Returns list of all dates contained in set
+ * Returns list of all dates contained in set. The list is owned by the date
+ * axis, so no copy is made.
  * @return vector of dates as strings
  */
-std::vector<std::string> RegionData::GetDates() const {
-  std::vector<std::string> dates;
+const std::vector<std::string>& RegionData::GetDates() const {
+  return date_axis_->GetDates();
+}
 
-  for (auto & it : date_to_amount_) {
-    dates.push_back(it.first);
-  }
+/**
+ * Retrieves the date axis that amounts are indexed by.
+ * @return date axis of region
+ */
+const DateAxis& RegionData::GetDateAxis() const { return *date_axis_; }
 
-  return dates;
+/**
+ * Retrieves the amounts in use, whether owned or borrowed
+ * @return contiguous view of amounts
+ */
+Span<const float> RegionData::Amounts() const {
+  if (IsBorrowed()) return borrowed_amounts_;
+  return Span<const float>(amounts_.data(), amounts_.size());
+}
+
+/**
+ * Copies borrowed amounts into the region so that they can be modified
+ */
+void RegionData::CopyBorrowedAmounts() {
+  if (!IsBorrowed()) return;
+
+  amounts_.assign(borrowed_amounts_.begin(), borrowed_amounts_.end());
+  borrowed_amounts_ = Span<const float>();
+  borrowed_owner_.reset();
+}
+
+/**
+ * Recomputes the statistics from every amount
+ */
+void RegionData::RecomputeStats() {
+  stats_ = AmountStats();
+  for (float amount : Amounts()) stats_.Add(amount);
 }
 
 }  // namespace coviddata
@@ -0,0 +1,201 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/regionview.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace coviddata {
+
+/**
+ * Default constructor; view of no dates
+ */
+RegionView::RegionView()
+    : amounts_(), date_axis_(nullptr), first_(0), size_(0), step_(1),
+      spacing_(1), bucket_size_(1), limit_(0),
+      aggregation_(Aggregation::kSum) {}
+
+/**
+ * Views every date of a region, one entry per date
+ * @param region_data region to view; must outlive the view
+ */
+RegionView::RegionView(const RegionData& region_data)
+    : amounts_(region_data.GetAmounts()),
+      date_axis_(&region_data.GetDateAxis()), first_(0),
+      size_(amounts_.Size()), step_(1), spacing_(1), bucket_size_(1),
+      limit_(amounts_.Size()), aggregation_(Aggregation::kSum) {}
+
+/**
+ * Views a range of the entries of this view
+ * @param first index of first entry to keep
+ * @param last one past the index of the last entry to keep
+ * @return view of the range
+ * @throws std::out_of_range if the range is not within this view
+ */
+RegionView RegionView::Range(size_t first, size_t last) const {
+  if (first > last || last > size_)
+    throw std::out_of_range("View range out of range");
+
+  RegionView view = *this;
+  view.first_ = first_ + first * step_;
+  view.size_ = last - first;
+  return view;
+}
+
+/**
+ * Views the last entries of this view, ex. the last 90 days
+ * @param num_entries number of entries to keep; all of them if there are
+ *                    fewer
+ * @return view of the last entries
+ */
+RegionView RegionView::Last(size_t num_entries) const {
+  return Range(size_ - std::min(num_entries, size_), size_);
+}
+
+/**
+ * Views every Nth entry of this view, starting with the first
+ * @param stride number of entries between kept entries
+ * @return strided view
+ * @throws std::invalid_argument if the stride is 0
+ */
+RegionView RegionView::Stride(size_t stride) const {
+  if (stride == 0) throw std::invalid_argument("Stride must be positive");
+
+  RegionView view = *this;
+  view.step_ = step_ * stride;
+  view.size_ = (size_ + stride - 1) / stride;
+  return view;
+}
+
+/**
+ * Combines every bucket of consecutive entries into one, ex. weekly totals
+ * with a bucket size of 7. The last bucket may be partial.
+ * @param bucket_size number of entries per bucket
+ * @param aggregation how the amounts of a bucket are combined
+ * @return downsampled view
+ * @throws std::invalid_argument if the bucket size is 0
+ * @throws std::logic_error if this view is already downsampled
+ */
+RegionView RegionView::Downsample(size_t bucket_size,
+                                  Aggregation aggregation) const {
+  if (bucket_size == 0)
+    throw std::invalid_argument("Bucket size must be positive");
+  if (bucket_size_ != 1)
+    throw std::logic_error("View is already downsampled");
+
+  RegionView view = *this;
+  view.spacing_ = step_;
+  view.step_ = step_ * bucket_size;
+  view.bucket_size_ = bucket_size;
+  view.size_ = (size_ + bucket_size - 1) / bucket_size;
+  view.limit_ = size_ == 0 ? first_ : first_ + (size_ - 1) * step_ + 1;
+  view.aggregation_ = aggregation;
+  return view;
+}
+
+/**
+ * Returns the number of entries in the view
+ * @return number of entries
+ */
+size_t RegionView::Size() const { return size_; }
+
+/**
+ * Returns true if the view has no entries
+ * @return if view is empty
+ */
+bool RegionView::Empty() const { return size_ == 0; }
+
+/**
+ * Computes an entry of the view
+ * @param index index of entry
+ * @return amount of entry, or kNullAmount if it has no data
+ * @throws std::out_of_range if the index is not within the view
+ */
+float RegionView::At(size_t index) const {
+  if (index >= size_) throw std::out_of_range("View index out of range");
+  return (*this)[index];
+}
+
+/**
+ * Computes an entry of the view without checking its index
+ * @param index index of entry
+ * @return amount of entry, or kNullAmount if it has no data
+ */
+float RegionView::operator[](size_t index) const {
+  const size_t start = first_ + index * step_;
+  if (bucket_size_ == 1) return amounts_[start];
+
+  double sum = 0;
+  float max = 0;
+  size_t count = 0;
+
+  for (size_t position = start, member = 0;
+       member < bucket_size_ && position < limit_;
+       member++, position += spacing_) {
+    const float amount = amounts_[position];
+    if (IsNullAmount(amount)) continue;
+
+    sum += amount;
+    max = count == 0 ? amount : std::max(max, amount);
+    count++;
+  }
+
+  if (count == 0) return kNullAmount;
+
+  switch (aggregation_) {
+    case Aggregation::kSum:
+      return static_cast<float>(sum);
+    case Aggregation::kMean:
+      return static_cast<float>(sum / static_cast<double>(count));
+    case Aggregation::kMax:
+      return max;
+  }
+  return kNullAmount;
+}
+
+/**
+ * Returns the date index of an entry; for a bucket, its first date
+ * @param index index of entry
+ * @return index of date along the region's date axis
+ * @throws std::out_of_range if the index is not within the view
+ */
+size_t RegionView::GetDateIndex(size_t index) const {
+  if (index >= size_) throw std::out_of_range("View index out of range");
+  return first_ + index * step_;
+}
+
+/**
+ * Returns the date of an entry; for a bucket, its first date
+ * @param index index of entry
+ * @return date in format [year]-[month]-[day]
+ * @throws std::out_of_range if the index is not within the view
+ */
+const std::string& RegionView::GetDate(size_t index) const {
+  return date_axis_->GetDate(GetDateIndex(index));
+}
+
+/**
+ * Computes statistics of the entries of the view, ex. the highest weekly
+ * total. Unlike RegionData::GetStats(), this reads every entry.
+ * @return statistics of the entries
+ */
+AmountStats RegionView::GetStats() const {
+  AmountStats stats;
+  for (float amount : *this) stats.Add(amount);
+
+  return stats;
+}
+
+/**
+ * Returns an iterator at the first entry
+ * @return iterator at first entry
+ */
+RegionView::Iterator RegionView::begin() const { return Iterator(this, 0); }
+
+/**
+ * Returns an iterator one past the last entry
+ * @return iterator past last entry
+ */
+RegionView::Iterator RegionView::end() const { return Iterator(this, size_); }
+
+}  // namespace coviddata
@@ -0,0 +1,199 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/rollingkernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "coviddata/amountstats.h"
+
+namespace coviddata {
+
+namespace {
+
+const float kUndefinedResult = std::numeric_limits<float>::quiet_NaN();
+const double kPercent = 100.0;
+
+/**
+ * Narrows a defined result to a float that is never taken for a null amount.
+ * A result of exactly kNullAmount (ex. a drop of 1%) is moved to the nearest
+ * float towards zero, which no reader can tell apart from it.
+ */
+float ToDefinedResult(double value) {
+  const auto result = static_cast<float>(value);
+  const auto null_amount = static_cast<float>(kNullAmount);
+  return result >= null_amount && result <= null_amount
+             ? std::nextafter(null_amount, 0.0f)
+             : result;
+}
+
+/**
+ * Running mean and sum of squared deviations (Welford) of the non-null
+ * amounts in a window that slides one day at a time
+ */
+class SlidingWindow {
+ public:
+  SlidingWindow() : count_(0), sum_(0), mean_(0), squares_(0) {}
+
+  void Add(float amount) {
+    if (IsNullAmount(amount)) return;
+
+    count_++;
+    sum_ += amount;
+    const double deviation = amount - mean_;
+    mean_ += deviation / static_cast<double>(count_);
+    squares_ += deviation * (amount - mean_);
+  }
+
+  void Remove(float amount) {
+    if (IsNullAmount(amount)) return;
+
+    count_--;
+    if (count_ == 0) {
+      sum_ = mean_ = squares_ = 0;
+      return;
+    }
+
+    sum_ -= amount;
+    const double deviation = amount - mean_;
+    mean_ -= deviation / static_cast<double>(count_);
+    squares_ = std::max(0.0, squares_ - deviation * (amount - mean_));
+  }
+
+  size_t Count() const { return count_; }
+  double Sum() const { return sum_; }
+  double Mean() const { return mean_; }
+  double SampleVariance() const {
+    return squares_ / static_cast<double>(count_ - 1);
+  }
+
+ private:
+  size_t count_;
+  double sum_;
+  double mean_;
+  double squares_;
+};
+
+/**
+ * Slides a window of the given number of days over amounts, starting far
+ * enough before first to fill it, and reports the window at every day from
+ * first on
+ * @param report called with the day and the window ending at it
+ */
+template <typename Report>
+void SlideWindow(size_t window, Span<const float> amounts, size_t first,
+                 Report report) {
+  const size_t start = first >= window - 1 ? first - (window - 1) : 0;
+
+  SlidingWindow sliding_window;
+  for (size_t day = start; day < amounts.Size(); day++) {
+    sliding_window.Add(amounts[day]);
+    if (day >= start + window) sliding_window.Remove(amounts[day - window]);
+    if (day >= first) report(day, sliding_window);
+  }
+}
+
+/**
+ * Computes a result from the amounts of each day and of the day the window
+ * before it. Days are independent of each other, so the loop has no carried
+ * dependency.
+ * @param compute maps the earlier and later amount to the result; both are
+ *                non-null and the earlier one is positive
+ */
+template <typename Compute>
+void CompareWithWindowAgo(size_t window, Span<const float> amounts,
+                          size_t first, std::vector<float>& results,
+                          Compute compute) {
+  const size_t num_days = amounts.Size();
+  for (size_t day = first; day < std::min(window, num_days); day++)
+    results[day] = kUndefinedResult;
+
+  const float* values = amounts.Data();
+  for (size_t day = std::max(first, window); day < num_days; day++) {
+    const float earlier = values[day - window];
+    const float later = values[day];
+    const bool defined =
+        !IsNullAmount(earlier) && !IsNullAmount(later) && earlier > 0;
+    results[day] = defined ? compute(earlier, later) : kUndefinedResult;
+  }
+}
+
+}  // namespace
+
+/**
+ * Computes a rolling kernel over a column of amounts. Results before first
+ * are kept; the results of every later day are computed in one pass.
+ * @param kernel analytic to compute
+ * @param window number of days the kernel looks back over
+ * @param amounts column of amounts ordered by date index
+ * @param first first day to compute; at most the number of results already
+ *              computed
+ * @param results one result per day; resized to the number of amounts
+ * @throws std::invalid_argument if window is 0
+ */
+void ComputeRollingKernel(RollingKernel kernel, size_t window,
+                          Span<const float> amounts, size_t first,
+                          std::vector<float>& results) {
+  if (window == 0) throw std::invalid_argument("Window must be at least 1");
+
+  first = std::min(first, std::min(results.size(), amounts.Size()));
+  results.resize(amounts.Size());
+  const double days = static_cast<double>(window);
+
+  switch (kernel) {
+    case RollingKernel::kMovingAverage:
+      SlideWindow(window, amounts, first,
+                  [&results](size_t day, const SlidingWindow& sliding_window) {
+                    results[day] =
+                        sliding_window.Count() == 0
+                            ? kUndefinedResult
+                            : ToDefinedResult(
+                                  sliding_window.Sum() /
+                                  static_cast<double>(sliding_window.Count()));
+                  });
+      break;
+
+    case RollingKernel::kGrowthRate:
+      // (later / earlier)^(1 / days) - 1, without losing small rates
+      CompareWithWindowAgo(
+          window, amounts, first, results, [days](float earlier, float later) {
+            return ToDefinedResult(
+                kPercent * std::expm1(std::log(double(later) / earlier) / days));
+          });
+      break;
+
+    case RollingKernel::kDoublingTime:
+      CompareWithWindowAgo(
+          window, amounts, first, results, [days](float earlier, float later) {
+            return later > earlier
+                       ? ToDefinedResult(days * std::log(2.0) /
+                                         std::log(double(later) / earlier))
+                       : kUndefinedResult;
+          });
+      break;
+
+    case RollingKernel::kZScore:
+      SlideWindow(window, amounts, first,
+                  [&results, amounts](size_t day,
+                                      const SlidingWindow& sliding_window) {
+                    const float amount = amounts[day];
+                    if (IsNullAmount(amount) || sliding_window.Count() < 2) {
+                      results[day] = kUndefinedResult;
+                      return;
+                    }
+
+                    const double variance = sliding_window.SampleVariance();
+                    results[day] =
+                        variance > 0
+                            ? ToDefinedResult((amount -
+                                               sliding_window.Mean()) /
+                                              std::sqrt(variance))
+                            : kUndefinedResult;
+                  });
+      break;
+  }
+}
+
+}  // namespace coviddata
@@ -0,0 +1,272 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/schema.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "coviddata/amountstats.h"
+
+namespace coviddata {
+
+namespace {
+
+// Separates a region from the unit it was measured in, in header names
+const char kUnitSeparator[] = " - ";
+
+// Quantities recognized in metric names, in order of precedence
+const char* const kQuantities[] = {"cases", "deaths", "tests"};
+
+/**
+ * Per-capita scales recognized in metric names
+ */
+struct PerCapitaScale {
+  const char* name;
+  double scale;
+};
+
+const PerCapitaScale kPerCapitaScales[] = {{"per million", 1e6},
+                                           {"per thousand", 1e3},
+                                           {"per hundred", 1e2}};
+
+// Returns true if a character is a decimal digit
+bool IsDigit(char character) { return character >= '0' && character <= '9'; }
+
+}  // namespace
+
+const size_t Schema::kSampleRows;
+
+/**
+ * Default constructor; schema of an empty dataset
+ */
+Schema::Schema()
+    : columns_(), metric_(), quantity_(), per_capita_(),
+      per_capita_scale_(1) {}
+
+/**
+ * Creates the schema of a dataset from its metric and column names. Column
+ * types stay unknown until values are sampled.
+ * @param metric metric name, ex. "total_cases_per_million" (see
+ *               GetMetricName for filenames)
+ * @param date_column name of the date column
+ * @param value_columns names of every other column, in header order
+ */
+Schema::Schema(const std::string& metric, const std::string& date_column,
+               const std::vector<std::string>& value_columns)
+    : columns_(), metric_(metric), quantity_(), per_capita_(),
+      per_capita_scale_(1) {
+  std::replace(metric_.begin(), metric_.end(), '_', ' ');
+
+  for (const PerCapitaScale& scale : kPerCapitaScales) {
+    if (metric_.find(scale.name) != std::string::npos) {
+      per_capita_ = scale.name;
+      per_capita_scale_ = scale.scale;
+      break;
+    }
+  }
+
+  for (const char* quantity : kQuantities) {
+    if (metric_.find(quantity) != std::string::npos) {
+      quantity_ = quantity;
+      break;
+    }
+  }
+
+  columns_.push_back({date_column, date_column, "", ColumnType::kUnknown});
+  for (const std::string& name : value_columns) {
+    ColumnSchema column{name, name, "", ColumnType::kUnknown};
+
+    const size_t separator = name.rfind(kUnitSeparator);
+    if (separator != std::string::npos) {
+      column.region = name.substr(0, separator);
+      column.unit = name.substr(separator + sizeof(kUnitSeparator) - 1);
+    }
+
+    // Testing exports name the metric "cumulative total" and put what was
+    // counted in each column's unit
+    if (quantity_.empty() && column.unit.find("test") != std::string::npos)
+      quantity_ = "tests";
+
+    columns_.push_back(column);
+  }
+}
+
+/**
+ * Refines column types from one row of text
+ * @param row fields of a row, in header order
+ */
+void Schema::AddSampleRow(CsvParser::Row row) {
+  const size_t num_columns = std::min(row.Size(), columns_.size());
+  for (size_t column = 0; column < num_columns; column++) {
+    columns_[column].type =
+        MergeTypes(columns_[column].type, ClassifyField(row[column]));
+  }
+}
+
+/**
+ * Refines the type of a value column from an amount that was already
+ * parsed, for datasets that were not imported from text
+ * @param column index of column in the header
+ * @param amount amount of the column; null amounts are skipped
+ * @throws std::out_of_range if the column does not exist
+ */
+void Schema::AddSampleAmount(size_t column, float amount) {
+  ColumnSchema& column_schema = columns_.at(column);
+  if (IsNullAmount(amount)) return;
+
+  const ColumnType sample = std::floor(amount) >= amount
+                                ? ColumnType::kInteger
+                                : ColumnType::kFractional;
+  column_schema.type = MergeTypes(column_schema.type, sample);
+}
+
+/**
+ * Returns the number of columns, including the date column
+ * @return number of columns
+ */
+size_t Schema::Size() const { return columns_.size(); }
+
+/**
+ * Retrieves the metadata of a column
+ * @param column index of column in the header
+ * @return metadata of column
+ * @throws std::out_of_range if the column does not exist
+ */
+const ColumnSchema& Schema::GetColumn(size_t column) const {
+  return columns_.at(column);
+}
+
+/**
+ * Returns the metric in words, ex. "total cases per million"
+ * @return metric of the dataset
+ */
+const std::string& Schema::GetMetric() const { return metric_; }
+
+/**
+ * Returns what the dataset counts: "cases", "deaths", "tests", or an empty
+ * string if the metric does not say
+ * @return quantity of the dataset
+ */
+const std::string& Schema::GetQuantity() const { return quantity_; }
+
+/**
+ * Returns how many people each amount is counted over, ex. 1e6 for amounts
+ * per million people, or 1 for absolute counts
+ * @return per-capita scale of the amounts
+ */
+double Schema::GetPerCapitaScale() const { return per_capita_scale_; }
+
+/**
+ * Returns true if amounts are scaled per capita
+ * @return if the dataset is per capita
+ */
+bool Schema::IsPerCapita() const { return !per_capita_.empty(); }
+
+/**
+ * Combines the types of every value column: kInteger if all sampled amounts
+ * are whole numbers, kFractional if any is not
+ * @return type of the amounts of the dataset
+ */
+ColumnType Schema::GetValueType() const {
+  ColumnType value_type = ColumnType::kUnknown;
+  for (size_t column = 1; column < columns_.size(); column++)
+    value_type = MergeTypes(value_type, columns_[column].type);
+
+  return value_type;
+}
+
+/**
+ * Describes what the amounts of a column count, ex. "cases per million" or
+ * "tests performed per thousand"
+ * @param column index of column in the header
+ * @return unit label, or an empty string if nothing is known
+ * @throws std::out_of_range if the column does not exist
+ */
+std::string Schema::GetUnitLabel(size_t column) const {
+  const ColumnSchema& column_schema = columns_.at(column);
+  std::string label =
+      column_schema.unit.empty() ? quantity_ : column_schema.unit;
+
+  if (!label.empty() && IsPerCapita()) label += " " + per_capita_;
+  return label;
+}
+
+/**
+ * Extracts the metric name of a wide export from its filename, ex.
+ * "data/total_cases.csv.gz" becomes "total_cases"
+ * @param filename name of file
+ * @return filename without its directory and extensions
+ */
+std::string Schema::GetMetricName(const std::string& filename) {
+  const size_t directory = filename.find_last_of("/\\");
+  std::string name = directory == std::string::npos
+                         ? filename
+                         : filename.substr(directory + 1);
+
+  return name.substr(0, name.find('.'));
+}
+
+/**
+ * Determines the type of a single field of text
+ * @param field field to classify
+ * @return kUnknown if the field is empty
+ */
+ColumnType Schema::ClassifyField(CsvParser::Field field) {
+  const char* begin = field.begin();
+  const char* end = field.end();
+  if (begin == end) return ColumnType::kUnknown;
+
+  // Dates are written as [year]-[month]-[day]
+  if (field.Size() == 10 && begin[4] == '-' && begin[7] == '-' &&
+      IsDigit(begin[0]) && IsDigit(begin[1]) && IsDigit(begin[2]) &&
+      IsDigit(begin[3]) && IsDigit(begin[5]) && IsDigit(begin[6]) &&
+      IsDigit(begin[8]) && IsDigit(begin[9]))
+    return ColumnType::kDate;
+
+  const char* current = begin;
+  if (*current == '-' || *current == '+') current++;
+
+  const char* digits_begin = current;
+  while (current != end && IsDigit(*current)) current++;
+  bool has_digits = current != digits_begin;
+  bool is_fractional = false;
+
+  if (current != end && *current == '.') {
+    current++;
+    const char* fraction_begin = current;
+    while (current != end && IsDigit(*current)) current++;
+    has_digits = has_digits || current != fraction_begin;
+    is_fractional = true;
+  }
+
+  if (has_digits && current != end && (*current == 'e' || *current == 'E')) {
+    current++;
+    if (current != end && (*current == '-' || *current == '+')) current++;
+    const char* exponent_begin = current;
+    while (current != end && IsDigit(*current)) current++;
+    if (current == exponent_begin) return ColumnType::kText;
+    is_fractional = true;
+  }
+
+  if (!has_digits || current != end) return ColumnType::kText;
+  return is_fractional ? ColumnType::kFractional : ColumnType::kInteger;
+}
+
+/**
+ * Combines the type seen so far in a column with the type of a new sample
+ * @param seen type of earlier samples
+ * @param sample type of new sample
+ * @return narrowest type that holds both
+ */
+ColumnType Schema::MergeTypes(ColumnType seen, ColumnType sample) {
+  if (sample == ColumnType::kUnknown || seen == sample) return seen;
+  if (seen == ColumnType::kUnknown) return sample;
+
+  const bool both_numbers =
+      (seen == ColumnType::kInteger || seen == ColumnType::kFractional) &&
+      (sample == ColumnType::kInteger || sample == ColumnType::kFractional);
+  return both_numbers ? ColumnType::kFractional : ColumnType::kText;
+}
+
+}  // namespace coviddata
@@ -0,0 +1,66 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include "coviddata/threadpool.h"
+
+namespace coviddata {
+
+/**
+ * Starts the worker threads
+ * @param num_threads number of workers; 0 uses DefaultThreadCount()
+ */
+ThreadPool::ThreadPool(size_t num_threads) : stopping_(false) {
+  if (num_threads == 0) num_threads = DefaultThreadCount();
+
+  for (size_t i = 0; i < num_threads; i++)
+    workers_.emplace_back([this] { RunWorker(); });
+}
+
+/**
+ * Finishes every queued task, then joins the worker threads
+ */
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+
+  for (std::thread& worker : workers_) worker.join();
+}
+
+/**
+ * Returns the number of worker threads
+ * @return number of workers
+ */
+size_t ThreadPool::Size() const { return workers_.size(); }
+
+/**
+ * Returns the number of hardware threads, or 1 if it cannot be determined
+ * @return default number of workers
+ */
+size_t ThreadPool::DefaultThreadCount() {
+  unsigned int hardware_threads = std::thread::hardware_concurrency();
+  return hardware_threads == 0 ? 1 : hardware_threads;
+}
+
+/**
+ * Runs queued tasks until the pool is stopped and the queue is empty
+ */
+void ThreadPool::RunWorker() {
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+      if (stopping_ && tasks_.empty()) return;
+
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+
+    task();
+  }
+}
+
+}  // namespace coviddata
@@ -0,0 +1,80 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <limits>
+#include <vector>
+
+#include "coviddata/amountsearch.h"
+#include "coviddata/amountstats.h"
+#include "coviddata/span.h"
+
+namespace {
+
+coviddata::Span<const float> ToSpan(const std::vector<float>& amounts) {
+  return coviddata::Span<const float>(amounts.data(), amounts.size());
+}
+
+}  // namespace
+
+TEST_CASE("Amount searches skip null amounts") {
+  const float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+  // Long enough to fill several registers and leave a tail
+  std::vector<float> amounts;
+  for (size_t index = 0; index < 37; index++)
+    amounts.push_back(static_cast<float>(index % 10));
+  amounts[5] = coviddata::kNullAmount;
+  amounts[21] = kNaN;
+  amounts[29] = 12;
+  amounts[35] = 12;
+  amounts[36] = 11;
+
+  SECTION("The largest amount is found wherever it is") {
+    REQUIRE(coviddata::FindMaxAmount(ToSpan(amounts)) == 12);
+    REQUIRE(coviddata::FindMaxAmountIndex(ToSpan(amounts)) == 29);
+
+    amounts[36] = 20;
+    REQUIRE(coviddata::FindMaxAmountIndex(ToSpan(amounts)) == 36);
+  }
+
+  SECTION("Negative amounts other than the null amount are found") {
+    const std::vector<float> negative = {-3, coviddata::kNullAmount, -2, kNaN,
+                                         -5};
+    REQUIRE(coviddata::FindMaxAmount(ToSpan(negative)) == -2);
+    REQUIRE(coviddata::FindMaxAmountIndex(ToSpan(negative)) == 2);
+  }
+
+  SECTION("Only null amounts have no maximum") {
+    const std::vector<float> nulls(9, coviddata::kNullAmount);
+    REQUIRE(coviddata::FindMaxAmount(ToSpan(nulls)) == coviddata::kNullAmount);
+    REQUIRE(coviddata::FindMaxAmountIndex(ToSpan(nulls)) == nulls.size());
+    REQUIRE(coviddata::FindMaxAmountIndex(ToSpan({})) == 0);
+  }
+
+  SECTION("The top amounts are ordered largest first") {
+    std::vector<size_t> indices;
+    coviddata::FindTopAmounts(ToSpan(amounts), 4, indices);
+    // Equal amounts are ordered by index
+    REQUIRE(indices == std::vector<size_t>{29, 35, 36, 9});
+
+    coviddata::FindTopAmounts(ToSpan(amounts), 0, indices);
+    REQUIRE(indices.empty());
+  }
+
+  SECTION("The top amounts match a full sort") {
+    std::vector<size_t> indices;
+    coviddata::FindTopAmounts(ToSpan(amounts), 10, indices);
+    REQUIRE(indices.size() == 10);
+    for (size_t rank = 1; rank < indices.size(); rank++)
+      REQUIRE(amounts[indices[rank - 1]] >= amounts[indices[rank]]);
+    REQUIRE(amounts[indices.back()] == 7);
+  }
+
+  SECTION("Fewer amounts are found than asked for if the rest are null") {
+    const std::vector<float> sparse = {coviddata::kNullAmount, 3, kNaN, 1};
+    std::vector<size_t> indices;
+    coviddata::FindTopAmounts(ToSpan(sparse), 3, indices);
+    REQUIRE(indices == std::vector<size_t>{1, 3});
+  }
+}
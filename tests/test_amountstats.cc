@@ -0,0 +1,55 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <limits>
+
+#include "coviddata/amountstats.h"
+
+TEST_CASE("Amount statistics track non-null amounts") {
+  coviddata::AmountStats stats;
+
+  SECTION("Statistics of no amounts are zero") {
+    REQUIRE(stats.GetCount() == 0);
+    REQUIRE(stats.GetMax() == 0);
+    REQUIRE(stats.GetMin() == 0);
+    REQUIRE(stats.GetSum() == 0);
+  }
+
+  SECTION("Added amounts update every statistic") {
+    stats.Add(3);
+    stats.Add(-2);
+    stats.Add(10);
+
+    REQUIRE(stats.GetCount() == 3);
+    REQUIRE(stats.GetMax() == 10);
+    REQUIRE(stats.GetMin() == -2);
+    REQUIRE(stats.GetSum() == 11);
+  }
+
+  SECTION("Null amounts are skipped") {
+    stats.Add(coviddata::kNullAmount);
+    stats.Add(std::numeric_limits<float>::quiet_NaN());
+    stats.Add(5);
+
+    REQUIRE(stats.GetCount() == 1);
+    REQUIRE(stats.GetMin() == 5);
+    REQUIRE(coviddata::IsNullAmount(coviddata::kNullAmount));
+    REQUIRE_FALSE(coviddata::IsNullAmount(0));
+  }
+
+  SECTION("Merged statistics match adding every amount") {
+    coviddata::AmountStats other;
+    other.Add(7);
+    other.Add(1);
+    stats.Add(4);
+
+    stats.Merge(other);
+    stats.Merge(coviddata::AmountStats());
+
+    REQUIRE(stats.GetCount() == 3);
+    REQUIRE(stats.GetMax() == 7);
+    REQUIRE(stats.GetMin() == 1);
+    REQUIRE(stats.GetSum() == 12);
+  }
+}
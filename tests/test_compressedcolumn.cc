@@ -0,0 +1,123 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "coviddata/compressedcolumn.h"
+#include "coviddata/dataset.h"
+
+namespace {
+
+// Compares floats bit for bit, so NaN and -0 must survive exactly
+bool SameBits(const std::vector<float>& x, const std::vector<float>& y) {
+  return x.size() == y.size() &&
+         (x.empty() ||
+          std::memcmp(x.data(), y.data(), x.size() * sizeof(float)) == 0);
+}
+
+std::vector<float> Decode(const coviddata::CompressedColumn& column) {
+  std::vector<float> amounts;
+  column.Decode(amounts);
+  return amounts;
+}
+
+std::vector<float> DecodeByIndex(const coviddata::CompressedColumn& column) {
+  std::vector<float> amounts;
+  for (size_t index = 0; index < column.Size(); index++)
+    amounts.push_back(column.At(index));
+  return amounts;
+}
+
+}  // namespace
+
+TEST_CASE("Compressed columns decode to the original amounts") {
+  SECTION("Empty columns have no blocks") {
+    coviddata::CompressedColumn column(coviddata::Span<const float>{});
+    REQUIRE(column.Size() == 0);
+    REQUIRE(column.GetNumBlocks() == 0);
+    REQUIRE(Decode(column).empty());
+    REQUIRE_THROWS_AS(column.At(0), std::out_of_range);
+  }
+
+  SECTION("Cumulative series round trip across several blocks") {
+    std::vector<float> amounts;
+    for (int day = 0; day < 300; day++)
+      amounts.push_back(static_cast<float>(day * day * 7));
+    amounts[10] = coviddata::kNullAmount;
+
+    coviddata::CompressedColumn column(
+        coviddata::Span<const float>(amounts.data(), amounts.size()));
+    REQUIRE(column.GetNumBlocks() == 3);
+    REQUIRE(SameBits(Decode(column), amounts));
+    REQUIRE(SameBits(DecodeByIndex(column), amounts));
+    REQUIRE(column.GetMemoryUsage() < amounts.size() * sizeof(float));
+  }
+
+  SECTION("Fractional and unusual amounts are kept exactly") {
+    std::vector<float> amounts = {
+        0.5f, -0.0f, 3, std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::infinity(), 1e20f, -7};
+
+    coviddata::CompressedColumn column(
+        coviddata::Span<const float>(amounts.data(), amounts.size()));
+    REQUIRE(SameBits(Decode(column), amounts));
+    REQUIRE(SameBits(DecodeByIndex(column), amounts));
+  }
+
+  SECTION("Blocks decode one at a time") {
+    std::vector<float> amounts(200, 4);
+    amounts[150] = 9;
+    coviddata::CompressedColumn column(
+        coviddata::Span<const float>(amounts.data(), amounts.size()));
+
+    float block[coviddata::CompressedColumn::kBlockSize];
+    REQUIRE(column.DecodeBlock(1, block) == 72);
+    REQUIRE(block[150 - coviddata::CompressedColumn::kBlockSize] == 9);
+    REQUIRE_THROWS_AS(column.DecodeBlock(2, block), std::out_of_range);
+  }
+
+  SECTION("Blocks record the statistics of their amounts") {
+    std::vector<float> amounts(130, coviddata::kNullAmount);
+    amounts[3] = 2;
+    amounts[100] = 8;
+    amounts[129] = 5;
+    coviddata::CompressedColumn column(
+        coviddata::Span<const float>(amounts.data(), amounts.size()));
+
+    REQUIRE(column.GetBlockStats(0).GetCount() == 2);
+    REQUIRE(column.GetBlockStats(0).GetMax() == 8);
+    REQUIRE(column.GetBlockStats(0).GetMin() == 2);
+    REQUIRE(column.GetBlockStats(1).GetMax() == 5);
+  }
+}
+
+TEST_CASE("Compressed columns round trip every bundled dataset") {
+  const std::string data_directory = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\assets\data\)";
+  const std::vector<std::string> data_files = {
+      "total_cases.csv",
+      "cumulative_total_tests.csv",
+      "new_cases.csv",
+      "total_cases_per_million.csv",
+      "daily_change_in_cumulative_total_per_thousand.csv"};
+
+  for (const std::string& data_file : data_files) {
+    INFO("File: " << data_file);
+    coviddata::DataSet data_set;
+    data_set.ImportData(data_directory + data_file);
+
+    for (size_t id = 0; id < data_set.Size(); id++) {
+      coviddata::Span<const float> amounts =
+          data_set.GetRegionDataById(id).GetAmounts();
+      std::vector<float> expected(amounts.begin(), amounts.end());
+
+      coviddata::CompressedColumn column(amounts);
+      REQUIRE(SameBits(Decode(column), expected));
+      REQUIRE(SameBits(DecodeByIndex(column), expected));
+    }
+  }
+}
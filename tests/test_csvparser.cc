@@ -76,4 +76,199 @@ TEST_CASE("CsvParser accurately parses individual values") {
       REQUIRE(second_line.values.at(col) == actual_values.at(col));
     }
   }
-}
\ No newline at end of file
+}
+TEST_CASE("CsvParser reads memory-mapped files row by row") {
+  using Field = coviddata::CsvParser::Field;
+  using ReadMode = coviddata::CsvParser::ReadMode;
+
+  SECTION("Parser fails to map a non-existent file") {
+    coviddata::CsvParser parser("doesn't exist", ReadMode::kMemoryMapped);
+    REQUIRE(parser.Fail());
+  }
+
+  std::string filename = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\test.csv)";
+  coviddata::CsvParser parser(filename, ReadMode::kMemoryMapped);
+  std::vector<Field> fields;
+
+  SECTION("Memory-mapped parser does not copy lines") {
+    REQUIRE_FALSE(parser.Fail());
+    REQUIRE(parser.GetLines().empty());
+  }
+
+  SECTION("Memory-mapped parser reads every row and field") {
+    const std::vector<std::vector<std::string>> actual_rows = {
+        {"date", "World", "United States"},
+        {"2019-12-31", "0", "0"},
+        {"2020-01-01", "20", "10"},
+        {"2020-01-02", "40", "15"}};
+
+    for (const std::vector<std::string>& actual_row : actual_rows) {
+      REQUIRE(parser.ReadRow(fields));
+      REQUIRE(fields.size() == actual_row.size());
+      for (size_t col = 0; col < fields.size(); col++) {
+        REQUIRE(coviddata::CsvParser::ToString(fields.at(col)) ==
+                actual_row.at(col));
+      }
+    }
+
+    REQUIRE_FALSE(parser.ReadRow(fields));
+  }
+
+  SECTION("Rewinding the parser starts again from the header") {
+    while (parser.ReadRow(fields)) {}
+    parser.Rewind();
+
+    REQUIRE(parser.ReadRow(fields));
+    REQUIRE(coviddata::CsvParser::ToString(fields.at(0)) == "date");
+  }
+}
+
+TEST_CASE("CsvParser streams rows to a callback") {
+  using ReadMode = coviddata::CsvParser::ReadMode;
+  using Row = coviddata::CsvParser::Row;
+
+  std::string filename = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\new_cases.csv)";
+  const size_t lines_in_new_cases = 118;
+  const size_t entries_per_line = 208;
+
+  SECTION("Streaming parser fails on a non-existent file") {
+    coviddata::CsvParser parser("doesn't exist", ReadMode::kStreaming);
+    REQUIRE(parser.Fail());
+  }
+
+  SECTION("Every mode visits the same rows in order") {
+    for (ReadMode mode : {ReadMode::kBuffered, ReadMode::kMemoryMapped,
+                          ReadMode::kStreaming}) {
+      coviddata::CsvParser parser(filename, mode);
+      size_t rows_visited = 0;
+
+      parser.ForEachRow([&rows_visited, entries_per_line](size_t row_index,
+                                                          Row row) {
+        REQUIRE(row_index == rows_visited);
+        REQUIRE(row.Size() == entries_per_line);
+        rows_visited++;
+      });
+
+      REQUIRE(rows_visited == lines_in_new_cases);
+    }
+  }
+
+  SECTION("Streamed fields match the buffered values") {
+    coviddata::CsvParser buffered(filename);
+    coviddata::CsvParser streamed(filename, ReadMode::kStreaming);
+
+    streamed.ForEachRow([&buffered](size_t row_index, Row row) {
+      const auto& values = buffered.GetLines().at(row_index).values;
+      for (size_t col = 0; col < row.Size(); col++)
+        REQUIRE(coviddata::CsvParser::ToString(row[col]) == values.at(col));
+    });
+  }
+}
+
+TEST_CASE("CsvParser streams compressed files") {
+  using Field = coviddata::CsvParser::Field;
+  using ReadMode = coviddata::CsvParser::ReadMode;
+
+  std::string filename = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\test.csv.gz)";
+
+#ifdef COVIDDATA_HAVE_ZLIB
+  // Compressed files are streamed whichever mode is asked for
+  coviddata::CsvParser parser(filename, ReadMode::kMemoryMapped);
+  std::vector<Field> fields;
+  REQUIRE_FALSE(parser.Fail());
+
+  const std::vector<std::vector<std::string>> actual_rows = {
+      {"date", "World", "United States"},
+      {"2019-12-31", "0", "0"},
+      {"2020-01-01", "20", "10"},
+      {"2020-01-02", "40", "15"}};
+
+  SECTION("Parser reads every row and field of the decompressed file") {
+    for (const std::vector<std::string>& actual_row : actual_rows) {
+      REQUIRE(parser.ReadRow(fields));
+      REQUIRE(fields.size() == actual_row.size());
+      for (size_t col = 0; col < fields.size(); col++) {
+        REQUIRE(coviddata::CsvParser::ToString(fields.at(col)) ==
+                actual_row.at(col));
+      }
+    }
+
+    REQUIRE_FALSE(parser.ReadRow(fields));
+  }
+
+  SECTION("Rewinding decompresses the file again") {
+    while (parser.ReadRow(fields)) {}
+    parser.Rewind();
+
+    REQUIRE(parser.ReadRow(fields));
+    REQUIRE(coviddata::CsvParser::ToString(fields.at(0)) == "date");
+  }
+#else
+  coviddata::CsvParser parser(filename, ReadMode::kStreaming);
+  REQUIRE(parser.Fail());
+#endif
+}
+
+/*
+ * assets/data/quoted.csv (starts with a byte order mark, lines end in \r\n)
+ *
+ * date,World,"Korea, South","The ""Big"" Island",Chile
+ * 2020-01-01,1,2,3,4
+ * 2020-01-02,"5",6,,8
+ * 2020-01-03,9,"1,000",11,12
+ */
+TEST_CASE("CsvParser tokenizes quoted fields") {
+  using Field = coviddata::CsvParser::Field;
+  using ReadMode = coviddata::CsvParser::ReadMode;
+
+  std::string filename = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\quoted.csv)";
+  const std::vector<std::vector<std::string>> actual_rows = {
+      {"date", "World", "Korea, South", "The \"Big\" Island", "Chile"},
+      {"2020-01-01", "1", "2", "3", "4"},
+      {"2020-01-02", "5", "6", "", "8"},
+      {"2020-01-03", "9", "1,000", "11", "12"}};
+
+  SECTION("Every read mode unquotes the same rows") {
+    for (ReadMode mode : {ReadMode::kBuffered, ReadMode::kMemoryMapped,
+                          ReadMode::kStreaming}) {
+      coviddata::CsvParser parser(filename, mode);
+      std::vector<std::vector<std::string>> rows;
+      parser.ForEachRow([&rows](size_t, coviddata::CsvParser::Row row) {
+        rows.emplace_back();
+        for (const Field& field : row)
+          rows.back().push_back(coviddata::CsvParser::ToString(field));
+      });
+
+      REQUIRE(rows == actual_rows);
+    }
+  }
+
+  SECTION("Quoted fields may span several lines") {
+    const std::string text = "a,\"first\nsecond\",c\r\nd,e,f";
+    coviddata::CsvParser parser(
+        coviddata::Span<const char>(text.data(), text.size()));
+    std::vector<Field> fields;
+
+    REQUIRE(parser.ReadRow(fields));
+    REQUIRE(fields.size() == 3);
+    REQUIRE(coviddata::CsvParser::ToString(fields.at(1)) == "first\nsecond");
+    REQUIRE(coviddata::CsvParser::ToString(fields.at(2)) == "c");
+
+    REQUIRE(parser.ReadRow(fields));
+    REQUIRE(coviddata::CsvParser::ToString(fields.at(0)) == "d");
+    REQUIRE_FALSE(parser.ReadRow(fields));
+  }
+
+  SECTION("Empty and unterminated quoted fields are kept") {
+    const std::string text = "\"\",\"\"\"\",\"open";
+    coviddata::CsvParser parser(
+        coviddata::Span<const char>(text.data(), text.size()));
+    std::vector<Field> fields;
+
+    REQUIRE(parser.ReadRow(fields));
+    REQUIRE(fields.size() == 3);
+    REQUIRE(fields.at(0).Empty());
+    REQUIRE(coviddata::CsvParser::ToString(fields.at(1)) == "\"");
+    REQUIRE(coviddata::CsvParser::ToString(fields.at(2)) == "open");
+  }
+}
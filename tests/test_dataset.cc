@@ -4,6 +4,10 @@
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -95,4 +99,582 @@ TEST_CASE("DataSet accurately parses data in test file") {
       REQUIRE(us_data.GetAmountAtDate(dates.at(i)) == actual_us_amounts.at(i));
     }
   }
+
+  SECTION("Regions are stored by id in order of the header") {
+    for (size_t id = 0; id < actual_regions.size(); id++) {
+      REQUIRE(data_set.GetRegionId(actual_regions.at(id)) == id);
+      REQUIRE(data_set.GetRegionDataById(id).GetRegionName() ==
+              actual_regions.at(id));
+    }
+  }
+
+  SECTION("Every region shares the dataset's date axis") {
+    REQUIRE(data_set.GetDateAxis().GetDates() == dates);
+
+    for (const std::string& region : actual_regions) {
+      REQUIRE(data_set.GetRegionDataByName(region).GetAmounts().Size() ==
+              dates.size());
+    }
+  }
+}
+
+TEST_CASE("DataSet imports identically on several threads") {
+  const std::string test_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv)";
+
+  coviddata::DataSet serial_data_set;
+  REQUIRE(serial_data_set.GetImportThreadCount() == 1);
+  serial_data_set.ImportData(test_file);
+
+  for (size_t num_threads : {2, 3, 8, 0}) {
+    INFO("Threads: " << num_threads);
+    coviddata::DataSet parallel_data_set;
+    parallel_data_set.SetImportThreadCount(num_threads);
+    parallel_data_set.ImportData(test_file);
+
+    REQUIRE(parallel_data_set.GetRegions() == serial_data_set.GetRegions());
+    REQUIRE(parallel_data_set.GetDateAxis().GetDates() ==
+            serial_data_set.GetDateAxis().GetDates());
+
+    for (size_t id = 0; id < serial_data_set.Size(); id++) {
+      coviddata::Span<const float> serial_amounts =
+          serial_data_set.GetRegionDataById(id).GetAmounts();
+      coviddata::Span<const float> parallel_amounts =
+          parallel_data_set.GetRegionDataById(id).GetAmounts();
+
+      REQUIRE(std::equal(serial_amounts.begin(), serial_amounts.end(),
+                         parallel_amounts.begin(), parallel_amounts.end()));
+    }
+  }
+
+  SECTION("Parallel import still rejects a nonexistent file") {
+    coviddata::DataSet parallel_data_set;
+    parallel_data_set.SetImportThreadCount(4);
+    REQUIRE_THROWS(parallel_data_set.ImportData("doesn't exist"));
+  }
+
+  SECTION("Parallel import rejects a line with too many values") {
+    const std::string malformed_file = "test_malformed.csv";
+    {
+      std::ofstream malformed(malformed_file, std::ios::binary);
+      malformed << "date";
+      for (size_t column = 0; column < 200; column++)
+        malformed << ",Region " << column;
+      for (size_t day = 1; day <= 28; day++) {
+        malformed << "\n2020-02-" << (day < 10 ? "0" : "") << day;
+        for (size_t column = 0; column < (day == 1 ? 205 : 200); column++)
+          malformed << ',' << column;
+      }
+      malformed << '\n';
+    }
+
+    coviddata::DataSet parallel_data_set;
+    parallel_data_set.SetImportThreadCount(8);
+    // Checked rather than required, so the file is removed either way
+    CHECK_THROWS_AS(parallel_data_set.ImportData(malformed_file),
+                    std::out_of_range);
+    std::remove(malformed_file.c_str());
+  }
+}
+
+TEST_CASE("DataSet loads regions lazily when asked to") {
+  const std::string test_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\new_cases.csv)";
+
+  coviddata::DataSet eager_data_set;
+  eager_data_set.ImportData(test_file);
+
+  coviddata::DataSet lazy_data_set;
+  lazy_data_set.SetLazyLoading(true);
+  REQUIRE(lazy_data_set.IsLazyLoading());
+  lazy_data_set.ImportData(test_file);
+
+  SECTION("Importing only reads the regions and dates") {
+    REQUIRE(lazy_data_set.GetRegions() == eager_data_set.GetRegions());
+    REQUIRE(lazy_data_set.GetDateAxis().GetDates() ==
+            eager_data_set.GetDateAxis().GetDates());
+    for (size_t id = 0; id < lazy_data_set.Size(); id++)
+      REQUIRE_FALSE(lazy_data_set.IsRegionLoaded(id));
+    REQUIRE(eager_data_set.IsRegionLoaded(0));
+  }
+
+  SECTION("Regions are parsed when first retrieved") {
+    const coviddata::RegionData& lazy_region =
+        lazy_data_set.GetRegionDataByName("Albania");
+    const size_t albania_id = lazy_data_set.GetRegionId("Albania");
+    REQUIRE(lazy_data_set.IsRegionLoaded(albania_id));
+    REQUIRE_FALSE(lazy_data_set.IsRegionLoaded(0));
+
+    coviddata::Span<const float> lazy_amounts = lazy_region.GetAmounts();
+    coviddata::Span<const float> eager_amounts =
+        eager_data_set.GetRegionDataByName("Albania").GetAmounts();
+    REQUIRE(std::equal(eager_amounts.begin(), eager_amounts.end(),
+                       lazy_amounts.begin(), lazy_amounts.end()));
+  }
+
+  SECTION("Every lazily parsed region matches a full import") {
+    for (size_t id = 0; id < eager_data_set.Size(); id++) {
+      coviddata::Span<const float> eager_amounts =
+          eager_data_set.GetRegionDataById(id).GetAmounts();
+      coviddata::Span<const float> lazy_amounts =
+          lazy_data_set.GetRegionDataById(id).GetAmounts();
+      REQUIRE(std::equal(eager_amounts.begin(), eager_amounts.end(),
+                         lazy_amounts.begin(), lazy_amounts.end()));
+    }
+  }
+
+  SECTION("Dataset statistics parse every region") {
+    REQUIRE(lazy_data_set.GetStats(false).GetMax() ==
+            eager_data_set.GetStats(false).GetMax());
+    REQUIRE(lazy_data_set.GetStats().GetCount() ==
+            eager_data_set.GetStats().GetCount());
+    REQUIRE(lazy_data_set.IsRegionLoaded(lazy_data_set.Size() - 1));
+  }
+
+  SECTION("Lazy imports still reject a nonexistent file") {
+    REQUIRE_THROWS_AS(lazy_data_set.ImportData("doesn't exist"),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("DataSet computes statistics while importing") {
+  const std::string test_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv)";
+
+  coviddata::DataSet data_set;
+  data_set.ImportData(test_file);
+
+  // Expected statistics are found by scanning every amount
+  coviddata::AmountStats expected_stats;
+  coviddata::AmountStats expected_stats_excluding_world;
+  for (size_t id = 0; id < data_set.Size(); id++) {
+    const coviddata::RegionData& region = data_set.GetRegionDataById(id);
+    coviddata::AmountStats expected_region_stats;
+    for (float amount : region.GetAmounts()) {
+      expected_region_stats.Add(amount);
+      expected_stats.Add(amount);
+      if (region.GetRegionName() != "World")
+        expected_stats_excluding_world.Add(amount);
+    }
+
+    REQUIRE(region.GetStats().GetMax() == expected_region_stats.GetMax());
+    REQUIRE(region.GetStats().GetMin() == expected_region_stats.GetMin());
+    REQUIRE(region.GetStats().GetCount() == expected_region_stats.GetCount());
+  }
+
+  SECTION("Dataset statistics include every region") {
+    REQUIRE(data_set.GetStats().GetMax() == expected_stats.GetMax());
+    REQUIRE(data_set.GetStats().GetCount() == expected_stats.GetCount());
+    REQUIRE(data_set.GetStats().GetSum() == Approx(expected_stats.GetSum()));
+    REQUIRE(data_set.GetStats().GetMax() ==
+            data_set.GetRegionDataByName("World").GetStats().GetMax());
+  }
+
+  SECTION("Dataset statistics can exclude the world") {
+    const coviddata::AmountStats& stats = data_set.GetStats(false);
+    REQUIRE(stats.GetMax() == expected_stats_excluding_world.GetMax());
+    REQUIRE(stats.GetCount() == expected_stats_excluding_world.GetCount());
+    REQUIRE(stats.GetMax() < data_set.GetStats(true).GetMax());
+  }
+
+  SECTION("Parallel imports and snapshots compute the same statistics") {
+    coviddata::DataSet parallel_data_set;
+    parallel_data_set.SetImportThreadCount(3);
+    parallel_data_set.ImportData(test_file);
+    REQUIRE(parallel_data_set.GetStats(false).GetMax() ==
+            expected_stats_excluding_world.GetMax());
+    REQUIRE(parallel_data_set.GetStats().GetCount() ==
+            expected_stats.GetCount());
+
+    const std::string snapshot_file = "test_stats.cvsnap";
+    data_set.SaveSnapshot(snapshot_file);
+    coviddata::DataSet loaded_data_set;
+    loaded_data_set.LoadSnapshot(snapshot_file);
+    REQUIRE(loaded_data_set.GetStats().GetMax() == expected_stats.GetMax());
+    REQUIRE(loaded_data_set.GetStats().GetCount() ==
+            expected_stats.GetCount());
+    std::remove(snapshot_file.c_str());
+  }
+
+  SECTION("Resetting clears the statistics") {
+    data_set.Reset();
+    REQUIRE(data_set.GetStats().GetCount() == 0);
+  }
+}
+
+TEST_CASE("DataSet refreshes rows appended to its file") {
+  const std::string test_file = "test_refresh.csv";
+  std::ofstream(test_file, std::ios::binary)
+      << "date,World,Albania\n"
+      << "2020-01-01,1,0\n"
+      << "2020-01-02,3,1\n";
+
+  coviddata::DataSet data_set;
+  data_set.ImportData(test_file);
+  REQUIRE(data_set.GetDateAxis().Size() == 2);
+
+  SECTION("Refreshing an unchanged file adds nothing") {
+    REQUIRE(data_set.RefreshData() == 0);
+    REQUIRE(data_set.GetRegionDataByName("World").GetAmountAtIndex(1) == 3);
+  }
+
+  SECTION("Appended rows extend the columns and statistics") {
+    std::ofstream(test_file, std::ios::binary | std::ios::app)
+        << "2020-01-03,8,2\n"
+        << "2020-01-04,,5\n";
+
+    REQUIRE(data_set.RefreshData() == 2);
+    const coviddata::RegionData& world = data_set.GetRegionDataByName("World");
+    REQUIRE(world.Size() == 4);
+    REQUIRE(world.GetAmountAtDate("2020-01-03") == 8);
+    REQUIRE(world.GetAmountAtDate("2020-01-04") == coviddata::kNullAmount);
+    REQUIRE(world.GetStats().GetMax() == 8);
+    REQUIRE(data_set.GetStats(false).GetMax() == 5);
+  }
+
+  SECTION("A partly written last line is completed on the next refresh") {
+    std::ofstream(test_file, std::ios::binary | std::ios::app)
+        << "2020-01-03,8,";
+    REQUIRE(data_set.RefreshData() == 1);
+    REQUIRE(data_set.GetRegionDataByName("Albania")
+                .GetAmountAtDate("2020-01-03") == coviddata::kNullAmount);
+
+    std::ofstream(test_file, std::ios::binary | std::ios::app) << "9\n";
+    REQUIRE(data_set.RefreshData() == 0);
+    REQUIRE(data_set.GetRegionDataByName("Albania")
+                .GetAmountAtDate("2020-01-03") == 9);
+  }
+
+  SECTION("A last line missing columns waits for the next refresh") {
+    std::ofstream(test_file, std::ios::binary | std::ios::app)
+        << "2020-01-03,8";
+    REQUIRE(data_set.RefreshData() == 0);
+    REQUIRE(data_set.GetDateAxis().Size() == 2);
+
+    std::ofstream(test_file, std::ios::binary | std::ios::app) << "0,9\n";
+    REQUIRE(data_set.RefreshData() == 1);
+    REQUIRE(data_set.GetRegionDataByName("World")
+                .GetAmountAtDate("2020-01-03") == 80);
+    REQUIRE(data_set.GetRegionDataByName("Albania").GetStats().GetMax() == 9);
+    REQUIRE(data_set.GetStats().GetMax() == 80);
+  }
+
+  SECTION("Derived regions only compute appended days") {
+    const size_t albania_id = data_set.GetRegionId("Albania");
+    const coviddata::RegionData before = data_set.GetDerivedRegionData(
+        albania_id, coviddata::RollingKernel::kMovingAverage, 2);
+    REQUIRE(before.GetAmountAtIndex(1) == Approx(0.5));
+
+    std::ofstream(test_file, std::ios::binary | std::ios::app)
+        << "2020-01-03,8,5";
+    data_set.RefreshData();
+    REQUIRE(data_set
+                .GetDerivedRegionData(
+                    albania_id, coviddata::RollingKernel::kMovingAverage, 2)
+                .GetAmountAtIndex(2) == 3);
+
+    // The re-parsed last line is computed again
+    std::ofstream(test_file, std::ios::binary | std::ios::app) << "2\n";
+    data_set.RefreshData();
+    const coviddata::RegionData after = data_set.GetDerivedRegionData(
+        albania_id, coviddata::RollingKernel::kMovingAverage, 2);
+    REQUIRE(after.Size() == 3);
+    REQUIRE(after.GetAmountAtIndex(2) == Approx(26.5));
+
+    // Regions retrieved earlier keep their results
+    REQUIRE(before.Size() == 2);
+    REQUIRE(before.GetAmountAtIndex(1) == Approx(0.5));
+  }
+
+  SECTION("A file cut inside a date is refreshed once the date is written") {
+    for (int variant = 0; variant < 3; variant++) {
+      INFO("Variant: " << variant);
+      std::ofstream(test_file, std::ios::binary)
+          << "date,World,Albania\n"
+          << "2020-01-01,1,0\n"
+          << "2020-01-02,3,1\n"
+          << "2020-01-0";
+
+      coviddata::DataSet cut_data_set;
+      cut_data_set.SetImportThreadCount(variant == 1 ? 4 : 1);
+      cut_data_set.SetLazyLoading(variant == 2);
+      cut_data_set.ImportData(test_file);
+      REQUIRE(cut_data_set.GetDateAxis().GetDates() ==
+              std::vector<std::string>{"2020-01-01", "2020-01-02"});
+
+      // Appending more of the date still leaves it out
+      std::ofstream(test_file, std::ios::binary | std::ios::app) << "3";
+      REQUIRE(cut_data_set.RefreshData() == 0);
+
+      std::ofstream(test_file, std::ios::binary | std::ios::app)
+          << ",8,2\n2020-01-0";
+      REQUIRE(cut_data_set.RefreshData() == 1);
+      REQUIRE(cut_data_set.GetDateAxis().GetDates() ==
+              std::vector<std::string>{"2020-01-01", "2020-01-02",
+                                       "2020-01-03"});
+      REQUIRE(cut_data_set.GetRegionDataByName("World")
+                  .GetAmountAtDate("2020-01-03") == 8);
+    }
+  }
+
+  SECTION("A rewritten file is imported again from scratch") {
+    std::ofstream(test_file, std::ios::binary)
+        << "date,World\n"
+        << "2020-02-01,4\n";
+
+    data_set.RefreshData();
+    REQUIRE(data_set.Size() == 1);
+    REQUIRE(data_set.GetDateAxis().GetDates() ==
+            std::vector<std::string>{"2020-02-01"});
+    REQUIRE(data_set.GetStats().GetMax() == 4);
+  }
+
+  SECTION("Only datasets imported from a .csv file can be refreshed") {
+    coviddata::DataSet empty_data_set;
+    REQUIRE_THROWS_AS(empty_data_set.RefreshData(), std::logic_error);
+  }
+
+  std::remove(test_file.c_str());
+}
+
+TEST_CASE("DataSet caches rolling kernels of its regions") {
+  const std::string test_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\test.csv)";
+  using coviddata::RollingKernel;
+
+  for (bool lazy_loading : {false, true}) {
+    INFO("Lazy loading: " << lazy_loading);
+    coviddata::DataSet data_set;
+    data_set.SetLazyLoading(lazy_loading);
+    data_set.ImportData(test_file);
+    const size_t world_id = data_set.GetRegionId("World");
+
+    const coviddata::RegionData growth =
+        data_set.GetDerivedRegionData(world_id, RollingKernel::kGrowthRate, 1);
+    REQUIRE(growth.GetRegionName() == "World");
+    REQUIRE(growth.GetDates() == data_set.GetDateAxis().GetDates());
+    REQUIRE(coviddata::IsNullAmount(growth.GetAmountAtIndex(1)));
+    REQUIRE(growth.GetAmountAtIndex(2) == Approx(100));
+    REQUIRE(growth.GetStats().GetCount() == 1);
+
+    // Results are computed once per region, kernel and window
+    REQUIRE(data_set
+                .GetDerivedRegionData(world_id, RollingKernel::kGrowthRate, 1)
+                .GetAmounts()
+                .Data() == growth.GetAmounts().Data());
+    REQUIRE(data_set
+                .GetDerivedRegionData(world_id, RollingKernel::kGrowthRate, 2)
+                .GetAmounts()
+                .Data() != growth.GetAmounts().Data());
+
+    REQUIRE_THROWS_AS(
+        data_set.GetDerivedRegionData(world_id, RollingKernel::kZScore, 0),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        data_set.GetDerivedRegionData(data_set.Size(), RollingKernel::kZScore, 7),
+        std::out_of_range);
+  }
+}
+
+TEST_CASE("DataSet retrieves every region's amount on a date") {
+  const std::string test_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv)";
+
+  for (bool lazy_loading : {false, true}) {
+    INFO("Lazy loading: " << lazy_loading);
+    coviddata::DataSet data_set;
+    data_set.SetLazyLoading(lazy_loading);
+    data_set.ImportData(test_file);
+
+    const size_t num_dates = data_set.GetDateAxis().Size();
+    for (size_t date_index = 0; date_index < num_dates; date_index++) {
+      const coviddata::Span<const float> amounts =
+          data_set.GetAmountsAtIndex(date_index);
+      REQUIRE(amounts.Size() == data_set.Size());
+      for (size_t region_id = 0; region_id < data_set.Size(); region_id++) {
+        const float amount =
+            data_set.GetRegionDataById(region_id).GetAmountAtIndex(date_index);
+        REQUIRE((amounts[region_id] == amount ||
+                 (coviddata::IsNullAmount(amounts[region_id]) &&
+                  coviddata::IsNullAmount(amount))));
+      }
+    }
+
+    REQUIRE_THROWS_AS(data_set.GetAmountsAtIndex(num_dates),
+                      std::out_of_range);
+  }
+
+  SECTION("Refreshing rebuilds the rows") {
+    const std::string refresh_file = "test_rows.csv";
+    std::ofstream(refresh_file, std::ios::binary)
+        << "date,World,Albania\n"
+        << "2020-01-01,1,0\n";
+
+    coviddata::DataSet data_set;
+    data_set.ImportData(refresh_file);
+    REQUIRE(data_set.GetAmountsAtIndex(0)[1] == 0);
+
+    std::ofstream(refresh_file, std::ios::binary | std::ios::app)
+        << "2020-01-02,3,7\n";
+    data_set.RefreshData();
+    REQUIRE(data_set.GetAmountsAtIndex(1)[1] == 7);
+
+    std::remove(refresh_file.c_str());
+  }
+}
+
+TEST_CASE("DataSet saves and loads binary snapshots") {
+  const std::string test_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv)";
+  const std::string snapshot_file = "test_snapshot.cvsnap";
+
+  coviddata::DataSet imported_data_set;
+  imported_data_set.ImportData(test_file);
+  imported_data_set.SaveSnapshot(snapshot_file);
+
+  SECTION("A loaded snapshot matches the imported file") {
+    coviddata::DataSet loaded_data_set;
+    loaded_data_set.LoadSnapshot(snapshot_file);
+
+    REQUIRE(loaded_data_set.Size() == imported_data_set.Size());
+    REQUIRE(loaded_data_set.GetRegions() == imported_data_set.GetRegions());
+    REQUIRE(loaded_data_set.GetDateAxis().GetDates() ==
+            imported_data_set.GetDateAxis().GetDates());
+
+    for (size_t id = 0; id < imported_data_set.Size(); id++) {
+      const coviddata::RegionData& loaded_region =
+          loaded_data_set.GetRegionDataById(id);
+      coviddata::Span<const float> imported_amounts =
+          imported_data_set.GetRegionDataById(id).GetAmounts();
+      coviddata::Span<const float> loaded_amounts =
+          loaded_region.GetAmounts();
+
+      REQUIRE(loaded_region.IsBorrowed());
+      REQUIRE(loaded_region.GetRegionName() ==
+              imported_data_set.GetRegionDataById(id).GetRegionName());
+      REQUIRE(std::equal(imported_amounts.begin(), imported_amounts.end(),
+                         loaded_amounts.begin(), loaded_amounts.end()));
+    }
+  }
+
+  SECTION("Regions outlive the dataset they were loaded into") {
+    coviddata::RegionData region;
+    {
+      coviddata::DataSet loaded_data_set;
+      loaded_data_set.LoadSnapshot(snapshot_file);
+      region = loaded_data_set.GetRegionDataByName("World");
+    }
+
+    REQUIRE(region.GetAmountAtDate("2020-01-01") ==
+            imported_data_set.GetRegionDataByName("World")
+                .GetAmountAtDate("2020-01-01"));
+  }
+
+  SECTION("Loading rejects files that are not snapshots") {
+    coviddata::DataSet loaded_data_set;
+    REQUIRE_THROWS_AS(loaded_data_set.LoadSnapshot("doesn't exist"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(loaded_data_set.LoadSnapshot(test_file),
+                      std::invalid_argument);
+  }
+
+  SECTION("Loading rejects truncated snapshots") {
+    std::ifstream input(snapshot_file, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(input)),
+                         std::istreambuf_iterator<char>());
+    input.close();
+    std::ofstream(snapshot_file, std::ios::binary)
+        .write(contents.data(),
+               static_cast<std::streamsize>(contents.size() / 2));
+
+    coviddata::DataSet loaded_data_set;
+    REQUIRE_THROWS_AS(loaded_data_set.LoadSnapshot(snapshot_file),
+                      std::invalid_argument);
+  }
+
+  SECTION("Loading rejects amounts that disagree with the null bitmap") {
+    std::ifstream input(snapshot_file, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(input)),
+                         std::istreambuf_iterator<char>());
+    input.close();
+
+    // The bitmap ends the file; its last byte always covers an amount
+    contents.back() = static_cast<char>(contents.back() ^ 1);
+    std::ofstream(snapshot_file, std::ios::binary)
+        .write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+    coviddata::DataSet loaded_data_set;
+    REQUIRE_THROWS_AS(loaded_data_set.LoadSnapshot(snapshot_file),
+                      std::invalid_argument);
+  }
+
+  std::remove(snapshot_file.c_str());
+}
+
+TEST_CASE("DataSet imports compressed .csv files") {
+  const std::string plain_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv)";
+  const std::string gzip_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv.gz)";
+
+#ifdef COVIDDATA_HAVE_ZLIB
+  coviddata::DataSet plain_data_set;
+  plain_data_set.ImportData(plain_file);
+
+  // Lazy and parallel imports fall back to streaming the compressed file
+  for (bool lazy_loading : {false, true}) {
+    INFO("Lazy loading: " << lazy_loading);
+    coviddata::DataSet gzip_data_set;
+    gzip_data_set.SetLazyLoading(lazy_loading);
+    gzip_data_set.SetImportThreadCount(lazy_loading ? 1 : 4);
+    gzip_data_set.ImportData(gzip_file);
+
+    REQUIRE(gzip_data_set.GetRegions() == plain_data_set.GetRegions());
+    REQUIRE(gzip_data_set.GetDateAxis().GetDates() ==
+            plain_data_set.GetDateAxis().GetDates());
+    REQUIRE(gzip_data_set.GetStats().GetSum() ==
+            plain_data_set.GetStats().GetSum());
+
+    for (size_t id = 0; id < plain_data_set.Size(); id++) {
+      coviddata::Span<const float> plain_amounts =
+          plain_data_set.GetRegionDataById(id).GetAmounts();
+      coviddata::Span<const float> gzip_amounts =
+          gzip_data_set.GetRegionDataById(id).GetAmounts();
+
+      REQUIRE(std::equal(plain_amounts.begin(), plain_amounts.end(),
+                         gzip_amounts.begin(), gzip_amounts.end()));
+    }
+  }
+
+  SECTION("Compressed datasets cannot be refreshed") {
+    coviddata::DataSet gzip_data_set;
+    gzip_data_set.ImportData(gzip_file);
+    REQUIRE_THROWS_AS(gzip_data_set.RefreshData(), std::logic_error);
+  }
+#endif
+
+  SECTION("Missing compressed files are rejected") {
+    coviddata::DataSet data_set;
+    REQUIRE_THROWS_AS(data_set.ImportData("doesn't exist.csv.gz"),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("DataSet imports files with quoted region names") {
+  const std::string quoted_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\quoted.csv)";
+
+  // Serial, parallel and lazy imports all tokenize quoted fields
+  for (size_t variant = 0; variant < 3; variant++) {
+    INFO("Import variant: " << variant);
+    coviddata::DataSet data_set;
+    data_set.SetImportThreadCount(variant == 1 ? 4 : 1);
+    data_set.SetLazyLoading(variant == 2);
+    data_set.ImportData(quoted_file);
+
+    const std::vector<std::string> regions = {"World", "Korea, South",
+                                              "The \"Big\" Island", "Chile"};
+    REQUIRE(data_set.GetRegions() == regions);
+    REQUIRE(data_set.GetDateAxis().Size() == 3);
+
+    REQUIRE(data_set.GetRegionDataByName("Korea, South").GetAmountAtIndex(1) ==
+            6);
+    REQUIRE(data_set.GetRegionDataByName("World").GetAmountAtIndex(1) == 5);
+
+    // A quoted comma does not shift the columns after it
+    REQUIRE(data_set.GetRegionDataByName("The \"Big\" Island")
+                .GetAmountAtIndex(2) == 11);
+    REQUIRE(data_set.GetRegionDataByName("Chile").GetAmountAtIndex(2) == 12);
+  }
 }
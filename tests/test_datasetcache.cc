@@ -0,0 +1,75 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "coviddata/datasetcache.h"
+
+TEST_CASE("DataSetCache loads datasets in the background") {
+  const std::string test_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\test.csv)";
+  const std::string total_cases_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv)";
+
+  coviddata::DataSetCache cache(2);
+  cache.Preload(std::vector<std::string>{test_file, total_cases_file});
+
+  SECTION("Waiting returns the imported dataset") {
+    std::shared_ptr<coviddata::DataSet> data_set = cache.Wait(test_file);
+    REQUIRE(data_set != nullptr);
+    REQUIRE(data_set->Size() == 2);
+    REQUIRE(cache.IsLoaded(test_file));
+  }
+
+  SECTION("Loaded datasets are shared rather than reloaded") {
+    std::shared_ptr<coviddata::DataSet> data_set = cache.Wait(total_cases_file);
+    REQUIRE(cache.Get(total_cases_file) == data_set);
+  }
+
+  SECTION("Files that were never preloaded start loading on request") {
+    const std::string new_cases_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\new_cases.csv)";
+    REQUIRE_FALSE(cache.IsLoaded(new_cases_file));
+
+    cache.Get(new_cases_file);
+    REQUIRE(cache.Wait(new_cases_file)->Size() > 0);
+  }
+
+  SECTION("Snapshot files are loaded as snapshots") {
+    const std::string snapshot_file = "test_cache.cvsnap";
+    cache.Wait(test_file)->SaveSnapshot(snapshot_file);
+
+    std::shared_ptr<coviddata::DataSet> data_set = cache.Wait(snapshot_file);
+    REQUIRE(data_set->GetRegions() == cache.Wait(test_file)->GetRegions());
+    REQUIRE(data_set->GetRegionDataById(0).IsBorrowed());
+
+    std::remove(snapshot_file.c_str());
+  }
+
+  SECTION("Metrics of a long-format file are loaded together") {
+    const std::string long_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\owid_long.csv)";
+    cache.PreloadLongFormat(long_file, {"total_cases", "new_cases"});
+
+    const std::string total_cases_key =
+        coviddata::DataSetCache::GetMetricKey(long_file, "total_cases");
+    const std::string new_cases_key =
+        coviddata::DataSetCache::GetMetricKey(long_file, "new_cases");
+    REQUIRE(cache.Wait(total_cases_key)->GetStats().GetMax() == 8);
+    REQUIRE(cache.Wait(new_cases_key)->GetStats().GetMax() == 7);
+  }
+
+  SECTION("Failed long-format loads rethrow for every metric") {
+    cache.PreloadLongFormat("doesn't exist", {"total_cases", "new_cases"});
+    REQUIRE_THROWS_AS(cache.Wait(coviddata::DataSetCache::GetMetricKey(
+                          "doesn't exist", "new_cases")),
+                      std::invalid_argument);
+  }
+
+  SECTION("Failed loads rethrow the import error") {
+    cache.Preload("doesn't exist");
+    REQUIRE_THROWS_AS(cache.Wait("doesn't exist"), std::invalid_argument);
+    REQUIRE(cache.IsLoaded("doesn't exist"));
+  }
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "coviddata/dateaxis.h"
+
+TEST_CASE("DateAxis interns dates in order of appearance") {
+  coviddata::DateAxis date_axis;
+  const std::vector<std::string> dates = {"2019-12-31",
+                                          "2020-01-01",
+                                          "2020-01-02"};
+
+  for (const std::string& date : dates) date_axis.Intern(date);
+
+  SECTION("Each date is stored once") {
+    REQUIRE(date_axis.Size() == dates.size());
+    REQUIRE(date_axis.Intern(dates.at(1)) == 1);
+    REQUIRE(date_axis.Size() == dates.size());
+  }
+
+  SECTION("Dates are indexed in order of appearance") {
+    for (size_t i = 0; i < dates.size(); i++) {
+      REQUIRE(date_axis.IndexOf(dates.at(i)) == i);
+      REQUIRE(date_axis.GetDate(i) == dates.at(i));
+    }
+    REQUIRE(date_axis.GetDates() == dates);
+  }
+
+  SECTION("Looking up a missing date throws") {
+    REQUIRE_FALSE(date_axis.Contains("2020-05-05"));
+    REQUIRE_THROWS_AS(date_axis.IndexOf("2020-05-05"), std::out_of_range);
+  }
+
+  SECTION("Clearing removes every date") {
+    date_axis.Clear();
+    REQUIRE(date_axis.Size() == 0);
+    REQUIRE_FALSE(date_axis.Contains(dates.at(0)));
+  }
+}
+
+TEST_CASE("DateAxis packs dates into day numbers") {
+  SECTION("Dates convert to days since 1970-01-01") {
+    REQUIRE(coviddata::DateAxis::ToDayNumber("1970-01-01") == 0);
+    REQUIRE(coviddata::DateAxis::ToDayNumber("2019-12-31") == 18261);
+    REQUIRE(coviddata::DateAxis::ToDayNumber("2020-03-01") == 18322);
+  }
+
+  SECTION("Dates in other formats have no day number") {
+    REQUIRE(coviddata::DateAxis::ToDayNumber("4/01/20") ==
+            coviddata::DateAxis::kInvalidDay);
+    REQUIRE(coviddata::DateAxis::ToDayNumber("2020-13-01") ==
+            coviddata::DateAxis::kInvalidDay);
+  }
+
+  coviddata::DateAxis date_axis;
+  date_axis.Intern("2020-02-28");
+  date_axis.Intern("2020-02-29");
+  date_axis.Intern("2020-03-01");
+
+  SECTION("Consecutive days are looked up by day number") {
+    REQUIRE(date_axis.IsConsecutive());
+    REQUIRE(date_axis.GetDayNumber(2) ==
+            coviddata::DateAxis::ToDayNumber("2020-03-01"));
+    REQUIRE(date_axis.IndexOfDay(date_axis.GetDayNumber(1)) == 1);
+    REQUIRE(date_axis.IndexOf("2020-03-01") == 2);
+  }
+
+  SECTION("Days that alias a real day are not found") {
+    REQUIRE_THROWS_AS(date_axis.IndexOf("2020-02-30"), std::out_of_range);
+    REQUIRE_THROWS_AS(date_axis.IndexOf("2020-03-02"), std::out_of_range);
+  }
+
+  SECTION("Gaps between days fall back to searching") {
+    date_axis.Intern("2020-03-05");
+
+    REQUIRE_FALSE(date_axis.IsConsecutive());
+    REQUIRE(date_axis.IndexOf("2020-03-05") == 3);
+    REQUIRE(date_axis.IndexOfDay(date_axis.GetDayNumber(3)) == 3);
+  }
+}
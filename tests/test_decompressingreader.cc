@@ -0,0 +1,166 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "coviddata/decompressingreader.h"
+
+namespace {
+
+// Reads a whole file without decompressing it
+std::string ReadFile(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+// Writes a file for a test and removes it once the test is over, whether
+// or not the test passed
+class TemporaryFile {
+ public:
+  TemporaryFile(const std::string& filename, const std::string& contents)
+      : filename_(filename) {
+    std::ofstream(filename_, std::ios::binary) << contents;
+  }
+  ~TemporaryFile() { std::remove(filename_.c_str()); }
+
+  const std::string& GetFilename() const { return filename_; }
+
+ private:
+  std::string filename_;
+};
+
+// Joins every block a reader produces
+std::string ReadAllBlocks(coviddata::DecompressingReader& reader,
+                          size_t& num_blocks) {
+  std::string contents;
+  std::string block;
+  num_blocks = 0;
+  while (reader.ReadBlock(block)) {
+    contents += block;
+    num_blocks++;
+  }
+  return contents;
+}
+
+}  // namespace
+
+TEST_CASE("DecompressingReader streams files in blocks") {
+  using Compression = coviddata::DecompressingReader::Compression;
+
+  const std::string plain_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv)";
+  const std::string gzip_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv.gz)";
+  const std::string zstd_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv.zst)";
+  const std::string plain_contents = ReadFile(plain_file);
+  size_t num_blocks = 0;
+
+  SECTION("Compression is detected from the extension") {
+    using coviddata::DecompressingReader;
+    REQUIRE(DecompressingReader::DetectCompression(plain_file) ==
+            Compression::kNone);
+    REQUIRE(DecompressingReader::DetectCompression(gzip_file) ==
+            Compression::kGzip);
+    REQUIRE(DecompressingReader::DetectCompression(zstd_file) ==
+            Compression::kZstd);
+  }
+
+  SECTION("Reader fails on a non-existent file") {
+    coviddata::DecompressingReader reader("doesn't exist.csv.gz");
+    std::string block;
+    REQUIRE(reader.Fail());
+    REQUIRE_FALSE(reader.ReadBlock(block));
+  }
+
+  SECTION("Uncompressed files are passed through as they are") {
+    coviddata::DecompressingReader reader(plain_file, 1000, 2);
+    REQUIRE(ReadAllBlocks(reader, num_blocks) == plain_contents);
+    REQUIRE(num_blocks == (plain_contents.size() + 999) / 1000);
+  }
+
+#ifdef COVIDDATA_HAVE_ZLIB
+  SECTION("Gzip files decompress to the original file") {
+    coviddata::DecompressingReader reader(gzip_file, 1000, 2);
+    REQUIRE_FALSE(reader.Fail());
+    REQUIRE(ReadAllBlocks(reader, num_blocks) == plain_contents);
+    REQUIRE(num_blocks > 1);
+  }
+
+  SECTION("Concatenated gzip members decompress one after another") {
+    const std::string gzip_contents = ReadFile(gzip_file);
+    const TemporaryFile concatenated_file("test_concatenated.csv.gz",
+                                          gzip_contents + gzip_contents);
+
+    coviddata::DecompressingReader reader(concatenated_file.GetFilename(),
+                                          777);
+    REQUIRE(ReadAllBlocks(reader, num_blocks) ==
+            plain_contents + plain_contents);
+  }
+
+  SECTION("Truncated gzip files are reported by the reader") {
+    const std::string gzip_contents = ReadFile(gzip_file);
+    const TemporaryFile truncated_file(
+        "test_truncated.csv.gz",
+        gzip_contents.substr(0, gzip_contents.size() / 2));
+
+    coviddata::DecompressingReader reader(truncated_file.GetFilename(), 1000);
+    REQUIRE_THROWS_AS(ReadAllBlocks(reader, num_blocks), std::runtime_error);
+  }
+
+  SECTION("Readers can be destroyed before they are finished") {
+    coviddata::DecompressingReader reader(gzip_file, 100, 1);
+    std::string block;
+    REQUIRE(reader.ReadBlock(block));
+    REQUIRE(block == plain_contents.substr(0, 100));
+  }
+#else
+  SECTION("Gzip files fail without zlib") {
+    coviddata::DecompressingReader reader(gzip_file);
+    REQUIRE(reader.Fail());
+  }
+#endif
+
+#ifdef COVIDDATA_HAVE_ZSTD
+  SECTION("Zstd files decompress to the original file") {
+    coviddata::DecompressingReader reader(zstd_file, 1000, 2);
+    REQUIRE_FALSE(reader.Fail());
+    REQUIRE(ReadAllBlocks(reader, num_blocks) == plain_contents);
+    REQUIRE(num_blocks == (plain_contents.size() + 999) / 1000);
+  }
+
+  SECTION("Zstd files decompress with the default block size") {
+    coviddata::DecompressingReader reader(zstd_file);
+    REQUIRE(ReadAllBlocks(reader, num_blocks) == plain_contents);
+  }
+
+  SECTION("Concatenated zstd frames decompress one after another") {
+    const std::string zstd_contents = ReadFile(zstd_file);
+    const TemporaryFile concatenated_file("test_concatenated.csv.zst",
+                                          zstd_contents + zstd_contents);
+
+    coviddata::DecompressingReader reader(concatenated_file.GetFilename(),
+                                          777);
+    REQUIRE(ReadAllBlocks(reader, num_blocks) ==
+            plain_contents + plain_contents);
+  }
+
+  SECTION("Truncated zstd files are reported by the reader") {
+    const std::string zstd_contents = ReadFile(zstd_file);
+    const TemporaryFile truncated_file(
+        "test_truncated.csv.zst",
+        zstd_contents.substr(0, zstd_contents.size() / 2));
+
+    coviddata::DecompressingReader reader(truncated_file.GetFilename(), 1000);
+    REQUIRE_THROWS_AS(ReadAllBlocks(reader, num_blocks), std::runtime_error);
+  }
+#else
+  SECTION("Zstd files fail without zstd") {
+    coviddata::DecompressingReader reader(zstd_file);
+    REQUIRE(reader.Fail());
+  }
+#endif
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "coviddata/longformatimporter.h"
+
+TEST_CASE("Long-format files are pivoted into one dataset per metric") {
+  const std::string test_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\owid_long.csv)";
+
+  coviddata::LongFormatImporter importer(
+      {"total_cases", "new_cases", "total_tests"});
+  importer.ImportData(test_file);
+
+  std::shared_ptr<coviddata::DataSet> total_cases =
+      importer.GetDataSet("total_cases");
+
+  SECTION("Locations become regions in order of first appearance") {
+    std::vector<std::string> expected_regions = {"Afghanistan", "Albania",
+                                                 "World"};
+    REQUIRE(total_cases->GetRegions() == expected_regions);
+    REQUIRE(total_cases->GetRegionId("World") == 2);
+  }
+
+  SECTION("Dates are shared and ordered chronologically") {
+    std::vector<std::string> expected_dates = {"2019-12-31", "2020-01-01",
+                                               "2020-01-02", "2020-01-03"};
+    REQUIRE(total_cases->GetDateAxis().GetDates() == expected_dates);
+    REQUIRE(importer.GetDataSet("total_tests")->GetDateAxis().GetDates() ==
+            expected_dates);
+  }
+
+  SECTION("Amounts are stored by region and date") {
+    const coviddata::RegionData& afghanistan =
+        total_cases->GetRegionDataByName("Afghanistan");
+    REQUIRE(afghanistan.Size() == 4);
+    REQUIRE(afghanistan.GetAmountAtDate("2019-12-31") ==
+            coviddata::kNullAmount);
+    REQUIRE(afghanistan.GetAmountAtDate("2020-01-02") == 3);
+
+    const coviddata::RegionData& albania =
+        importer.GetDataSet("new_cases")->GetRegionDataByName("Albania");
+    REQUIRE(albania.GetAmountAtDate("2020-01-01") == coviddata::kNullAmount);
+    REQUIRE(albania.GetAmountAtDate("2020-01-02") == 5);
+  }
+
+  SECTION("Missing amounts are null") {
+    std::shared_ptr<coviddata::DataSet> total_tests =
+        importer.GetDataSet("total_tests");
+    REQUIRE(total_tests->GetRegionDataByName("Albania")
+                .GetAmountAtDate("2020-01-02") == 7.5f);
+    REQUIRE(total_tests->GetRegionDataByName("World").GetStats().GetCount() ==
+            0);
+  }
+
+  SECTION("Statistics are computed for every metric") {
+    REQUIRE(total_cases->GetStats().GetMax() == 8);
+    REQUIRE(total_cases->GetStats(false).GetMax() == 5);
+    REQUIRE(importer.GetDataSet("new_cases")->GetStats().GetSum() == 16);
+  }
+
+  SECTION("Only imported metrics can be retrieved") {
+    REQUIRE(importer.GetMetrics().size() == 3);
+    REQUIRE_THROWS_AS(importer.GetDataSet("new_deaths"), std::out_of_range);
+  }
+}
+
+TEST_CASE("Long-format import rejects unsuitable files") {
+  const std::string wide_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\test.csv)";
+  const std::string test_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\owid_long.csv)";
+
+  SECTION("Nonexistent files throw") {
+    coviddata::LongFormatImporter importer({"total_cases"});
+    REQUIRE_THROWS_AS(importer.ImportData("doesn't exist"),
+                      std::invalid_argument);
+  }
+
+  SECTION("Files without location and date columns throw") {
+    coviddata::LongFormatImporter importer({"World"});
+    REQUIRE_THROWS_AS(importer.ImportData(wide_file), std::invalid_argument);
+  }
+
+  SECTION("Files without a requested metric throw") {
+    coviddata::LongFormatImporter importer({"total_cases", "new_deaths"});
+    REQUIRE_THROWS_AS(importer.ImportData(test_file), std::invalid_argument);
+  }
+}
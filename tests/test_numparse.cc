@@ -0,0 +1,116 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "coviddata/csvparser.h"
+#include "coviddata/numparse.h"
+
+namespace {
+
+// The parser DataSet used before ParseFloat, kept as the reference
+float ParseWithStringStream(const std::string& num_string) {
+  std::stringstream num_stringstream(num_string);
+  float num = 0;
+  num_stringstream >> num;
+  return num;
+}
+
+// Compares bit patterns so -0.0f and 0.0f are told apart
+bool SameFloat(float x, float y) {
+  return std::memcmp(&x, &y, sizeof(float)) == 0;
+}
+
+float Parse(const std::string& num_string) {
+  return coviddata::ParseFloat(num_string.data(),
+                               num_string.data() + num_string.size());
+}
+
+}  // namespace
+
+TEST_CASE("ParseFloat matches stringstream on individual values") {
+  const std::vector<std::string> values = {
+      "0",       "27",        "-5",         "+12",        "0.5",
+      "1234.567", "-0.0",     "3662691",    "16777217",   "123456789.123",
+      "0.000001", "1e5",      " 42",        "42abc",      "abc",
+      "-",        ".",        "12345678901234567890123", "7.",  ".25"};
+
+  for (const std::string& value : values) {
+    INFO("Value: " << value);
+    REQUIRE(SameFloat(Parse(value), ParseWithStringStream(value)));
+  }
+}
+
+TEST_CASE("ParseFloat matches stringstream on every bundled dataset") {
+  const std::string data_directory = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\assets\data\)";
+  const std::vector<std::string> data_files = {
+      "total_cases.csv",
+      "total_deaths.csv",
+      "new_cases.csv",
+      "new_deaths.csv",
+      "cumulative_total_tests.csv",
+      "daily_change_in_cumulative_total.csv",
+      "total_cases_per_million.csv",
+      "total_deaths_per_million.csv",
+      "new_cases_per_million.csv",
+      "new_deaths_per_million.csv",
+      "cumulative_total_per_thousand.csv",
+      "daily_change_in_cumulative_total_per_thousand.csv"};
+
+  for (const std::string& data_file : data_files) {
+    INFO("File: " << data_file);
+    coviddata::CsvParser parser(data_directory + data_file);
+    REQUIRE_FALSE(parser.Fail());
+
+    size_t values_compared = 0;
+    size_t mismatches = 0;
+
+    // Skip the header and the date column, as DataSet does
+    const auto& lines = parser.GetLines();
+    for (size_t line_num = 1; line_num < lines.size(); line_num++) {
+      const auto& values = lines.at(line_num).values;
+      for (size_t col = 1; col < values.size(); col++) {
+        if (values.at(col).empty()) continue;
+
+        values_compared++;
+        if (!SameFloat(Parse(values.at(col)),
+                       ParseWithStringStream(values.at(col)))) {
+          mismatches++;
+        }
+      }
+    }
+
+    REQUIRE(values_compared > 0);
+    REQUIRE(mismatches == 0);
+  }
+}
+
+TEST_CASE("FindDelimiters finds every comma in a row") {
+  std::vector<size_t> positions;
+
+  SECTION("Rows without delimiters have no positions") {
+    const std::string row = "no delimiters here";
+    coviddata::FindDelimiters(row.data(), row.data() + row.size(), ',',
+                              positions);
+    REQUIRE(positions.empty());
+  }
+
+  SECTION("Positions match a character-by-character scan") {
+    // Long enough to cover whole vector registers and a scalar tail
+    std::string row;
+    for (size_t i = 0; i < 100; i++) row += (i % 3 == 0) ? ",," : "12.5";
+
+    std::vector<size_t> actual_positions;
+    for (size_t i = 0; i < row.size(); i++) {
+      if (row[i] == ',') actual_positions.push_back(i);
+    }
+
+    coviddata::FindDelimiters(row.data(), row.data() + row.size(), ',',
+                              positions);
+    REQUIRE(positions == actual_positions);
+  }
+}
@@ -5,6 +5,9 @@
 #include <catch2/catch.hpp>
 #include <string>
 #include <sstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 #include "coviddata/regiondata.h"
 
@@ -50,4 +53,111 @@ TEST_CASE("Regional data reads and writes correctly") {
       REQUIRE(region_data.GetAmountAtDate(date.str()) == amount);
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Regional data stores amounts contiguously by date index") {
+  auto date_axis = std::make_shared<coviddata::DateAxis>();
+  coviddata::RegionData first_region("World", 1, date_axis);
+  coviddata::RegionData second_region("USA", 2, date_axis);
+
+  SECTION("Regions sharing a date axis intern each date once") {
+    first_region.SetAmountToDate("2020-01-01", 10);
+    second_region.SetAmountToDate("2020-01-01", 5);
+    second_region.SetAmountToDate("2020-01-02", 7);
+
+    REQUIRE(date_axis->Size() == 2);
+    REQUIRE(second_region.GetAmountAtDate("2020-01-02") == 7);
+  }
+
+  SECTION("Amounts are laid out in date index order") {
+    first_region.SetAmountAtIndex(0, 1);
+    first_region.SetAmountAtIndex(1, 2);
+
+    coviddata::Span<const float> amounts = first_region.GetAmounts();
+    REQUIRE(amounts.Size() == 2);
+    REQUIRE(amounts[0] == 1);
+    REQUIRE(amounts[1] == 2);
+  }
+
+  SECTION("Amounts are retrieved by date index") {
+    first_region.SetAmountToDate("2020-01-01", 10);
+    first_region.SetAmountToDate("2020-01-02", 20);
+
+    REQUIRE(first_region.GetAmountAtIndex(1) == 20);
+    REQUIRE(&first_region.GetDates() == &second_region.GetDates());
+    REQUIRE_THROWS_AS(first_region.GetAmountAtIndex(2), std::out_of_range);
+  }
+
+  SECTION("Skipped dates are filled with the null amount") {
+    first_region.SetAmountAtIndex(2, 3);
+
+    REQUIRE(first_region.Size() == 3);
+    REQUIRE(first_region.GetAmounts()[0] == coviddata::kNullAmount);
+    REQUIRE(first_region.GetAmounts()[1] == coviddata::kNullAmount);
+  }
+}
+
+TEST_CASE("Regional data can borrow amounts it does not own") {
+  auto amounts = std::make_shared<std::vector<float>>(
+      std::vector<float>{1, 2, 3});
+  coviddata::RegionData region("region", 1);
+  region.BorrowAmounts(
+      coviddata::Span<const float>(amounts->data(), amounts->size()),
+      amounts);
+
+  SECTION("Borrowed amounts are read in place") {
+    REQUIRE(region.IsBorrowed());
+    REQUIRE(region.Size() == 3);
+    REQUIRE(region.GetAmounts().Data() == amounts->data());
+    REQUIRE(region.GetAmountAtIndex(2) == 3);
+    REQUIRE_THROWS_AS(region.GetAmountAtIndex(3), std::out_of_range);
+  }
+
+  SECTION("Copies of the region keep the borrowed memory alive") {
+    coviddata::RegionData copy = region;
+    REQUIRE(amounts.use_count() == 3);
+    REQUIRE(copy.GetAmounts().Data() == amounts->data());
+  }
+
+  SECTION("Modifying a region copies its borrowed amounts first") {
+    region.SetAmountAtIndex(3, 4);
+
+    REQUIRE_FALSE(region.IsBorrowed());
+    REQUIRE(amounts.use_count() == 1);
+    REQUIRE(amounts->size() == 3);
+    REQUIRE(region.Size() == 4);
+    REQUIRE(region.GetAmountAtIndex(0) == 1);
+    REQUIRE(region.GetAmountAtIndex(3) == 4);
+  }
+}
+
+TEST_CASE("Regional data keeps statistics of its amounts") {
+  coviddata::RegionData region("region", 1);
+  region.SetAmountAtIndex(0, 4);
+  region.SetAmountAtIndex(2, 9);
+  region.SetAmountAtIndex(1, 2);
+
+  SECTION("Statistics skip null amounts") {
+    region.SetAmountAtIndex(4, coviddata::kNullAmount);
+
+    REQUIRE(region.GetStats().GetCount() == 3);
+    REQUIRE(region.GetStats().GetMax() == 9);
+    REQUIRE(region.GetStats().GetMin() == 2);
+    REQUIRE(region.GetStats().GetSum() == 15);
+  }
+
+  SECTION("Replacing an amount updates statistics") {
+    region.SetAmountAtIndex(2, 1);
+
+    REQUIRE(region.GetStats().GetCount() == 3);
+    REQUIRE(region.GetStats().GetMax() == 4);
+    REQUIRE(region.GetStats().GetMin() == 1);
+  }
+
+  SECTION("Trimming amounts updates statistics") {
+    region.Resize(1);
+
+    REQUIRE(region.GetStats().GetCount() == 1);
+    REQUIRE(region.GetStats().GetMax() == 4);
+  }
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "coviddata/regiondata.h"
+#include "coviddata/regionview.h"
+
+namespace {
+
+// Copies the entries of a view
+std::vector<float> ToVector(const coviddata::RegionView& view) {
+  return std::vector<float>(view.begin(), view.end());
+}
+
+}  // namespace
+
+TEST_CASE("RegionView slices and downsamples without copying") {
+  using coviddata::Aggregation;
+
+  // Amounts 1, 2, ..., 10 on 2020-01-01 to 2020-01-10; the 4th is missing
+  coviddata::RegionData region_data("Test", 1);
+  for (int day = 1; day <= 10; day++) {
+    const std::string date = "2020-01-" + std::string(day < 10 ? "0" : "") +
+                             std::to_string(day);
+    region_data.SetAmountToDate(
+        date, day == 4 ? coviddata::kNullAmount : static_cast<float>(day));
+  }
+  const coviddata::RegionView view(region_data);
+
+  SECTION("A region's view holds every date") {
+    REQUIRE(view.Size() == 10);
+    REQUIRE(view.At(0) == 1);
+    REQUIRE(view.GetDate(9) == "2020-01-10");
+    REQUIRE(view.At(3) == coviddata::kNullAmount);
+    REQUIRE_THROWS_AS(view.At(10), std::out_of_range);
+  }
+
+  SECTION("Ranges keep their dates") {
+    coviddata::RegionView range = view.Range(4, 7);
+    REQUIRE(ToVector(range) == std::vector<float>{5, 6, 7});
+    REQUIRE(range.GetDate(0) == "2020-01-05");
+    REQUIRE(range.GetDateIndex(2) == 6);
+
+    REQUIRE(ToVector(view.Last(3)) == std::vector<float>{8, 9, 10});
+    REQUIRE(view.Last(20).Size() == 10);
+    REQUIRE_THROWS_AS(view.Range(5, 11), std::out_of_range);
+  }
+
+  SECTION("Strides keep every Nth date") {
+    REQUIRE(ToVector(view.Stride(3)) == std::vector<float>{1, -1, 7, 10});
+    REQUIRE(ToVector(view.Range(1, 9).Stride(4)) ==
+            std::vector<float>{2, 6});
+    REQUIRE_THROWS_AS(view.Stride(0), std::invalid_argument);
+  }
+
+  SECTION("Buckets are summed, averaged or maximized skipping null amounts") {
+    REQUIRE(ToVector(view.Downsample(4, Aggregation::kSum)) ==
+            std::vector<float>{6, 26, 19});
+    REQUIRE(ToVector(view.Downsample(4, Aggregation::kMean)) ==
+            std::vector<float>{2, 6.5f, 9.5f});
+    REQUIRE(ToVector(view.Downsample(4, Aggregation::kMax)) ==
+            std::vector<float>{3, 8, 10});
+    REQUIRE(view.Downsample(4, Aggregation::kSum).GetDate(1) == "2020-01-05");
+  }
+
+  SECTION("Buckets stop at the end of the view they were made from") {
+    coviddata::RegionView weekly =
+        view.Range(0, 9).Downsample(7, Aggregation::kSum);
+    REQUIRE(ToVector(weekly) == std::vector<float>{24, 17});
+
+    // Strided buckets combine every other date
+    REQUIRE(ToVector(view.Stride(2).Downsample(2, Aggregation::kSum)) ==
+            std::vector<float>{4, 12, 9});
+  }
+
+  SECTION("Downsampled views can still be sliced") {
+    coviddata::RegionView sums = view.Downsample(2, Aggregation::kSum);
+    REQUIRE(ToVector(sums.Last(2)) == std::vector<float>{15, 19});
+    REQUIRE(ToVector(sums.Stride(2)) == std::vector<float>{3, 11, 19});
+    REQUIRE_THROWS_AS(sums.Downsample(2, Aggregation::kSum), std::logic_error);
+  }
+
+  SECTION("Buckets without data are null") {
+    coviddata::RegionView missing =
+        view.Range(3, 4).Downsample(1, Aggregation::kMax);
+    REQUIRE(missing.At(0) == coviddata::kNullAmount);
+  }
+
+  SECTION("Statistics cover the entries of the view") {
+    coviddata::AmountStats stats =
+        view.Downsample(4, Aggregation::kSum).GetStats();
+    REQUIRE(stats.GetMax() == 26);
+    REQUIRE(stats.GetCount() == 3);
+  }
+}
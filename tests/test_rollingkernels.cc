@@ -0,0 +1,139 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "coviddata/amountstats.h"
+#include "coviddata/rollingkernels.h"
+#include "coviddata/span.h"
+
+namespace {
+
+// Computes every result of a kernel over amounts
+std::vector<float> Compute(coviddata::RollingKernel kernel, size_t window,
+                           const std::vector<float>& amounts) {
+  std::vector<float> results;
+  coviddata::ComputeRollingKernel(
+      kernel, window,
+      coviddata::Span<const float>(amounts.data(), amounts.size()), 0,
+      results);
+  return results;
+}
+
+}  // namespace
+
+TEST_CASE("Rolling kernels look back over a window of days") {
+  using coviddata::RollingKernel;
+
+  // Doubles every day, with the 4th day missing
+  const std::vector<float> amounts = {1, 2, 4, coviddata::kNullAmount, 16, 32};
+
+  SECTION("Moving averages skip missing days") {
+    const std::vector<float> averages =
+        Compute(RollingKernel::kMovingAverage, 3, amounts);
+    REQUIRE(averages.size() == amounts.size());
+    REQUIRE(averages[0] == Approx(1));
+    REQUIRE(averages[1] == Approx(1.5));
+    REQUIRE(averages[2] == Approx(7.0 / 3));
+    REQUIRE(averages[3] == Approx(3));
+    REQUIRE(averages[4] == Approx(10));
+    REQUIRE(averages[5] == Approx(24));
+  }
+
+  SECTION("Day-over-day growth is a percentage") {
+    const std::vector<float> growth =
+        Compute(RollingKernel::kGrowthRate, 1, amounts);
+    REQUIRE(coviddata::IsNullAmount(growth[0]));
+    REQUIRE(growth[1] == Approx(100));
+    REQUIRE(growth[2] == Approx(100));
+    REQUIRE(coviddata::IsNullAmount(growth[3]));
+    REQUIRE(coviddata::IsNullAmount(growth[4]));
+    REQUIRE(growth[5] == Approx(100));
+  }
+
+  SECTION("A drop of 1% is a defined result, not a null amount") {
+    const std::vector<float> growth =
+        Compute(RollingKernel::kGrowthRate, 1, {100, 99, 200, 198});
+    for (size_t day : {1, 3}) {
+      INFO("Day: " << day);
+      REQUIRE(std::isfinite(growth[day]));
+      REQUIRE_FALSE(coviddata::IsNullAmount(growth[day]));
+      REQUIRE(growth[day] == Approx(-1));
+    }
+
+    // A mean of exactly -1 is kept the same way
+    const std::vector<float> averages =
+        Compute(RollingKernel::kMovingAverage, 2, {-2, 0});
+    REQUIRE_FALSE(coviddata::IsNullAmount(averages[1]));
+    REQUIRE(averages[1] == Approx(-1));
+  }
+
+  SECTION("Growth over several days is averaged per day") {
+    const std::vector<float> growth =
+        Compute(RollingKernel::kGrowthRate, 2, amounts);
+    REQUIRE(coviddata::IsNullAmount(growth[1]));
+    REQUIRE(growth[2] == Approx(100));
+    REQUIRE(growth[4] == Approx(100));
+    REQUIRE(coviddata::IsNullAmount(growth[5]));
+  }
+
+  SECTION("Doubling time is only defined while amounts grow") {
+    const std::vector<float> doubling =
+        Compute(RollingKernel::kDoublingTime, 2, {1, 2, 4, 4, 2});
+    REQUIRE(coviddata::IsNullAmount(doubling[1]));
+    REQUIRE(doubling[2] == Approx(1));
+    REQUIRE(doubling[3] == Approx(2));
+    REQUIRE(coviddata::IsNullAmount(doubling[4]));
+  }
+
+  SECTION("Z-scores compare a day with its window") {
+    const std::vector<float> z_scores =
+        Compute(RollingKernel::kZScore, 3, {5, 5, 5, 2, 4, 6});
+    REQUIRE(coviddata::IsNullAmount(z_scores[0]));
+    // A window without any spread has no z-score
+    REQUIRE(coviddata::IsNullAmount(z_scores[2]));
+    REQUIRE(z_scores[3] == Approx(-2 / std::sqrt(3.0)));
+    REQUIRE(z_scores[5] == Approx(1));
+  }
+
+  SECTION("Windows must cover at least one day") {
+    REQUIRE_THROWS_AS(Compute(RollingKernel::kMovingAverage, 0, amounts),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("Rolling kernels only compute appended days") {
+  using coviddata::RollingKernel;
+
+  const std::vector<float> amounts = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+  const coviddata::Span<const float> all_days(amounts.data(), amounts.size());
+
+  for (RollingKernel kernel :
+       {RollingKernel::kMovingAverage, RollingKernel::kGrowthRate,
+        RollingKernel::kDoublingTime, RollingKernel::kZScore}) {
+    INFO("Kernel: " << static_cast<int>(kernel));
+    const std::vector<float> expected = Compute(kernel, 4, amounts);
+
+    std::vector<float> results;
+    coviddata::ComputeRollingKernel(
+        kernel, 4, coviddata::Span<const float>(amounts.data(), 6), 0,
+        results);
+    REQUIRE(results.size() == 6);
+
+    // Results of earlier days are kept rather than recomputed
+    results[0] = 42;
+    coviddata::ComputeRollingKernel(kernel, 4, all_days, 6, results);
+    REQUIRE(results[0] == 42);
+    for (size_t day = 1; day < amounts.size(); day++) {
+      INFO("Day: " << day);
+      if (coviddata::IsNullAmount(expected[day])) {
+        REQUIRE(coviddata::IsNullAmount(results[day]));
+      } else {
+        REQUIRE(results[day] == Approx(expected[day]));
+      }
+    }
+  }
+}
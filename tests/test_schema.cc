@@ -0,0 +1,154 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "coviddata/dataset.h"
+#include "coviddata/longformatimporter.h"
+#include "coviddata/schema.h"
+
+namespace {
+
+// Splits a row of text and adds it to a schema as a sample
+void AddSampleText(coviddata::Schema& schema, const std::string& text) {
+  coviddata::CsvParser parser(
+      coviddata::Span<const char>(text.data(), text.size()));
+  std::vector<coviddata::CsvParser::Field> fields;
+  parser.ReadRow(fields);
+  schema.AddSampleRow(coviddata::CsvParser::Row(fields.data(), fields.size()));
+}
+
+}  // namespace
+
+TEST_CASE("Schema describes metrics and columns") {
+  using coviddata::ColumnType;
+
+  SECTION("Metric names come from filenames") {
+    REQUIRE(coviddata::Schema::GetMetricName(
+                R"(C:\data\total_cases_per_million.csv.gz)") ==
+            "total_cases_per_million");
+    REQUIRE(coviddata::Schema::GetMetricName("data/new_deaths.csv") ==
+            "new_deaths");
+  }
+
+  SECTION("Quantity and per-capita scale come from the metric") {
+    coviddata::Schema schema("total_cases_per_million", "date", {"World"});
+    REQUIRE(schema.GetMetric() == "total cases per million");
+    REQUIRE(schema.GetQuantity() == "cases");
+    REQUIRE(schema.IsPerCapita());
+    REQUIRE(schema.GetPerCapitaScale() == Approx(1e6));
+    REQUIRE(schema.GetUnitLabel(1) == "cases per million");
+
+    coviddata::Schema absolute_schema("new_deaths", "date", {"World"});
+    REQUIRE_FALSE(absolute_schema.IsPerCapita());
+    REQUIRE(absolute_schema.GetPerCapitaScale() == Approx(1));
+    REQUIRE(absolute_schema.GetUnitLabel(1) == "deaths");
+  }
+
+  SECTION("Units are split off column names") {
+    coviddata::Schema schema(
+        "cumulative_total_per_thousand", "Date",
+        {"Argentina - tests performed", "Bahrain - units unclear"});
+    REQUIRE(schema.Size() == 3);
+    REQUIRE(schema.GetColumn(1).region == "Argentina");
+    REQUIRE(schema.GetColumn(1).unit == "tests performed");
+    REQUIRE(schema.GetQuantity() == "tests");
+    REQUIRE(schema.GetUnitLabel(1) == "tests performed per thousand");
+    REQUIRE(schema.GetUnitLabel(2) == "units unclear per thousand");
+    REQUIRE_THROWS_AS(schema.GetColumn(3), std::out_of_range);
+  }
+
+  SECTION("Sampled rows determine column types") {
+    coviddata::Schema schema("total_cases", "date",
+                             {"World", "Chile", "Peru", "Notes"});
+    AddSampleText(schema, "2020-01-01,1,,0.5,n/a");
+    AddSampleText(schema, "2020-01-02,-20,,3,");
+
+    REQUIRE(schema.GetColumn(0).type == ColumnType::kDate);
+    REQUIRE(schema.GetColumn(1).type == ColumnType::kInteger);
+    REQUIRE(schema.GetColumn(2).type == ColumnType::kUnknown);
+    REQUIRE(schema.GetColumn(3).type == ColumnType::kFractional);
+    REQUIRE(schema.GetColumn(4).type == ColumnType::kText);
+  }
+
+  SECTION("Sampled amounts determine column types") {
+    coviddata::Schema schema("total_cases", "date", {"World", "Chile"});
+    schema.AddSampleAmount(1, 12);
+    schema.AddSampleAmount(1, coviddata::kNullAmount);
+    schema.AddSampleAmount(2, 1.5f);
+
+    REQUIRE(schema.GetColumn(1).type == ColumnType::kInteger);
+    REQUIRE(schema.GetColumn(2).type == ColumnType::kFractional);
+    REQUIRE(schema.GetValueType() == ColumnType::kFractional);
+  }
+}
+
+TEST_CASE("DataSet infers its schema while importing") {
+  using coviddata::ColumnType;
+
+  const std::string total_cases_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\total_cases.csv)";
+
+  SECTION("Counts are integers") {
+    for (bool lazy_loading : {false, true}) {
+      coviddata::DataSet data_set;
+      data_set.SetLazyLoading(lazy_loading);
+      data_set.ImportData(total_cases_file);
+
+      const coviddata::Schema& schema = data_set.GetSchema();
+      REQUIRE(schema.GetMetric() == "total cases");
+      REQUIRE(schema.GetColumn(0).type == ColumnType::kDate);
+      REQUIRE(schema.GetValueType() == ColumnType::kInteger);
+      REQUIRE(schema.Size() == data_set.GetRegions().size() + 1);
+    }
+  }
+
+  SECTION("Per-capita exports are fractional") {
+    const std::string per_million_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\assets\data\total_cases_per_million.csv)";
+    coviddata::DataSet data_set;
+    data_set.SetImportThreadCount(2);
+    data_set.ImportData(per_million_file);
+
+    const coviddata::Schema& schema = data_set.GetSchema();
+    REQUIRE(schema.GetValueType() == ColumnType::kFractional);
+    const size_t world_column =
+        data_set.GetRegionDataByName("World").GetRegionIndex();
+    REQUIRE(schema.GetUnitLabel(world_column) == "cases per million");
+  }
+
+  SECTION("Snapshots infer their schema from amounts") {
+    coviddata::DataSet data_set;
+    data_set.ImportData(total_cases_file);
+    const std::string snapshot_file = "total_cases.cvsnap";
+    data_set.SaveSnapshot(snapshot_file);
+
+    coviddata::DataSet snapshot_data_set;
+    snapshot_data_set.LoadSnapshot(snapshot_file);
+    REQUIRE(snapshot_data_set.GetSchema().GetQuantity() == "cases");
+    REQUIRE(snapshot_data_set.GetSchema().GetValueType() ==
+            ColumnType::kInteger);
+
+    std::remove(snapshot_file.c_str());
+  }
+
+  SECTION("Long-format metrics get their own schema") {
+    const std::string long_file = R"(C:\Program Files\Cinder\my-projects\final-project-renzol2\tests\assets\data\owid_long.csv)";
+    coviddata::LongFormatImporter importer({"new_cases", "total_tests"});
+    importer.ImportData(long_file);
+
+    REQUIRE(importer.GetDataSet("new_cases")->GetSchema().GetQuantity() ==
+            "cases");
+    REQUIRE(importer.GetDataSet("total_tests")->GetSchema().GetUnitLabel(1) ==
+            "tests");
+  }
+
+  SECTION("Resetting clears the schema") {
+    coviddata::DataSet data_set;
+    data_set.ImportData(total_cases_file);
+    data_set.Reset();
+    REQUIRE(data_set.GetSchema().Size() == 0);
+  }
+}
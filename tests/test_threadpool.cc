@@ -0,0 +1,38 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "coviddata/threadpool.h"
+
+TEST_CASE("ThreadPool runs every submitted task") {
+  coviddata::ThreadPool pool(4);
+  REQUIRE(pool.Size() == 4);
+
+  SECTION("Futures become ready once their tasks have run") {
+    std::atomic<size_t> tasks_run(0);
+    std::vector<std::future<void>> tasks;
+
+    for (size_t i = 0; i < 100; i++)
+      tasks.push_back(pool.Submit([&tasks_run] { tasks_run++; }));
+    for (std::future<void>& task : tasks) task.get();
+
+    REQUIRE(tasks_run == 100);
+  }
+
+  SECTION("Exceptions thrown by tasks reach the caller") {
+    std::future<void> task =
+        pool.Submit([] { throw std::runtime_error("task failed"); });
+    REQUIRE_THROWS_AS(task.get(), std::runtime_error);
+  }
+}
+
+TEST_CASE("ThreadPool defaults to the hardware thread count") {
+  coviddata::ThreadPool pool(0);
+  REQUIRE(pool.Size() == coviddata::ThreadPool::DefaultThreadCount());
+  REQUIRE(pool.Size() > 0);
+}
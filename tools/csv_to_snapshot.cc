@@ -0,0 +1,61 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "coviddata/dataset.h"
+#include "coviddata/snapshot.h"
+
+/*
+ * Converts .csv datasets into binary snapshots that DataSet::LoadSnapshot()
+ * can map in without parsing. Each snapshot is written next to its .csv file
+ * with the .csv extension replaced by the snapshot extension.
+ *
+ * Usage: csv_to_snapshot <file.csv> [more files...]
+ */
+namespace {
+
+// Replaces the extension of a filename with the snapshot extension
+std::string GetSnapshotFilename(const std::string& csv_filename) {
+  const size_t extension = csv_filename.find_last_of('.');
+  const size_t directory = csv_filename.find_last_of("/\\");
+  if (extension == std::string::npos ||
+      (directory != std::string::npos && extension < directory))
+    return csv_filename + coviddata::kSnapshotExtension;
+
+  return csv_filename.substr(0, extension) + coviddata::kSnapshotExtension;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <file.csv> [more files...]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  int exit_code = EXIT_SUCCESS;
+  for (int arg = 1; arg < argc; arg++) {
+    const std::string csv_filename = argv[arg];
+    const std::string snapshot_filename = GetSnapshotFilename(csv_filename);
+
+    try {
+      coviddata::DataSet data_set;
+      data_set.SetImportThreadCount(0);
+      data_set.ImportData(csv_filename);
+      data_set.SaveSnapshot(snapshot_filename);
+
+      std::cout << csv_filename << " -> " << snapshot_filename << " ("
+                << data_set.Size() << " regions, "
+                << data_set.GetDateAxis().Size() << " dates)" << std::endl;
+    } catch (const std::exception& e) {
+      std::cerr << csv_filename << ": " << e.what() << std::endl;
+      exit_code = EXIT_FAILURE;
+    }
+  }
+
+  return exit_code;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../apps/batch_render.h"
+#include "../blocks/Cinder-Stk/src/stk/Stk.h"
+
+/*
+ * Renders every region of every given dataset to its own WAV file, using
+ * every core. Files are named <dataset>-<region>.wav. Throughput is reported
+ * as the real-time factor of the batch: seconds of audio rendered per second,
+ * across all threads, and per thread.
+ *
+ * Usage: render_batch <output directory> <file.csv> [more files...]
+ *            [--threads count] [--instrument name] [--effect name]
+ *            [--scale name] [--bpm bpm] [--min-pitch midi]
+ *            [--max-pitch midi] [--gain gain] [--sample-rate hz]
+ *            [--rawwaves directory]
+ *
+ * Without --rawwaves, STK's rawwaves are found among the assets next to the
+ * executable or above it, as the app finds them.
+ */
+namespace {
+
+void PrintUsage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " <output directory> <file.csv> [more files...]\n"
+            << "    [--threads count] [--instrument name] [--effect name]\n"
+            << "    [--scale name] [--bpm bpm] [--min-pitch midi]"
+               " [--max-pitch midi]\n"
+            << "    [--gain gain] [--sample-rate hz] [--rawwaves directory]"
+            << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const std::string output_directory = argv[1];
+  std::vector<std::string> dataset_filenames;
+  covidsonifapp::BatchRenderSettings settings;
+
+  for (int arg = 2; arg < argc; arg++) {
+    const std::string option = argv[arg];
+    if (option.compare(0, 2, "--") != 0) {
+      dataset_filenames.push_back(option);
+      continue;
+    }
+
+    if (arg + 1 >= argc) {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    const std::string value = argv[++arg];
+    if (covidsonifapp::ParseRenderOption(option, value, settings.render)) {
+      continue;
+    } else if (option == "--threads") {
+      settings.num_threads = std::strtoul(value.c_str(), nullptr, 10);
+    } else if (option == "--sample-rate") {
+      settings.sample_rate = std::strtod(value.c_str(), nullptr);
+    } else if (option == "--rawwaves") {
+      settings.rawwave_path = value;
+    } else {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (dataset_filenames.empty() || !(settings.sample_rate > 0)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (settings.rawwave_path.empty())
+    settings.rawwave_path = covidsonifapp::FindRawwavePath();
+  if (settings.rawwave_path.empty()) {
+    std::cerr << "No rawwaves directory in the assets; pass --rawwaves"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Notices of thousands of renders would bury the report; errors still show
+  stk::Stk::showWarnings(false);
+
+  const covidsonifapp::BatchRenderReport report = covidsonifapp::RenderBatch(
+      dataset_filenames, output_directory, settings);
+
+  for (const std::string& failure : report.failures)
+    std::cerr << failure << std::endl;
+
+  const double real_time_factor = report.GetRealTimeFactor();
+  std::cout << "Rendered " << report.num_rendered << " files ("
+            << report.audio_seconds << " s of audio) in "
+            << report.wall_seconds << " s on " << report.num_threads
+            << " threads\n"
+            << "Real-time factor: " << real_time_factor << "x ("
+            << real_time_factor / static_cast<double>(report.num_threads)
+            << "x per thread)" << std::endl;
+
+  return report.failures.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
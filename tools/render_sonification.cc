@@ -0,0 +1,143 @@
+// Copyright (c) 2020 CS126SP20. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../apps/offline_render.h"
+#include "../blocks/Cinder-Stk/src/stk/Stk.h"
+#include "coviddata/dataset.h"
+#include "coviddata/regionview.h"
+
+/*
+ * Renders the sonification of a region to a WAV file without an audio
+ * device, as fast as the CPU allows. The region is played as the app plays
+ * it with the same settings and the regional maximum as its upper bound.
+ *
+ * Each --with adds a region played at the same time on a voice of its own;
+ * every region is then bounded by the highest of their maximums.
+ *
+ * Usage: render_sonification <file.csv> <region> <output.wav>
+ *            [--with region]... [--instrument name] [--effect name]
+ *            [--scale name] [--bpm bpm] [--min-pitch midi] [--max-pitch midi]
+ *            [--gain gain] [--sample-rate hz] [--rawwaves directory]
+ *
+ * Without --rawwaves, STK's rawwaves are found among the assets next to the
+ * executable or above it, as the app finds them.
+ */
+namespace {
+
+const double kDefaultSampleRate = 44100;
+
+void PrintUsage(const char* program) {
+  std::cerr << "Usage: " << program << " <file.csv> <region> <output.wav>\n"
+            << "    [--with region]... [--instrument name] [--effect name]\n"
+            << "    [--scale name] [--bpm bpm] [--min-pitch midi]"
+               " [--max-pitch midi]\n"
+            << "    [--gain gain] [--sample-rate hz] [--rawwaves directory]"
+            << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 4) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const std::string csv_filename = argv[1];
+  const std::string wav_filename = argv[3];
+  std::vector<std::string> region_names = {argv[2]};
+
+  covidsonifapp::RenderSettings settings;
+  double sample_rate = kDefaultSampleRate;
+  std::string rawwave_path;
+
+  for (int arg = 4; arg + 1 < argc; arg += 2) {
+    const std::string option = argv[arg];
+    const std::string value = argv[arg + 1];
+    if (covidsonifapp::ParseRenderOption(option, value, settings)) {
+      continue;
+    } else if (option == "--with") {
+      region_names.push_back(value);
+    } else if (option == "--sample-rate") {
+      sample_rate = std::strtod(value.c_str(), nullptr);
+    } else if (option == "--rawwaves") {
+      rawwave_path = value;
+    } else {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if ((argc - 4) % 2 != 0 || !(sample_rate > 0)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (rawwave_path.empty()) rawwave_path = covidsonifapp::FindRawwavePath();
+  if (rawwave_path.empty()) {
+    std::cerr << "No rawwaves directory in the assets; pass --rawwaves"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Instruments read both when they are built
+  stk::Stk::setSampleRate(sample_rate);
+  stk::Stk::setRawwavePath(rawwave_path);
+
+  try {
+    coviddata::DataSet data_set;
+    data_set.ImportData(csv_filename);
+    const std::vector<std::string>& regions = data_set.GetRegions();
+
+    std::vector<coviddata::RegionView> views;
+    float max_amount = 0;
+    size_t num_dates = 0;
+    for (const std::string& region_name : region_names) {
+      if (std::find(regions.begin(), regions.end(), region_name) ==
+          regions.end()) {
+        std::cerr << csv_filename << ": no region named " << region_name
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      views.emplace_back(data_set.GetRegionDataByName(region_name));
+      max_amount = std::max(max_amount, views.back().GetStats().GetMax());
+      num_dates = std::max(num_dates, views.back().Size());
+    }
+
+    // A single region needs no voice management
+    auto start = std::chrono::steady_clock::now();
+    const size_t num_frames =
+        views.size() == 1
+            ? covidsonifapp::RenderSonification(views.front(), 0, max_amount,
+                                                settings, wav_filename)
+            : covidsonifapp::RenderPolyphonicSonification(
+                  views, 0, max_amount, settings, wav_filename);
+    auto finish = std::chrono::steady_clock::now();
+
+    const double render_seconds =
+        std::chrono::duration<double>(finish - start).count();
+    const double audio_seconds = static_cast<double>(num_frames) / sample_rate;
+    std::cout << region_names.front();
+    if (region_names.size() > 1)
+      std::cout << " and " << region_names.size() - 1 << " more";
+    std::cout << " -> " << wav_filename << " (" << num_dates
+              << " dates, " << audio_seconds << " s of audio in "
+              << render_seconds << " s, "
+              << audio_seconds / render_seconds << "x real time)" << std::endl;
+  } catch (stk::StkError& e) {
+    std::cerr << wav_filename << ": " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  } catch (const std::exception& e) {
+    std::cerr << csv_filename << ": " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}